@@ -0,0 +1,234 @@
+/*
+Author:			My Tran
+Filename:		AlphabetCipher.h
+Description:	This file provides the AlphabetCipher class template, the product cipher over an alphabet other than the 26
+lower case letters. The alphabet is a class giving the first byte value of its symbols and how many there are, such as
+PrintableAlphabet, the 95 printable characters of ASCII from space to tilde, or ByteAlphabet, all 256 byte values. Text
+is encrypted as it is, with no normalizing pass that would lose any of it: punctuation, digits and spaces for
+PrintableAlphabet, which has no new line or other control character, and new lines or any binary data for ByteAlphabet.
+The affine step is C = (aP + b) mod m, with m the size of the alphabet, and keyNum may be any number from 1 to m - 1
+sharing no factor with m: any odd number for ByteAlphabet, and any number not divisible by 5 or 19 for
+PrintableAlphabet. The key phrase is made of symbols of the alphabet. Only the alphabet is fixed when the program is
+compiled: AlphabetSubstitution is handed its first symbol and size when a cipher is built, works out the reciprocal of
+the size, the tables and the key stream then, and its vectorized kernels take the modulus as a value. The transposition
+and the tiled loops are the same as CipherEngine's, which moves bytes whatever they stand for.
+
+	typedef AlphabetCipher<PrintableAlphabet> PrintableCipher;
+	PrintableCipher cipher(key);
+	cipher.encrypt("Hello, World!", output);
+
+LowerCaseAlphabet gives the same ciphertext as CipherEngine for the same key.
+*/
+#pragma once
+#include<cstddef>
+#include<string_view>
+#include "AlphabetSubstitution.h"
+#include "CipherKey.h"
+#include "CipherEngine.h"
+#include "KeySchedule.h"
+#include "Transposition.h"
+
+//the 26 lower case letters of CipherEngine
+struct LowerCaseAlphabet
+{
+	static constexpr unsigned char FIRST = 'a';	//byte value of the symbol standing for 0
+	static constexpr int SIZE = 26;	//number of symbols
+};
+
+//the 95 printable characters of ASCII, from space to tilde
+struct PrintableAlphabet
+{
+	static constexpr unsigned char FIRST = ' ';	//byte value of the symbol standing for 0
+	static constexpr int SIZE = 95;	//number of symbols
+};
+
+//every byte value
+struct ByteAlphabet
+{
+	static constexpr unsigned char FIRST = 0;	//byte value of the symbol standing for 0
+	static constexpr int SIZE = 256;	//number of symbols
+};
+
+template<typename Alphabet>
+class AlphabetCipher
+{
+	public:
+		static constexpr unsigned char FIRST = Alphabet::FIRST;	//byte value of the symbol standing for 0
+		static constexpr int SIZE = Alphabet::SIZE;	//number of symbols, the modulus of the affine step
+
+		static_assert(SIZE >= 2 && FIRST + SIZE <= 256, "an alphabet holds 2 to 256 consecutive byte values");
+
+		/*
+		Purpose:		Validates a key and builds its substitution for the alphabet.
+		Pre-condition:	Takes the key, with a key phrase of symbols of the alphabet.
+		Post-condition:	getStatus() reports whether the key can be used.
+		*/
+		AlphabetCipher(const CipherKey& key)
+			: key(key), status(validate(key)), substitution(FIRST, SIZE, key.keyNum, key.keyPhrase)
+		{
+		}
+
+		AlphabetCipher(const AlphabetCipher&) = delete;
+		AlphabetCipher& operator=(const AlphabetCipher&) = delete;
+
+		/*
+		Purpose:		Gives the outcome of validating the key.
+		Pre-condition:	None
+		Post-condition:	Returns OK, INVALID_KEY_NUM if keyNum shares a factor with the size of the alphabet or is out of
+						range, INVALID_KEY_PHRASE if the key phrase is empty or holds a character outside the alphabet,
+						or INVALID_PERMUTATION.
+		*/
+		CipherStatus getStatus() const
+		{
+			return status;
+		}
+
+		/*
+		Purpose:		Apply the affine/vigenere substitution and the row transposition to text of the alphabet.
+		Pre-condition:	Takes the plaintext, a buffer of at least plaintext.length() characters that does not overlap
+						it, and the row width of the matrix, or 0 for the least square.
+		Post-condition:	Returns OK and the ciphertext is stored in output. Otherwise returns EMPTY_INPUT, the status of
+						the key, INVALID_PERMUTATION if it does not order the full rows of the matrix, or INVALID_CHARACTER
+						if the plaintext has a character outside the alphabet, and output is left unspecified.
+		*/
+		CipherStatus encrypt(std::string_view plaintext, char* output, size_t rowWidth = 0) const
+		{
+			CipherStatus status = validateText(plaintext, rowWidth);
+			if (status != CipherStatus::OK)
+			{
+				return status;
+			}
+
+			Transposition transposition(plaintext.length(), key.permutation, rowWidth);
+			CipherEngine::encryptBlock(plaintext.data(), 0, substitution, transposition, output);
+
+			return CipherStatus::OK;
+		}
+
+		/*
+		Purpose:		Reverse the row transposition and the affine/vigenere substitution on text of the alphabet.
+		Pre-condition:	Takes the ciphertext, a buffer of at least ciphertext.length() characters that does not overlap
+						it, and the row width the ciphertext was encrypted with, or 0 for the least square.
+		Post-condition:	Returns OK and the plaintext is stored in output. Otherwise returns the same as encrypt.
+		*/
+		CipherStatus decrypt(std::string_view ciphertext, char* output, size_t rowWidth = 0) const
+		{
+			CipherStatus status = validateText(ciphertext, rowWidth);
+			if (status != CipherStatus::OK)
+			{
+				return status;
+			}
+
+			Transposition transposition(ciphertext.length(), key.permutation, rowWidth);
+			CipherEngine::decryptBlock(ciphertext.data(), 0, substitution, transposition, output);
+
+			return CipherStatus::OK;
+		}
+
+		const CipherKey& getKey() const	//returns the key the cipher was built from
+		{
+			return key;
+		}
+
+		/*
+		Purpose:		Determines if a number can be used as keyNum for the alphabet.
+		Pre-condition:	Takes the number.
+		Post-condition:	Returns true if it is from 1 to SIZE - 1 and shares no factor with SIZE.
+		*/
+		static constexpr bool isValidKeyNum(int keyNum)
+		{
+			int a = keyNum;
+			int b = SIZE;
+
+			//Euclid's algorithm, since a keyNum has an inverse mod SIZE exactly when their greatest common divisor is 1
+			while (b != 0)
+			{
+				int rest = a % b;
+				a = b;
+				b = rest;
+			}
+
+			return keyNum > 0 && keyNum < SIZE && a == 1;
+		}
+
+		/*
+		Purpose:		Calculates the modular multiplicative inverse of keyNum for the alphabet.
+		Pre-condition:	Takes the number.
+		Post-condition:	Returns inverse, or 0 if the number is not a valid key number.
+		*/
+		static constexpr int calcModInverse(int keyNum)
+		{
+			for (int inverse = 1; inverse < SIZE && isValidKeyNum(keyNum); inverse++)
+			{
+				if ((keyNum * inverse) % SIZE == 1)
+				{
+					return inverse;
+				}
+			}
+
+			return 0;
+		}
+
+		/*
+		Purpose:		Determines if every character of text is a symbol of the alphabet.
+		Pre-condition:	Takes the text.
+		Post-condition:	Returns true if it is.
+		*/
+		static bool isInAlphabet(std::string_view text)
+		{
+			return AlphabetSubstitution::isInAlphabet(text, FIRST, SIZE);
+		}
+	private:
+		//private data members
+		CipherKey key;	//key the cipher was built from
+		CipherStatus status;	//outcome of validating the key
+		AlphabetSubstitution substitution;	//tables and key stream of the key over the alphabet
+
+		/*
+		Purpose:		Checks everything about a key but the message length.
+		Pre-condition:	Takes the key.
+		Post-condition:	Returns OK if it is usable, otherwise the status describing the first problem found.
+		*/
+		static CipherStatus validate(const CipherKey& key)
+		{
+			if (!isValidKeyNum(key.keyNum))
+			{
+				return CipherStatus::INVALID_KEY_NUM;
+			}
+
+			if (key.keyPhrase.empty() || !isInAlphabet(key.keyPhrase))
+			{
+				return CipherStatus::INVALID_KEY_PHRASE;
+			}
+
+			return KeySchedule::isPermutation(key.permutation) ? CipherStatus::OK : CipherStatus::INVALID_PERMUTATION;
+		}
+
+		/*
+		Purpose:		Checks text and the key before they are used together.
+		Pre-condition:	Takes the text and the row width.
+		Post-condition:	Returns OK if they can be used together, otherwise the status describing the first problem found.
+		*/
+		CipherStatus validateText(std::string_view text, size_t rowWidth) const
+		{
+			if (text.empty())
+			{
+				return CipherStatus::EMPTY_INPUT;
+			}
+
+			if (status != CipherStatus::OK)
+			{
+				return status;
+			}
+
+			if (!KeySchedule::fitsLength(key.permutation, text.length(), rowWidth))
+			{
+				return CipherStatus::INVALID_PERMUTATION;
+			}
+
+			return isInAlphabet(text) ? CipherStatus::OK : CipherStatus::INVALID_CHARACTER;
+		}
+};
+
+typedef AlphabetCipher<PrintableAlphabet> PrintableCipher;	//cipher over the printable characters of ASCII
+typedef AlphabetCipher<ByteAlphabet> ByteCipher;	//cipher over every byte value
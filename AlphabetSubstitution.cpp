@@ -0,0 +1,378 @@
+/*
+Author:			My Tran
+Filename:		AlphabetSubstitution.cpp
+Description:	This file implements the header file AlphabetSubstitution.h providing the definitions for the methods of
+the AlphabetSubstitution class along with the scalar, SSE2 and AVX2 kernels it dispatches to.
+*/
+#include "AlphabetSubstitution.h"
+#include "Instrumentation.h"
+#include "Substitution.h"
+#include<cstdint>
+#include<cstring>
+#include<numeric>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ALPHABET_SIMD
+#include<immintrin.h>
+#endif
+
+//functions using avx2 instructions are compiled for avx2 on their own so the rest of the program runs anywhere
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+const int MAX_ALPHABET_SIZE = 256;	//most symbols an alphabet of byte values can have
+const int RECIPROCAL_SCALE = 65536;	//the reciprocal of the modulus is scaled by this so a 16 bit high multiply divides by it
+const uint64_t EVERY_BYTE = 0x0101010101010101;	//multiplying a byte by this repeats it in every byte of a word
+
+/*
+Purpose:		Substitutes one character at a time by looking it up in the table for its key symbol.
+Pre-condition:	Takes text of the alphabet, key numbers, count, table for the direction and output.
+Post-condition:	output contains the substituted characters.
+*/
+static void substituteScalar(const char* text, const unsigned char* key, size_t count, const AlphabetTable& table, char* output)
+{
+	const unsigned char* symbols = table.symbols.data();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned char symbol = (unsigned char)((unsigned char)text[i] - table.first);
+		output[i] = (char)(symbols[(key[i] * table.size) + symbol] + table.first);
+	}
+}
+
+#ifdef ALPHABET_SIMD
+/*
+Purpose:		Reduces eight 16 bit values mod the size of the alphabet without dividing or branching.
+Pre-condition:	Takes values less than 65536, the size, the size less one and 65536 / size, each in every lane.
+Post-condition:	Returns x - size * floor(x / size) for each value.
+*/
+static inline __m128i modSse2(__m128i x, __m128i size, __m128i largest, __m128i reciprocal)
+{
+	//the quotient is at most one short, which leaves a remainder below twice the size to take the size off once
+	__m128i quotient = _mm_mulhi_epu16(x, reciprocal);
+	__m128i remainder = _mm_sub_epi16(x, _mm_mullo_epi16(quotient, size));
+	return _mm_sub_epi16(remainder, _mm_and_si128(size, _mm_cmpgt_epi16(remainder, largest)));
+}
+
+/*
+Purpose:		Applies C = (aP + b) mod m sixteen characters at a time.
+Pre-condition:	Takes text, key numbers, count, table holding keyNum and output.
+Post-condition:	output contains the substituted characters.
+*/
+static void applySse2(const char* text, const unsigned char* key, size_t count, const AlphabetTable& table, char* output)
+{
+	const __m128i first = _mm_set1_epi8((char)table.first);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i multiplier = _mm_set1_epi16((short)table.multiplier);
+	const __m128i size = _mm_set1_epi16((short)table.size);
+	const __m128i largest = _mm_set1_epi16((short)(table.size - 1));
+	const __m128i reciprocal = _mm_set1_epi16((short)table.reciprocal);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i plain = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(text + i)), first);
+		__m128i shift = _mm_loadu_si128((const __m128i*)(key + i));
+
+		//a*P + b is at most m(m - 1), which fits 16 bits for every alphabet of up to 256 symbols
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(plain, zero), multiplier), _mm_unpacklo_epi8(shift, zero));
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(plain, zero), multiplier), _mm_unpackhi_epi8(shift, zero));
+
+		__m128i cipher = _mm_packus_epi16(modSse2(low, size, largest, reciprocal), modSse2(high, size, largest, reciprocal));
+		_mm_storeu_si128((__m128i*)(output + i), _mm_add_epi8(cipher, first));
+	}
+
+	substituteScalar(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Applies P = (a^-1)(C - b) mod m sixteen characters at a time.
+Pre-condition:	Takes text, key numbers, count, table holding the inverse of keyNum and output.
+Post-condition:	output contains the original characters.
+*/
+static void invertSse2(const char* text, const unsigned char* key, size_t count, const AlphabetTable& table, char* output)
+{
+	const __m128i first = _mm_set1_epi8((char)table.first);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i multiplier = _mm_set1_epi16((short)table.multiplier);
+	const __m128i size = _mm_set1_epi16((short)table.size);
+	const __m128i largest = _mm_set1_epi16((short)(table.size - 1));
+	const __m128i reciprocal = _mm_set1_epi16((short)table.reciprocal);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i cipher = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(text + i)), first);
+		__m128i shift = _mm_loadu_si128((const __m128i*)(key + i));
+
+		//C - b + m is between 1 and 2m - 1 and is brought below m before multiplying, so the product fits 16 bits
+		__m128i low = _mm_sub_epi16(_mm_add_epi16(_mm_unpacklo_epi8(cipher, zero), size), _mm_unpacklo_epi8(shift, zero));
+		__m128i high = _mm_sub_epi16(_mm_add_epi16(_mm_unpackhi_epi8(cipher, zero), size), _mm_unpackhi_epi8(shift, zero));
+		low = _mm_sub_epi16(low, _mm_and_si128(size, _mm_cmpgt_epi16(low, largest)));
+		high = _mm_sub_epi16(high, _mm_and_si128(size, _mm_cmpgt_epi16(high, largest)));
+
+		low = modSse2(_mm_mullo_epi16(low, multiplier), size, largest, reciprocal);
+		high = modSse2(_mm_mullo_epi16(high, multiplier), size, largest, reciprocal);
+
+		_mm_storeu_si128((__m128i*)(output + i), _mm_add_epi8(_mm_packus_epi16(low, high), first));
+	}
+
+	substituteScalar(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Reduces sixteen 16 bit values mod the size of the alphabet without dividing or branching.
+Pre-condition:	Takes values less than 65536, the size, the size less one and 65536 / size, each in every lane.
+Post-condition:	Returns x - size * floor(x / size) for each value.
+*/
+TARGET_AVX2 static inline __m256i modAvx2(__m256i x, __m256i size, __m256i largest, __m256i reciprocal)
+{
+	__m256i quotient = _mm256_mulhi_epu16(x, reciprocal);
+	__m256i remainder = _mm256_sub_epi16(x, _mm256_mullo_epi16(quotient, size));
+	return _mm256_sub_epi16(remainder, _mm256_and_si256(size, _mm256_cmpgt_epi16(remainder, largest)));
+}
+
+/*
+Purpose:		Applies C = (aP + b) mod m thirty two characters at a time.
+Pre-condition:	Takes text, key numbers, count, table holding keyNum and output.
+Post-condition:	output contains the substituted characters.
+*/
+TARGET_AVX2 static void applyAvx2(const char* text, const unsigned char* key, size_t count, const AlphabetTable& table, char* output)
+{
+	const __m256i first = _mm256_set1_epi8((char)table.first);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i multiplier = _mm256_set1_epi16((short)table.multiplier);
+	const __m256i size = _mm256_set1_epi16((short)table.size);
+	const __m256i largest = _mm256_set1_epi16((short)(table.size - 1));
+	const __m256i reciprocal = _mm256_set1_epi16((short)table.reciprocal);
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i plain = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(text + i)), first);
+		__m256i shift = _mm256_loadu_si256((const __m256i*)(key + i));
+
+		//unpacking and packing both work within 128 bit lanes, so the characters come back out in order
+		__m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(plain, zero), multiplier), _mm256_unpacklo_epi8(shift, zero));
+		__m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(plain, zero), multiplier), _mm256_unpackhi_epi8(shift, zero));
+
+		__m256i cipher = _mm256_packus_epi16(modAvx2(low, size, largest, reciprocal), modAvx2(high, size, largest, reciprocal));
+		_mm256_storeu_si256((__m256i*)(output + i), _mm256_add_epi8(cipher, first));
+	}
+
+	//the tail runs sse2 code, which is slowed down while the upper halves of the ymm registers are dirty
+	_mm256_zeroupper();
+	applySse2(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Applies P = (a^-1)(C - b) mod m thirty two characters at a time.
+Pre-condition:	Takes text, key numbers, count, table holding the inverse of keyNum and output.
+Post-condition:	output contains the original characters.
+*/
+TARGET_AVX2 static void invertAvx2(const char* text, const unsigned char* key, size_t count, const AlphabetTable& table, char* output)
+{
+	const __m256i first = _mm256_set1_epi8((char)table.first);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i multiplier = _mm256_set1_epi16((short)table.multiplier);
+	const __m256i size = _mm256_set1_epi16((short)table.size);
+	const __m256i largest = _mm256_set1_epi16((short)(table.size - 1));
+	const __m256i reciprocal = _mm256_set1_epi16((short)table.reciprocal);
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i cipher = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(text + i)), first);
+		__m256i shift = _mm256_loadu_si256((const __m256i*)(key + i));
+
+		__m256i low = _mm256_sub_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(cipher, zero), size), _mm256_unpacklo_epi8(shift, zero));
+		__m256i high = _mm256_sub_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(cipher, zero), size), _mm256_unpackhi_epi8(shift, zero));
+		low = _mm256_sub_epi16(low, _mm256_and_si256(size, _mm256_cmpgt_epi16(low, largest)));
+		high = _mm256_sub_epi16(high, _mm256_and_si256(size, _mm256_cmpgt_epi16(high, largest)));
+
+		low = modAvx2(_mm256_mullo_epi16(low, multiplier), size, largest, reciprocal);
+		high = modAvx2(_mm256_mullo_epi16(high, multiplier), size, largest, reciprocal);
+
+		_mm256_storeu_si256((__m256i*)(output + i), _mm256_add_epi8(_mm256_packus_epi16(low, high), first));
+	}
+
+	//the tail runs sse2 code, which is slowed down while the upper halves of the ymm registers are dirty
+	_mm256_zeroupper();
+	invertSse2(text + i, key + i, count - i, table, output + i);
+}
+#endif
+
+/*
+Purpose:		Builds the table of C = (aP + b) mod m, stepping each row by a instead of dividing.
+Pre-condition:	Takes the table, with its size set, and keyNum, or 0 for a table that is never used.
+Post-condition:	The table is filled.
+*/
+static void fillApplyTable(AlphabetTable& table, int keyNum)
+{
+	table.multiplier = keyNum;
+	table.symbols.resize((size_t)table.size * table.size);
+
+	for (int b = 0; b < table.size; b++)
+	{
+		for (int x = 0, value = b; x < table.size; x++)
+		{
+			table.symbols[(b * table.size) + x] = (unsigned char)value;
+
+			//keyNum is less than the size, so one subtraction keeps the value in range
+			value += keyNum;
+			value -= (value >= table.size) ? table.size : 0;
+		}
+	}
+}
+
+/*
+Purpose:		Builds the table of P = (a^-1)(C - b) mod m by reversing each row of the apply table.
+Pre-condition:	Takes the table, with its size set, the inverse of keyNum and the apply table, which must map each row
+				one to one unless the inverse is 0.
+Post-condition:	The table is filled.
+*/
+static void fillInvertTable(AlphabetTable& table, int keyNumInverse, const AlphabetTable& applyTable)
+{
+	table.multiplier = keyNumInverse;
+	table.symbols.assign((size_t)table.size * table.size, 0);
+
+	for (int b = 0; b < table.size && keyNumInverse != 0; b++)
+	{
+		for (int x = 0; x < table.size; x++)
+		{
+			table.symbols[(b * table.size) + applyTable.symbols[(b * table.size) + x]] = (unsigned char)x;
+		}
+	}
+}
+
+AlphabetSubstitution::AlphabetSubstitution(unsigned char first, int size, int keyNum, std::string_view keyPhrase)
+{
+	INSTRUMENT_STAGE(CipherStage::KEY_SCHEDULE, keyPhrase.length());
+
+	size = (size >= 2 && size <= MAX_ALPHABET_SIZE - first) ? size : MAX_ALPHABET_SIZE - first;
+
+	//an invalid keyNum is never used to substitute, but still has to give tables that can be built safely
+	bool valid = keyNum > 0 && keyNum < size && std::gcd(keyNum, size) == 1;
+	keyNum = valid ? keyNum : 0;
+
+	int keyNumInverse = 0;
+	for (int candidate = 1; candidate < size && valid && keyNumInverse == 0; candidate++)
+	{
+		keyNumInverse = ((keyNum * candidate) % size == 1) ? candidate : 0;
+	}
+
+	for (AlphabetTable* table : { &applyTable, &invertTable })
+	{
+		table->size = size;
+		table->reciprocal = RECIPROCAL_SCALE / size;
+		table->first = first;
+	}
+
+	fillApplyTable(applyTable, keyNum);
+	fillInvertTable(invertTable, keyNumInverse, applyTable);
+
+	//each symbol of the phrase becomes its number, and a symbol outside the alphabet is never used
+	period = keyPhrase.length();
+	stream.resize(period);
+	for (size_t i = 0; i < period; i++)
+	{
+		unsigned char number = (unsigned char)((unsigned char)keyPhrase[i] - first);
+		stream[i] = (number < size) ? number : 0;
+	}
+
+	//a short phrase is repeated so runs read long stretches of the stream without wrapping around
+	if (period > 0 && period <= MAX_EXPANDED_PHRASE)
+	{
+		stream.resize(KEY_STREAM_SIZE);
+		for (size_t filled = period; filled < KEY_STREAM_SIZE; filled *= 2)
+		{
+			std::memcpy(stream.data() + filled, stream.data(), (filled < KEY_STREAM_SIZE - filled) ? filled : KEY_STREAM_SIZE - filled);
+		}
+	}
+}
+
+void AlphabetSubstitution::apply(const char* text, size_t position, size_t count, char* output) const
+{
+	run(getApplyKernel(), applyTable, text, position, count, output);
+}
+
+void AlphabetSubstitution::invert(const char* text, size_t position, size_t count, char* output) const
+{
+	run(getInvertKernel(), invertTable, text, position, count, output);
+}
+
+void AlphabetSubstitution::run(Kernel kernel, const AlphabetTable& table, const char* text, size_t position, size_t count, char* output) const
+{
+	size_t phase = position % period;	//symbol of the key phrase the first character is paired with
+
+	while (count > 0)
+	{
+		size_t length = (count < stream.size() - phase) ? count : stream.size() - phase;
+
+		kernel(text, stream.data() + phase, length, table, output);
+
+		text += length;
+		output += length;
+		count -= length;
+		phase = (phase + length) % period;
+	}
+}
+
+bool AlphabetSubstitution::isInAlphabet(std::string_view text, unsigned char first, int size)
+{
+	int last = first + size - 1;
+	size_t i = 0;
+
+	if (first == 0 && last >= MAX_ALPHABET_SIZE - 1)
+	{
+		return true;
+	}
+
+	//an alphabet below 128 is checked eight characters at once, the same way CipherEngine::isLowerCase checks letters
+	for (; last < 128 && i + sizeof(uint64_t) <= text.length(); i += sizeof(uint64_t))
+	{
+		uint64_t symbols;
+		std::memcpy(&symbols, text.data() + i, sizeof(symbols));
+
+		uint64_t below = (symbols - (EVERY_BYTE * first)) & ~symbols;
+		uint64_t above = (symbols + (EVERY_BYTE * (uint64_t)(127 - last))) | symbols;
+
+		if (((below | above) & (EVERY_BYTE * 0x80)) != 0)
+		{
+			return false;
+		}
+	}
+
+	for (; i < text.length(); i++)
+	{
+		if ((unsigned char)text[i] < first || (unsigned char)text[i] > last)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+AlphabetSubstitution::Kernel AlphabetSubstitution::getApplyKernel()
+{
+#ifdef ALPHABET_SIMD
+	static const Kernel kernel = (std::strcmp(Substitution::getKernelName(), "avx2") == 0) ? applyAvx2 : applySse2;
+#else
+	static const Kernel kernel = substituteScalar;
+#endif
+	return kernel;
+}
+
+AlphabetSubstitution::Kernel AlphabetSubstitution::getInvertKernel()
+{
+#ifdef ALPHABET_SIMD
+	static const Kernel kernel = (std::strcmp(Substitution::getKernelName(), "avx2") == 0) ? invertAvx2 : invertSse2;
+#else
+	static const Kernel kernel = substituteScalar;
+#endif
+	return kernel;
+}
@@ -0,0 +1,91 @@
+/*
+Author:			My Tran
+Filename:		AlphabetSubstitution.h
+Description:	This file provides the declarations of the AlphabetSubstitution class. AlphabetSubstitution applies and
+inverts C = (aP + b) mod m over an alphabet of m consecutive byte values, such as the 95 printable characters of ASCII or
+all 256 bytes, where Substitution only knows the 26 lower case letters. Each symbol stands for its distance from the
+first symbol of the alphabet, so text of the alphabet is substituted as it is, with nothing taken out or changed first.
+
+The key phrase is turned into those numbers once and repeated into a key stream the same way Substitution expands it.
+Runs are handed to an SSE2 or AVX2 kernel picked the same way as Substitution's. The kernels widen each symbol to 16
+bits, where a*P + b is less than 65536 for every alphabet of up to 256 symbols, and reduce it mod m by multiplying by
+65536 / m, which may leave the result m too large, so m is taken off once where it is. The scalar kernel and the ends of
+runs look each symbol up in an m x m table built once for the key.
+*/
+#pragma once
+#include<cstddef>
+#include<string_view>
+#include<vector>
+
+//everything a kernel needs to substitute over an alphabet in one direction
+struct AlphabetTable
+{
+	int multiplier;	//keyNum when substituting, inverse of keyNum when inverting
+	int size;	//number of symbols in the alphabet, the modulus
+	int reciprocal;	//65536 / size, which the kernels reduce mod size with
+	unsigned char first;	//byte value of the symbol standing for 0
+	std::vector<unsigned char> symbols;	//symbols[b * size + x] is the number of the result for key symbol b and text symbol x
+};
+
+class AlphabetSubstitution
+{
+	public:
+		/*
+		Purpose:		Creates the substitution of a key over an alphabet.
+		Pre-condition:	Takes the first byte value of the alphabet and its number of symbols, 2 to 256, ending at or
+						before byte value 255, and keyNum and key phrase, which must be valid for the alphabet before apply
+						or invert are used. The key phrase is copied.
+		Post-condition:	None
+		*/
+		AlphabetSubstitution(unsigned char, int, int, std::string_view);
+
+		/*
+		Purpose:		Applies C = (aP + b) mod m to a run of text of the alphabet.
+		Pre-condition:	Takes the text, the position of its first character in the message, the number of characters
+						and the output buffer. The output may be the text itself.
+		Post-condition:	output contains the substituted characters.
+		*/
+		void apply(const char*, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Applies P = (a^-1)(C - b) mod m to a run of text of the alphabet.
+		Pre-condition:	Takes the text, the position of its first character in the message, the number of characters
+						and the output buffer. The output may be the text itself.
+		Post-condition:	output contains the original characters.
+		*/
+		void invert(const char*, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Determines if every character of text is in an alphabet.
+		Pre-condition:	Takes the text and the first byte value and number of symbols of the alphabet.
+		Post-condition:	Returns true if every character is one of the symbols.
+		*/
+		static bool isInAlphabet(std::string_view, unsigned char, int);
+
+		static constexpr size_t MAX_EXPANDED_PHRASE = 1024;	//longest key phrase that is repeated into the key stream
+		static constexpr size_t KEY_STREAM_SIZE = 2 * MAX_EXPANDED_PHRASE;	//shortest key stream of a repeated phrase
+	private:
+		//signature shared by the scalar and vectorized kernels: text, key numbers, count, table, output
+		typedef void (*Kernel)(const char*, const unsigned char*, size_t, const AlphabetTable&, char*);
+
+		//private data members
+		AlphabetTable applyTable;	//C = (aP + b) mod m for every key symbol b and plaintext symbol P
+		AlphabetTable invertTable;	//P = (a^-1)(C - b) mod m for every key symbol b and ciphertext symbol C
+		size_t period;	//number of symbols in the key phrase
+		std::vector<unsigned char> stream;	//numbers of the key phrase's symbols, repeated back to back if it is short
+
+		/*
+		Purpose:		Runs a kernel over a run of text, splitting it where the key stream wraps around.
+		Pre-condition:	Takes the kernel, its table, the text, its position in the message, the count and the output.
+		Post-condition:	output contains the result of the kernel.
+		*/
+		void run(Kernel, const AlphabetTable&, const char*, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Picks the kernels of the same width Substitution picked for this processor.
+		Pre-condition:	None
+		Post-condition:	Returns the kernel for the direction asked for.
+		*/
+		static Kernel getApplyKernel();
+		static Kernel getInvertKernel();
+};
@@ -0,0 +1,44 @@
+/*
+Author:			My Tran
+Filename:		ByteOrder.h
+Description:	This file provides the ByteOrder class, which stores and loads the numbers of the archive format and of the
+service's requests and replies little endian, whatever the byte order of the machine, so files and messages written on
+one machine are read the same way on any other. The functions are defined here so the compiler can turn each one into a
+single load or store where the machine allows it.
+*/
+#pragma once
+#include<cstddef>
+#include<cstdint>
+
+class ByteOrder
+{
+	public:
+		/*
+		Purpose:		Stores a number little endian.
+		Pre-condition:	Takes the buffer, the number and how many bytes to store it in, at most 8.
+		Post-condition:	The lowest bytes of the number are stored in the buffer, lowest first.
+		*/
+		static void storeNumber(char* buffer, uint64_t number, size_t bytes)
+		{
+			for (size_t i = 0; i < bytes; i++)
+			{
+				buffer[i] = (char)(number >> (8 * i));
+			}
+		}
+
+		/*
+		Purpose:		Loads a number stored by storeNumber.
+		Pre-condition:	Takes the buffer and how many bytes the number takes, at most 8.
+		Post-condition:	Returns the number.
+		*/
+		static uint64_t loadNumber(const char* buffer, size_t bytes)
+		{
+			uint64_t number = 0;
+			for (size_t i = 0; i < bytes; i++)
+			{
+				number |= (uint64_t)(unsigned char)buffer[i] << (8 * i);
+			}
+
+			return number;
+		}
+};
@@ -0,0 +1,84 @@
+/*
+Author:			My Tran
+Filename:		CipherContext.cpp
+Description:	This file implements the header file CipherContext.h providing the definitions for the methods of the
+CipherContext class.
+*/
+#include "CipherContext.h"
+
+CipherContext::CipherContext(size_t length)
+	: arena(2 * ScratchArena::getFootprint(length))
+{
+	invalidOffset = Normalizer::NO_INVALID;
+}
+
+CipherStatus CipherContext::encrypt(std::string_view plaintext, const KeySchedule& schedule, std::string_view& ciphertext,
+	size_t rowWidth)
+{
+	return run(plaintext, schedule, ciphertext, true, false, rowWidth);
+}
+
+CipherStatus CipherContext::decrypt(std::string_view ciphertext, const KeySchedule& schedule, std::string_view& plaintext,
+	size_t rowWidth)
+{
+	return run(ciphertext, schedule, plaintext, false, false, rowWidth);
+}
+
+CipherStatus CipherContext::encryptText(std::string_view text, const KeySchedule& schedule, std::string_view& ciphertext)
+{
+	return run(text, schedule, ciphertext, true, true, 0);
+}
+
+CipherStatus CipherContext::decryptText(std::string_view text, const KeySchedule& schedule, std::string_view& plaintext)
+{
+	return run(text, schedule, plaintext, false, true, 0);
+}
+
+size_t CipherContext::getInvalidOffset() const
+{
+	return invalidOffset;
+}
+
+size_t CipherContext::getCapacity() const
+{
+	return arena.getCapacity();
+}
+
+size_t CipherContext::getHeapAllocations() const
+{
+	return arena.getHeapAllocations();
+}
+
+CipherStatus CipherContext::run(std::string_view text, const KeySchedule& schedule, std::string_view& result,
+	bool encrypting, bool normalizing, size_t rowWidth)
+{
+	result = std::string_view();
+	invalidOffset = Normalizer::NO_INVALID;
+
+	//the letters of normalized text are never more than the bytes it came from, so both buffers fit text.length()
+	arena.reset((normalizing ? 2 : 1) * ScratchArena::getFootprint(text.length()));
+
+	if (normalizing)
+	{
+		char* letters = arena.allocate(text.length());
+		size_t count = Normalizer::normalize(text.data(), text.length(), letters, Normalizer::Whitespace::ALL, invalidOffset);
+
+		if (invalidOffset != Normalizer::NO_INVALID)
+		{
+			return CipherStatus::INVALID_CHARACTER;
+		}
+
+		text = std::string_view(letters, count);
+	}
+
+	char* output = arena.allocate(text.length());
+	CipherStatus status = encrypting ? CipherEngine::encrypt(text, schedule, output, rowWidth)
+		: CipherEngine::decrypt(text, schedule, output, rowWidth);
+
+	if (status == CipherStatus::OK)
+	{
+		result = std::string_view(output, text.length());
+	}
+
+	return status;
+}
@@ -0,0 +1,74 @@
+/*
+Author:			My Tran
+Filename:		CipherContext.h
+Description:	This file provides the declarations of the CipherContext class. A CipherContext is meant to be kept for the
+life of a thread that handles many small messages. It keeps its scratch buffers in a ScratchArena between calls, so
+normalizing the text and holding the result reuse the same memory. After the first message of the largest size, a call
+makes no heap allocations at all. Results are handed back as views into the context and stay valid until its next call.
+One context may only be used by one thread at a time.
+*/
+#pragma once
+#include<cstddef>
+#include<string_view>
+#include "CipherEngine.h"
+#include "Normalizer.h"
+#include "ScratchArena.h"
+
+class CipherContext
+{
+	public:
+		/*
+		Purpose:		Creates a context, reserving scratch space up front if a size is given.
+		Pre-condition:	Takes the longest message expected, which may be 0 to grow on first use.
+		Post-condition:	None
+		*/
+		CipherContext(size_t = 0);
+
+		/*
+		Purpose:		Encrypts lower case plaintext into the context's buffer.
+		Pre-condition:	Same as CipherEngine::encrypt, with the view the ciphertext is returned in before the row width.
+		Post-condition:	Returns the status of CipherEngine::encrypt. The view holds the ciphertext if it is OK and is empty
+						otherwise.
+		*/
+		CipherStatus encrypt(std::string_view, const KeySchedule&, std::string_view&, size_t = 0);
+
+		/*
+		Purpose:		Decrypts lower case ciphertext into the context's buffer.
+		Pre-condition:	Same as CipherEngine::decrypt, with the view the plaintext is returned in before the row width.
+		Post-condition:	Returns the status of CipherEngine::decrypt. The view holds the plaintext if it is OK and is empty
+						otherwise.
+		*/
+		CipherStatus decrypt(std::string_view, const KeySchedule&, std::string_view&, size_t = 0);
+
+		/*
+		Purpose:		Removes whitespace, makes letters lower case and encrypts the result, all in the context's buffers.
+		Pre-condition:	Takes text as typed or read, the schedule and the view the ciphertext is returned in.
+		Post-condition:	Returns INVALID_CHARACTER if the text has a character other than letters and whitespace, with its
+						offset given by getInvalidOffset(), or the status of the encryption otherwise.
+		*/
+		CipherStatus encryptText(std::string_view, const KeySchedule&, std::string_view&);
+
+		/*
+		Purpose:		Removes whitespace, makes letters lower case and decrypts the result, all in the context's buffers.
+		Pre-condition:	Takes text as typed or read, the schedule and the view the plaintext is returned in.
+		Post-condition:	Returns INVALID_CHARACTER if the text has a character other than letters and whitespace, with its
+						offset given by getInvalidOffset(), or the status of the decryption otherwise.
+		*/
+		CipherStatus decryptText(std::string_view, const KeySchedule&, std::string_view&);
+
+		size_t getInvalidOffset() const;	//returns the offset of the invalid byte found by the last call, or Normalizer::NO_INVALID
+		size_t getCapacity() const;	//returns the bytes of scratch space held
+		size_t getHeapAllocations() const;	//returns the number of times the scratch space was allocated or grown
+	private:
+		//private data members
+		ScratchArena arena;	//scratch space reused by every call
+		size_t invalidOffset;	//offset of the invalid byte found by the last call
+
+		/*
+		Purpose:		Runs a call of the context.
+		Pre-condition:	Takes the text, the schedule, the view the result is returned in, whether to encrypt, whether to
+						normalize the text first and the row width.
+		Post-condition:	Returns the status of the call.
+		*/
+		CipherStatus run(std::string_view, const KeySchedule&, std::string_view&, bool, bool, size_t);
+};
@@ -0,0 +1,336 @@
+/*
+Author:			My Tran
+Filename:		CipherEngine.cpp
+Description:	This file implements the header file CipherEngine.h providing the definitions for the methods of the
+CipherEngine class.
+*/
+#include "CipherEngine.h"
+#include "AlphabetSubstitution.h"
+#include "Instrumentation.h"
+#include<cstdint>
+#include<cstring>
+
+const int ALPHABET_SIZE = 26;	//number of letters the cipher operates on
+const uint64_t EVERY_BYTE = 0x0101010101010101;	//multiplying a byte by this repeats it in every byte of a word
+
+//every inverse is checked at compile time so the table can stand in for searching
+static constexpr bool checkModInverses()
+{
+	for (int input = 1; input < ALPHABET_SIZE; input++)
+	{
+		int inverse = CipherEngine::calcModInverse(input);
+
+		if (CipherEngine::isValidKeyNum(input) ? ((input * inverse) % ALPHABET_SIZE) != 1 : inverse != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+static_assert(checkModInverses(), "MOD_INVERSES must hold the inverse of every valid keyNum");
+
+const size_t TILE_ROWS = 32;	//rows of the matrix substituted together, so each column they share is written as one run
+const size_t TILE_COLUMNS = 128;	//columns of those rows substituted at a time
+const size_t ROW_BLOCK_SIZE = TILE_ROWS * TILE_COLUMNS;	//number of elements of the bottom row substituted at a time
+
+CipherStatus CipherEngine::encrypt(std::string_view plaintext, const CipherKey& key, char* output)
+{
+	return encrypt(plaintext, KeySchedule(key), output);
+}
+
+CipherStatus CipherEngine::encrypt(std::string_view plaintext, const KeySchedule& schedule, char* output, size_t rowWidth)
+{
+	INSTRUMENT_STAGE(CipherStage::ENCRYPT, plaintext.length());
+
+	if (plaintext.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	CipherStatus status = schedule.validateLength(plaintext.length(), rowWidth);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	if (!isLowerCase(plaintext))
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	Transposition transposition(plaintext.length(), schedule.getKey().permutation, rowWidth);
+	encryptBlock(plaintext.data(), 0, schedule.getSubstitution(), transposition, output);
+	INSTRUMENT_MESSAGE(plaintext.length());
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherEngine::decrypt(std::string_view ciphertext, const CipherKey& key, char* output)
+{
+	return decrypt(ciphertext, KeySchedule(key), output);
+}
+
+CipherStatus CipherEngine::decrypt(std::string_view ciphertext, const KeySchedule& schedule, char* output, size_t rowWidth)
+{
+	INSTRUMENT_STAGE(CipherStage::DECRYPT, ciphertext.length());
+
+	if (ciphertext.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	CipherStatus status = schedule.validateLength(ciphertext.length(), rowWidth);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	if (!isLowerCase(ciphertext))
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	Transposition transposition(ciphertext.length(), schedule.getKey().permutation, rowWidth);
+	decryptBlock(ciphertext.data(), 0, schedule.getSubstitution(), transposition, output);
+	INSTRUMENT_MESSAGE(ciphertext.length());
+
+	return CipherStatus::OK;
+}
+
+template<typename SubstitutionType>
+void CipherEngine::encryptBlock(const char* plaintext, size_t position, const SubstitutionType& substitution,
+	const Transposition& transposition, char* output)
+{
+	//a block that fits in the tile buffer stays in cache anyway, so it is substituted in one run and then transposed
+	if (transposition.getLength() <= ROW_BLOCK_SIZE)
+	{
+		char text[ROW_BLOCK_SIZE];	//block after substitution
+
+		{
+			INSTRUMENT_STAGE(CipherStage::SUBSTITUTE, transposition.getLength());
+			substitution.apply(plaintext, position, transposition.getLength(), text);
+		}
+
+		INSTRUMENT_STAGE(CipherStage::TRANSPOSE, transposition.getLength());
+		transposition.transpose(text, output);
+		return;
+	}
+
+	encryptRows(plaintext, position, substitution, transposition, 0, transposition.getOccupiedRows(), output);
+}
+
+template<typename SubstitutionType>
+void CipherEngine::encryptRows(const char* plaintext, size_t position, const SubstitutionType& substitution,
+	const Transposition& transposition, size_t firstRow, size_t endRow, char* output)
+{
+	char tile[ROW_BLOCK_SIZE];	//tile of the reordered matrix after substitution
+	size_t matrixSize = transposition.getMatrixSize();
+	size_t bottomRow = transposition.getOccupiedRows() - 1;
+	size_t fullEnd = (endRow < bottomRow) ? endRow : bottomRow;
+
+	//every row but the bottom one is full, so those rows are substituted a tile at a time into a buffer that stays in
+	//cache and each column of the tile is stored straight at its transposed positions in one run
+	for (size_t r = firstRow; r < fullEnd; r += TILE_ROWS)
+	{
+		size_t rows = (fullEnd - r < TILE_ROWS) ? fullEnd - r : TILE_ROWS;
+
+		for (size_t c = 0; c < matrixSize; c += TILE_COLUMNS)
+		{
+			size_t columns = (matrixSize - c < TILE_COLUMNS) ? matrixSize - c : TILE_COLUMNS;
+
+			{
+				INSTRUMENT_STAGE(CipherStage::SUBSTITUTE, rows * columns);
+				for (size_t t = 0; t < rows; t++)
+				{
+					size_t start = transposition.getRowStart(r + t) + c;
+					substitution.apply(plaintext + start, position + start, columns, tile + (t * columns));
+				}
+			}
+
+			INSTRUMENT_STAGE(CipherStage::TRANSPOSE, rows * columns);
+			transposition.transposeTile(tile, r, rows, c, columns, output);
+		}
+	}
+
+	if (endRow <= bottomRow)
+	{
+		return;
+	}
+
+	//the bottom row may be shorter than the rest, so it is substituted and stored on its own
+	size_t start = transposition.getRowStart(bottomRow);
+	size_t rowLength = transposition.getRowLength(bottomRow);
+
+	for (size_t c = 0; c < rowLength; c += ROW_BLOCK_SIZE)
+	{
+		size_t count = (rowLength - c < ROW_BLOCK_SIZE) ? rowLength - c : ROW_BLOCK_SIZE;
+
+		{
+			INSTRUMENT_STAGE(CipherStage::SUBSTITUTE, count);
+			substitution.apply(plaintext + start + c, position + start + c, count, tile);
+		}
+
+		INSTRUMENT_STAGE(CipherStage::TRANSPOSE, count);
+		transposition.transposeRow(tile, bottomRow, c, count, output);
+	}
+}
+
+template<typename SubstitutionType>
+void CipherEngine::decryptBlock(const char* ciphertext, size_t position, const SubstitutionType& substitution,
+	const Transposition& transposition, char* output)
+{
+	//a small block is put back in order and the substitution undone in place while it is still in cache
+	if (transposition.getLength() <= ROW_BLOCK_SIZE)
+	{
+		{
+			INSTRUMENT_STAGE(CipherStage::UNTRANSPOSE, transposition.getLength());
+			transposition.untranspose(ciphertext, output);
+		}
+
+		INSTRUMENT_STAGE(CipherStage::INVERT_SUBSTITUTE, transposition.getLength());
+		substitution.invert(output, position, transposition.getLength(), output);
+		return;
+	}
+
+	decryptRows(ciphertext, position, substitution, transposition, 0, transposition.getOccupiedRows(), output);
+}
+
+template<typename SubstitutionType>
+void CipherEngine::decryptRows(const char* ciphertext, size_t position, const SubstitutionType& substitution,
+	const Transposition& transposition, size_t firstRow, size_t endRow, char* output)
+{
+	char tile[ROW_BLOCK_SIZE];	//tile of the reordered matrix gathered from the ciphertext
+	size_t matrixSize = transposition.getMatrixSize();
+	size_t bottomRow = transposition.getOccupiedRows() - 1;
+	size_t fullEnd = (endRow < bottomRow) ? endRow : bottomRow;
+
+	//the mirror of encryptRows: each column of a tile is gathered in one run, and the substitution of each row of the
+	//tile is undone on its way to the row's plaintext position, so the output is written only once
+	for (size_t r = firstRow; r < fullEnd; r += TILE_ROWS)
+	{
+		size_t rows = (fullEnd - r < TILE_ROWS) ? fullEnd - r : TILE_ROWS;
+
+		for (size_t c = 0; c < matrixSize; c += TILE_COLUMNS)
+		{
+			size_t columns = (matrixSize - c < TILE_COLUMNS) ? matrixSize - c : TILE_COLUMNS;
+
+			{
+				INSTRUMENT_STAGE(CipherStage::UNTRANSPOSE, rows * columns);
+				transposition.untransposeTile(ciphertext, r, rows, c, columns, tile);
+			}
+
+			INSTRUMENT_STAGE(CipherStage::INVERT_SUBSTITUTE, rows * columns);
+			for (size_t t = 0; t < rows; t++)
+			{
+				size_t start = transposition.getRowStart(r + t) + c;
+				substitution.invert(tile + (t * columns), position + start, columns, output + start);
+			}
+		}
+	}
+
+	if (endRow <= bottomRow)
+	{
+		return;
+	}
+
+	//the bottom row is collected into its contiguous plaintext position and the substitution undone there
+	size_t start = transposition.getRowStart(bottomRow);
+	size_t rowLength = transposition.getRowLength(bottomRow);
+
+	{
+		INSTRUMENT_STAGE(CipherStage::UNTRANSPOSE, rowLength);
+		transposition.untransposeRow(ciphertext, bottomRow, 0, rowLength, output + start);
+	}
+
+	INSTRUMENT_STAGE(CipherStage::INVERT_SUBSTITUTE, rowLength);
+	substitution.invert(output + start, position + start, rowLength, output + start);
+}
+
+CipherStatus CipherEngine::validateKey(const CipherKey& key, size_t length)
+{
+	return KeySchedule(key).validateLength(length);
+}
+
+const char* CipherEngine::describeStatus(CipherStatus status)
+{
+	switch (status)
+	{
+	case CipherStatus::OK:
+		return "success";
+	case CipherStatus::EMPTY_INPUT:
+		return "nothing to encrypt or decrypt";
+	case CipherStatus::INVALID_CHARACTER:
+		return "text may only contain letters of the alphabet";
+	case CipherStatus::INVALID_KEY_NUM:
+		return "key number must be a positive odd integer less than 26 other than 13, or for another alphabet less than "
+			"its size and sharing no factor with it";
+	case CipherStatus::INVALID_KEY_PHRASE:
+		return "key phrase may only contain letters of the alphabet";
+	case CipherStatus::INVALID_PERMUTATION:
+		return "key combination must use each row number exactly once";
+	case CipherStatus::INVALID_HEADER:
+		return "stream does not start with a valid header";
+	case CipherStatus::STREAM_ERROR:
+		return "stream could not be read or written";
+	case CipherStatus::LENGTH_MISMATCH:
+		return "text does not have the length given in its header";
+	case CipherStatus::INVALID_ARCHIVE:
+		return "file is not a complete archive or is damaged";
+	case CipherStatus::NO_SUCH_RECORD:
+		return "archive has no record with that number";
+	case CipherStatus::INVALID_KEY_FILE:
+		return "key store file has a line that is not understood";
+	case CipherStatus::UNKNOWN_KEY:
+		return "no key has that number or name";
+	case CipherStatus::DUPLICATE_KEY:
+		return "a key with that number or name already exists";
+	case CipherStatus::INVALID_PIPELINE_FILE:
+		return "pipeline file has a line that is not understood";
+	case CipherStatus::SAME_FILE:
+		return "input and output name the same file";
+	default:
+		return "unknown error";
+	}
+}
+
+bool CipherEngine::isLowerCase(std::string_view text)
+{
+	size_t i = 0;
+
+	//eight letters are checked at once: a byte below 'a' borrows into its top bit when 'a' is subtracted from it, and a
+	//byte above 'z' or with its top bit already set carries into it when 127 - 'z' is added
+	for (; i + sizeof(uint64_t) <= text.length(); i += sizeof(uint64_t))
+	{
+		uint64_t letters;
+		std::memcpy(&letters, text.data() + i, sizeof(letters));
+
+		uint64_t below = (letters - (EVERY_BYTE * 'a')) & ~letters;
+		uint64_t above = (letters + (EVERY_BYTE * (127 - 'z'))) | letters;
+
+		if (((below | above) & (EVERY_BYTE * 0x80)) != 0)
+		{
+			return false;
+		}
+	}
+
+	for (; i < text.length(); i++)
+	{
+		if (text[i] < 'a' || text[i] > 'z')
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//the tiled loops are shared by the lower case substitution and the substitution of any other alphabet
+template void CipherEngine::encryptBlock(const char*, size_t, const Substitution&, const Transposition&, char*);
+template void CipherEngine::encryptBlock(const char*, size_t, const AlphabetSubstitution&, const Transposition&, char*);
+template void CipherEngine::decryptBlock(const char*, size_t, const Substitution&, const Transposition&, char*);
+template void CipherEngine::decryptBlock(const char*, size_t, const AlphabetSubstitution&, const Transposition&, char*);
+template void CipherEngine::encryptRows(const char*, size_t, const Substitution&, const Transposition&, size_t, size_t, char*);
+template void CipherEngine::encryptRows(const char*, size_t, const AlphabetSubstitution&, const Transposition&, size_t, size_t, char*);
+template void CipherEngine::decryptRows(const char*, size_t, const Substitution&, const Transposition&, size_t, size_t, char*);
+template void CipherEngine::decryptRows(const char*, size_t, const AlphabetSubstitution&, const Transposition&, size_t, size_t, char*);
@@ -0,0 +1,133 @@
+/*
+Author:			My Tran
+Filename:		CipherEngine.h
+Description:	This file provides the declarations of the CipherEngine class. CipherEngine is the non-interactive form of
+the product cipher used by Encryptor: it takes text and a CipherKey, writes the result into a buffer supplied by the
+caller, allocates no memory and touches no console streams, so it may be called from any number of threads at once.
+*/
+#pragma once
+#include<cstddef>
+#include<string_view>
+#include "CipherKey.h"
+#include "KeySchedule.h"
+#include "Substitution.h"
+#include "Transposition.h"
+
+class CipherEngine
+{
+	public:
+		/*
+		Purpose:		Apply the affine/vigenere substitution and the row transposition to plaintext.
+		Pre-condition:	Takes lower case plaintext, the key to encrypt with, and a buffer of at least plaintext.length()
+						characters.
+		Post-condition:	Returns OK and the ciphertext is stored in output. Otherwise output is left unspecified.
+		*/
+		static CipherStatus encrypt(std::string_view plaintext, const CipherKey& key, char* output);
+
+		/*
+		Purpose:		Encrypt plaintext with a key whose schedule has already been built.
+		Pre-condition:	Takes lower case plaintext, the schedule of the key, a buffer of at least plaintext.length()
+						characters, and the row width of the matrix, or 0 for the least square.
+		Post-condition:	Returns OK and the ciphertext is stored in output. Otherwise output is left unspecified.
+		*/
+		static CipherStatus encrypt(std::string_view plaintext, const KeySchedule& schedule, char* output, size_t rowWidth = 0);
+
+		/*
+		Purpose:		Reverse the row transposition and the affine/vigenere substitution on ciphertext.
+		Pre-condition:	Takes lower case ciphertext, the key it was encrypted with, and a buffer of at least
+						ciphertext.length() characters.
+		Post-condition:	Returns OK and the plaintext is stored in output. Otherwise output is left unspecified.
+		*/
+		static CipherStatus decrypt(std::string_view ciphertext, const CipherKey& key, char* output);
+
+		/*
+		Purpose:		Decrypt ciphertext with a key whose schedule has already been built.
+		Pre-condition:	Takes lower case ciphertext, the schedule of the key, a buffer of at least ciphertext.length()
+						characters, and the row width the ciphertext was encrypted with, or 0 for the least square.
+		Post-condition:	Returns OK and the plaintext is stored in output. Otherwise output is left unspecified.
+		*/
+		static CipherStatus decrypt(std::string_view ciphertext, const KeySchedule& schedule, char* output, size_t rowWidth = 0);
+
+		/*
+		Purpose:		Encrypts one block of a message without validating anything.
+		Pre-condition:	Takes lower case plaintext of the transposition's length, the position of the block in the whole
+						message, the substitution and transposition to use, and a buffer of the transposition's length.
+						The substitution may instead be an AlphabetSubstitution, with text of its alphabet.
+		Post-condition:	The ciphertext of the block is stored in output.
+		*/
+		template<typename SubstitutionType>
+		static void encryptBlock(const char*, size_t, const SubstitutionType&, const Transposition&, char*);
+
+		/*
+		Purpose:		Decrypts one block of a message without validating anything.
+		Pre-condition:	Takes lower case ciphertext of the transposition's length, the position of the block in the whole
+						message, the substitution and transposition to use, and a buffer of the transposition's length.
+						The substitution may instead be an AlphabetSubstitution, with text of its alphabet.
+		Post-condition:	The plaintext of the block is stored in output.
+		*/
+		template<typename SubstitutionType>
+		static void decryptBlock(const char*, size_t, const SubstitutionType&, const Transposition&, char*);
+
+		/*
+		Purpose:		Encrypts some of the rows of the reordered matrix of a block. Each row writes to positions no other
+						row writes to, so separate threads may encrypt separate rows of the same block.
+		Pre-condition:	Takes the same arguments as encryptBlock, plus the first row and one past the last row.
+		Post-condition:	The ciphertext of those rows is stored at their positions in output.
+		*/
+		template<typename SubstitutionType>
+		static void encryptRows(const char*, size_t, const SubstitutionType&, const Transposition&, size_t, size_t, char*);
+
+		/*
+		Purpose:		Decrypts some of the rows of the reordered matrix of a block. Each row writes to positions no other
+						row writes to, so separate threads may decrypt separate rows of the same block.
+		Pre-condition:	Takes the same arguments as decryptBlock, plus the first row and one past the last row.
+		Post-condition:	The plaintext of those rows is stored at their positions in output.
+		*/
+		template<typename SubstitutionType>
+		static void decryptRows(const char*, size_t, const SubstitutionType&, const Transposition&, size_t, size_t, char*);
+
+		/*
+		Purpose:		Checks that every part of a key can be used on a message of the given length.
+		Pre-condition:	Takes the key and the length of the message it will be used on.
+		Post-condition:	Returns OK if the key is usable, otherwise the status describing the first problem found.
+		*/
+		static CipherStatus validateKey(const CipherKey& key, size_t length);
+
+		/*
+		Purpose:		Determines if a number can be used as the keyNum of the affine cipher.
+		Pre-condition:	Takes integer argument representing the candidate key number.
+		Post-condition:	Returns true if the number is positive, less than 26 and shares no factor with 26.
+		*/
+		static constexpr bool isValidKeyNum(int keyNum)
+		{
+			//26 only has the factors 1, 2, 13, 26
+			return (keyNum > 0) && (keyNum < 26) && (keyNum % 2 != 0) && (keyNum % 13 != 0);
+		}
+
+		/*
+		Purpose:		Calculates the modular multiplicative inverse of a given number for (mod 26)
+		Pre-condition:	Takes a key number.
+		Post-condition:	Returns inverse, or 0 if the number is not a valid key number.
+		*/
+		static constexpr int calcModInverse(int input)
+		{
+			return isValidKeyNum(input) ? MOD_INVERSES[input] : 0;
+		}
+
+		/*
+		Purpose:		Gives a readable description of a status code.
+		Pre-condition:	Takes status returned by the cipher API.
+		Post-condition:	Returns description suitable for printing to the user.
+		*/
+		static const char* describeStatus(CipherStatus);
+
+		/*
+		Purpose:		Determines if text is made up only of lower case alphabetical letters.
+		Pre-condition:	Takes text to check.
+		Post-condition:	Returns true if every character is between 'a' and 'z'. False otherwise.
+		*/
+		static bool isLowerCase(std::string_view);
+	private:
+		//modular multiplicative inverse mod 26 of each number below 26, 0 where there is none
+		static constexpr int MOD_INVERSES[26] = { 0, 1, 0, 9, 0, 21, 0, 15, 0, 3, 0, 19, 0, 0, 0, 7, 0, 23, 0, 11, 0, 5, 0, 17, 0, 25 };
+};
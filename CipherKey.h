@@ -0,0 +1,37 @@
+/*
+Author:			My Tran
+Filename:		CipherKey.h
+Description:	This file provides the declarations of the CipherKey structure, which bundles every key value needed by the
+product cipher, and the status codes reported by the non-interactive cipher API.
+*/
+#pragma once
+#include<string>
+#include<vector>
+
+//outcome of a call into the non-interactive cipher API
+enum class CipherStatus
+{
+	OK,	//operation succeeded and the output buffer holds the result
+	EMPTY_INPUT,	//there was no text to encrypt or decrypt
+	INVALID_CHARACTER,	//text contains a character outside of the lower case alphabet
+	INVALID_KEY_NUM,	//keyNum is not a positive odd number less than 26 other than 13, or has no inverse mod the alphabet size
+	INVALID_KEY_PHRASE,	//keyPhrase is empty or contains a character outside of the lower case alphabet
+	INVALID_PERMUTATION,	//permutation does not use each row from 0 to (occupied rows - 2) exactly once
+	INVALID_HEADER,	//stream does not start with a header this version understands
+	STREAM_ERROR,	//stream could not be read from or written to
+	LENGTH_MISMATCH,	//text is longer or shorter than the length its header gave
+	INVALID_ARCHIVE,	//file is not a complete archive of a version this program understands
+	NO_SUCH_RECORD,	//archive has no record with the number asked for
+	INVALID_KEY_FILE,	//key store file has a line that is not understood
+	UNKNOWN_KEY,	//no key has the number or name asked for
+	DUPLICATE_KEY,	//a key with the same number or name was added already
+	INVALID_PIPELINE_FILE,	//pipeline file has a line that is not understood
+	SAME_FILE	//input and output paths name the same file
+};
+
+struct CipherKey
+{
+	int keyNum = 0;	//numerical key used for affine cipher method
+	std::string keyPhrase;	//key phrase or word used for vigenere method, lower case letters only
+	std::vector<int> permutation;	//order the full rows of the transposition matrix are stacked in
+};
@@ -0,0 +1,614 @@
+/*
+Author:			My Tran
+Filename:		CipherPipeline.cpp
+Description:	This file implements the header file CipherPipeline.h providing the definitions for the methods of the
+CipherPipeline class.
+*/
+#include "CipherPipeline.h"
+#include "KeySchedule.h"
+#include "Normalizer.h"
+#include<cstring>
+#include<fstream>
+#include<numeric>
+#include<sstream>
+
+const int ALPHABET_SIZE = 26;	//number of letters in the alphabet
+const size_t GATHER_CHUNK = 1 << 14;	//letters gathered before they are substituted, few enough to still be in cache
+
+/*
+Purpose:		Folds a substitution stage into the substitution of the stages before it.
+Pre-condition:	Takes the stage, the position each letter of the plaintext has been moved to by the stages before it or
+				an empty vector if none has moved, the message length, and the keyNum and key stream folded so far.
+Post-condition:	The keyNum and key stream are those of the stages before followed by this one.
+*/
+static void foldSubstitution(const PipelineStage& stage, const std::vector<uint32_t>& positions, size_t length,
+	int& keyNum, std::string& stream)
+{
+	size_t period = stream.length();
+	size_t phraseLength = stage.keyPhrase.length();
+
+	//a(a'P + b') + b: until a transposition moves the letters, the stream repeats every least common multiple of the two
+	//periods, and after one it has a key letter of its own for every position
+	size_t folded = length;
+	if (positions.empty())
+	{
+		size_t common = period / std::gcd(period, phraseLength);
+		folded = (common <= length / phraseLength) ? common * phraseLength : length;
+	}
+
+	std::string next(folded, 'a');
+	for (size_t i = 0; i < folded; i++)
+	{
+		size_t position = positions.empty() ? i : positions[i];
+		int b = (stage.keyNum * (stream[i % period] - 'a')) + (stage.keyPhrase[position % phraseLength] - 'a');
+		next[i] = (char)('a' + (b % ALPHABET_SIZE));
+	}
+
+	keyNum = (keyNum * stage.keyNum) % ALPHABET_SIZE;
+	stream.swap(next);
+}
+
+/*
+Purpose:		Moves every letter the way a row transposition does.
+Pre-condition:	Takes the permutation of the full rows, the message length and the position of every letter of the
+				plaintext before the transposition.
+Post-condition:	Every position is where the transposition moves the letter to.
+*/
+static void moveRows(const std::vector<int>& permutation, size_t length, std::vector<uint32_t>& positions)
+{
+	Transposition rows(length, permutation);
+	size_t width = rows.getMatrixSize();
+
+	//row of the reordered matrix each row of the text is stacked at, the bottom row staying where it is
+	std::vector<size_t> stacked(rows.getOccupiedRows());
+	for (size_t r = 0; r < permutation.size(); r++)
+	{
+		stacked[permutation[r]] = r;
+	}
+	stacked.back() = stacked.size() - 1;
+
+	std::vector<size_t> columnStarts(width);
+	for (size_t c = 0; c < width; c++)
+	{
+		columnStarts[c] = rows.getColumnStart(c);
+	}
+
+	//each column of the reordered matrix holds its rows one after another
+	for (uint32_t& position : positions)
+	{
+		position = (uint32_t)(columnStarts[position % width] + stacked[position / width]);
+	}
+}
+
+/*
+Purpose:		Works out where each column of a columnar transposition starts in the transposed text.
+Pre-condition:	Takes the order the columns are read in, the message length and the vector the starts are stored in.
+Post-condition:	starts holds the position of the top letter of each column, by column.
+*/
+static void findColumnStarts(const std::vector<int>& order, size_t length, std::vector<size_t>& starts)
+{
+	size_t width = order.size();
+	size_t fullColumn = length / width;
+	size_t longColumns = length % width;
+
+	//the columns left of the end of the bottom row hold one letter more than the others
+	starts.resize(width);
+	for (size_t t = 0, start = 0; t < width; t++)
+	{
+		size_t column = order[t];
+		starts[column] = start;
+		start += fullColumn + ((column < longColumns) ? 1 : 0);
+	}
+}
+
+/*
+Purpose:		Moves every letter the way a columnar transposition does.
+Pre-condition:	Takes the order the columns are read in, the message length and the position of every letter of the
+				plaintext before the transposition.
+Post-condition:	Every position is where the transposition moves the letter to.
+*/
+static void moveColumns(const std::vector<int>& order, size_t length, std::vector<uint32_t>& positions)
+{
+	size_t width = order.size();
+	std::vector<size_t> starts;
+	findColumnStarts(order, length, starts);
+
+	for (uint32_t& position : positions)
+	{
+		position = (uint32_t)(starts[position % width] + (position / width));
+	}
+}
+
+/*
+Purpose:		Runs or undoes one stage over the whole text.
+Pre-condition:	Takes the stage, true to undo it, the text and a scratch string of the same length.
+Post-condition:	Returns OK and text holds the result, or INVALID_PERMUTATION if a row transposition does not fit the
+				length of the text.
+*/
+static CipherStatus runStage(const PipelineStage& stage, bool undo, std::string& text, std::string& scratch)
+{
+	size_t length = text.length();
+
+	if (stage.type == PipelineStageType::SUBSTITUTE)
+	{
+		Substitution substitution(stage.keyNum, stage.keyPhrase);
+		if (undo)
+		{
+			substitution.invert(text.data(), 0, length, &text[0]);
+		}
+		else
+		{
+			substitution.apply(text.data(), 0, length, &text[0]);
+		}
+
+		return CipherStatus::OK;
+	}
+
+	if (stage.type == PipelineStageType::ROWS)
+	{
+		if (!KeySchedule::fitsLength(stage.order, length))
+		{
+			return CipherStatus::INVALID_PERMUTATION;
+		}
+
+		Transposition rows(length, stage.order);
+		if (undo)
+		{
+			rows.untranspose(text.data(), &scratch[0]);
+		}
+		else
+		{
+			rows.transpose(text.data(), &scratch[0]);
+		}
+
+		text.swap(scratch);
+		return CipherStatus::OK;
+	}
+
+	size_t width = stage.order.size();
+	std::vector<size_t> starts;
+	findColumnStarts(stage.order, length, starts);
+
+	for (size_t position = 0; position < length; position++)
+	{
+		size_t moved = starts[position % width] + (position / width);
+		if (undo)
+		{
+			scratch[position] = text[moved];
+		}
+		else
+		{
+			scratch[moved] = text[position];
+		}
+	}
+
+	text.swap(scratch);
+	return CipherStatus::OK;
+}
+
+CipherPipeline::CipherPipeline()
+{
+	rounds = 1;
+	errorLine = 0;
+	length = 0;
+	keyNum = 1;
+}
+
+CipherStatus CipherPipeline::load(const std::string& path)
+{
+	errorLine = 0;
+
+	std::ifstream file(path);
+	if (!file)
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	size_t number = 0;
+
+	for (std::string line; std::getline(file, line);)
+	{
+		number++;
+
+		std::istringstream fields(line);
+		std::string entry;
+		fields >> entry;
+
+		std::string value;
+		std::getline(fields >> std::ws, value);
+
+		//blank lines and lines starting with # are skipped
+		if (entry.empty() || entry[0] == '#')
+		{
+			continue;
+		}
+
+		bool understood = true;
+		CipherStatus status = CipherStatus::OK;
+		std::vector<int> order;
+
+		if (entry == "affine")
+		{
+			std::istringstream digits(value);
+			int stageKeyNum = 0;
+			understood = (digits >> stageKeyNum) && digits.eof();
+			status = understood ? addSubstitution(stageKeyNum, "a") : status;
+		}
+		else if (entry == "vigenere")
+		{
+			std::string keyPhrase;
+			size_t invalidOffset = 0;
+			understood = Normalizer::normalize(value, keyPhrase, Normalizer::Whitespace::SPACES, invalidOffset) == CipherStatus::OK;
+			status = understood ? addSubstitution(1, keyPhrase) : status;
+		}
+		else if (entry == "rows")
+		{
+			understood = KeySchedule::parsePermutation(value, order);
+			status = understood ? addRows(order) : status;
+		}
+		else if (entry == "columns")
+		{
+			understood = KeySchedule::parsePermutation(value, order);
+			status = understood ? addColumns(order) : status;
+		}
+		else if (entry == "rounds")
+		{
+			std::istringstream digits(value);
+			size_t count = 0;
+			understood = (digits >> count) && digits.eof() && count > 0 && value[0] != '-';
+			rounds = understood ? count : rounds;
+		}
+		else
+		{
+			understood = false;
+		}
+
+		if (!understood || status != CipherStatus::OK)
+		{
+			errorLine = number;
+			return understood ? status : CipherStatus::INVALID_PIPELINE_FILE;
+		}
+	}
+
+	if (file.bad())
+	{
+		errorLine = number;
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherPipeline::addSubstitution(int stageKeyNum, const std::string& keyPhrase)
+{
+	if (!CipherEngine::isValidKeyNum(stageKeyNum))
+	{
+		return CipherStatus::INVALID_KEY_NUM;
+	}
+
+	if (keyPhrase.empty() || !CipherEngine::isLowerCase(keyPhrase))
+	{
+		return CipherStatus::INVALID_KEY_PHRASE;
+	}
+
+	PipelineStage stage;
+	stage.keyNum = stageKeyNum;
+	stage.keyPhrase = keyPhrase;
+	stages.push_back(stage);
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherPipeline::addRows(const std::vector<int>& permutation)
+{
+	if (!KeySchedule::isPermutation(permutation))
+	{
+		return CipherStatus::INVALID_PERMUTATION;
+	}
+
+	PipelineStage stage;
+	stage.type = PipelineStageType::ROWS;
+	stage.order = permutation;
+	stages.push_back(stage);
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherPipeline::addColumns(const std::vector<int>& order)
+{
+	if (order.empty() || !KeySchedule::isPermutation(order))
+	{
+		return CipherStatus::INVALID_PERMUTATION;
+	}
+
+	PipelineStage stage;
+	stage.type = PipelineStageType::COLUMNS;
+	stage.order = order;
+	stages.push_back(stage);
+
+	return CipherStatus::OK;
+}
+
+void CipherPipeline::setRounds(size_t count)
+{
+	rounds = (count > 0) ? count : 1;
+}
+
+CipherStatus CipherPipeline::compile(size_t messageLength)
+{
+	length = 0;
+	keyNum = 1;
+	plainStream.clear();
+	cipherStream.clear();
+	sources.clear();
+	targets.clear();
+	permutation.clear();
+	plainSubstitution.reset();
+	cipherSubstitution.reset();
+	transposition.reset();
+
+	if (messageLength == 0)
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	if (messageLength > MAX_LENGTH)
+	{
+		return CipherStatus::LENGTH_MISMATCH;
+	}
+
+	//every row transposition must order the full rows of this length
+	size_t fullRows = Transposition::calcOccupiedRows(messageLength, 0) - 1;
+	size_t transpositions = 0;
+	bool substitutedAfter = false;	//true if a substitution comes after a transposition of the same round
+	const PipelineStage* rows = nullptr;	//first row transposition
+
+	for (const PipelineStage& stage : stages)
+	{
+		if (stage.type == PipelineStageType::ROWS && stage.order.size() != fullRows)
+		{
+			return CipherStatus::INVALID_PERMUTATION;
+		}
+
+		if (stage.type == PipelineStageType::SUBSTITUTE)
+		{
+			substitutedAfter = substitutedAfter || (transpositions > 0);
+		}
+		else
+		{
+			transpositions++;
+			rows = (rows == nullptr && stage.type == PipelineStageType::ROWS) ? &stage : rows;
+		}
+	}
+
+	//one row transposition after every substitution is the cipher of CipherEngine, whose letters need not be tracked
+	bool engine = (rounds == 1) && (transpositions == 1) && (rows != nullptr) && !substitutedAfter;
+
+	int folded = 1;
+	std::string stream(1, 'a');
+	std::vector<uint32_t> positions;	//position each letter of the plaintext is moved to, empty until one is moved
+
+	for (size_t round = 0; round < rounds; round++)
+	{
+		for (const PipelineStage& stage : stages)
+		{
+			if (stage.type == PipelineStageType::SUBSTITUTE)
+			{
+				foldSubstitution(stage, positions, messageLength, folded, stream);
+				continue;
+			}
+
+			if (engine)
+			{
+				continue;
+			}
+
+			if (positions.empty())
+			{
+				positions.resize(messageLength);
+				std::iota(positions.begin(), positions.end(), 0);
+			}
+
+			if (stage.type == PipelineStageType::ROWS)
+			{
+				moveRows(stage.order, messageLength, positions);
+			}
+			else
+			{
+				moveColumns(stage.order, messageLength, positions);
+			}
+		}
+	}
+
+	keyNum = folded;
+	plainStream.swap(stream);
+	plainSubstitution = std::make_unique<Substitution>(keyNum, plainStream);
+
+	if (engine)
+	{
+		permutation = rows->order;
+		transposition = std::make_unique<Transposition>(messageLength, permutation);
+	}
+	else if (!positions.empty())
+	{
+		//the ciphertext reads its key letters in its own order, so both directions substitute straight after gathering
+		targets.swap(positions);
+		sources.resize(messageLength);
+		cipherStream.resize(messageLength);
+
+		size_t period = plainStream.length();
+		for (size_t i = 0; i < messageLength; i++)
+		{
+			sources[targets[i]] = (uint32_t)i;
+			cipherStream[targets[i]] = plainStream[i % period];
+		}
+
+		cipherSubstitution = std::make_unique<Substitution>(keyNum, cipherStream);
+	}
+
+	length = messageLength;
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherPipeline::encrypt(std::string_view plaintext, char* output) const
+{
+	CipherStatus status = validateText(plaintext);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	if (plaintext.length() != length)
+	{
+		return CipherStatus::LENGTH_MISMATCH;
+	}
+
+	if (transposition)
+	{
+		CipherEngine::encryptBlock(plaintext.data(), 0, *plainSubstitution, *transposition, output);
+		return CipherStatus::OK;
+	}
+
+	if (sources.empty())
+	{
+		plainSubstitution->apply(plaintext.data(), 0, length, output);
+		return CipherStatus::OK;
+	}
+
+	//each chunk is substituted straight after it is gathered, while it is still in cache
+	for (size_t start = 0; start < length; start += GATHER_CHUNK)
+	{
+		size_t count = (length - start < GATHER_CHUNK) ? length - start : GATHER_CHUNK;
+
+		for (size_t j = start; j < start + count; j++)
+		{
+			output[j] = plaintext[sources[j]];
+		}
+
+		cipherSubstitution->apply(output + start, start, count, output + start);
+	}
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherPipeline::decrypt(std::string_view ciphertext, char* output) const
+{
+	CipherStatus status = validateText(ciphertext);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	if (ciphertext.length() != length)
+	{
+		return CipherStatus::LENGTH_MISMATCH;
+	}
+
+	if (transposition)
+	{
+		CipherEngine::decryptBlock(ciphertext.data(), 0, *plainSubstitution, *transposition, output);
+		return CipherStatus::OK;
+	}
+
+	if (targets.empty())
+	{
+		plainSubstitution->invert(ciphertext.data(), 0, length, output);
+		return CipherStatus::OK;
+	}
+
+	for (size_t start = 0; start < length; start += GATHER_CHUNK)
+	{
+		size_t count = (length - start < GATHER_CHUNK) ? length - start : GATHER_CHUNK;
+
+		for (size_t i = start; i < start + count; i++)
+		{
+			output[i] = ciphertext[targets[i]];
+		}
+
+		plainSubstitution->invert(output + start, start, count, output + start);
+	}
+
+	return CipherStatus::OK;
+}
+
+CipherStatus CipherPipeline::encryptByStage(std::string_view plaintext, char* output) const
+{
+	CipherStatus status = validateText(plaintext);
+
+	std::string text(plaintext);
+	std::string scratch(text.length(), 'a');
+
+	for (size_t round = 0; round < rounds && status == CipherStatus::OK; round++)
+	{
+		for (size_t s = 0; s < stages.size() && status == CipherStatus::OK; s++)
+		{
+			status = runStage(stages[s], false, text, scratch);
+		}
+	}
+
+	if (status == CipherStatus::OK)
+	{
+		std::memcpy(output, text.data(), text.length());
+	}
+
+	return status;
+}
+
+CipherStatus CipherPipeline::decryptByStage(std::string_view ciphertext, char* output) const
+{
+	CipherStatus status = validateText(ciphertext);
+
+	std::string text(ciphertext);
+	std::string scratch(text.length(), 'a');
+
+	for (size_t round = 0; round < rounds && status == CipherStatus::OK; round++)
+	{
+		for (size_t s = stages.size(); s > 0 && status == CipherStatus::OK; s--)
+		{
+			status = runStage(stages[s - 1], true, text, scratch);
+		}
+	}
+
+	if (status == CipherStatus::OK)
+	{
+		std::memcpy(output, text.data(), text.length());
+	}
+
+	return status;
+}
+
+const std::vector<PipelineStage>& CipherPipeline::getStages() const
+{
+	return stages;
+}
+
+size_t CipherPipeline::getRounds() const
+{
+	return rounds;
+}
+
+size_t CipherPipeline::getLength() const
+{
+	return length;
+}
+
+size_t CipherPipeline::getErrorLine() const
+{
+	return errorLine;
+}
+
+bool CipherPipeline::isEngineCipher() const
+{
+	return transposition != nullptr;
+}
+
+CipherStatus CipherPipeline::validateText(std::string_view text)
+{
+	if (text.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	return CipherEngine::isLowerCase(text) ? CipherStatus::OK : CipherStatus::INVALID_CHARACTER;
+}
@@ -0,0 +1,177 @@
+/*
+Author:			My Tran
+Filename:		CipherPipeline.h
+Description:	This file provides the declarations of the CipherPipeline class. A CipherPipeline runs a product cipher of
+any number of stages read from a pipeline file or added from code, such as several rounds of substitutions and
+transpositions, in place of the single affine/vigenere substitution and row transposition of CipherEngine.
+
+Running the stages one after another reads and writes the whole message once per stage. Instead, compile folds them into
+one substitution and one reordering for a message length. An affine/vigenere stage after another is still
+C = (aP + b) mod 26, with a the product of their keyNums and each b worked out from the two key letters at that position,
+so every substitution stage becomes one Substitution with a key stream as long as the least common multiple of the key
+phrases, at most the message length. A transposition only moves letters, so a substitution after it is moved in front of
+it by reading its key letter at the position each letter is moved to, and the transpositions together move each letter
+from one position to another, kept as a table of positions. The compiled cipher then gathers every letter from its
+position and substitutes it, the same amount of work whether the pipeline has one round or many. A pipeline with one
+row transposition and every substitution before it is the cipher of CipherEngine, and runs through its tiled kernels.
+
+Pipeline file:	one stage per line, run from the top. Blank lines and lines starting with # are skipped.
+
+	affine <keyNum>				C = (aP) mod 26
+	vigenere <keyPhrase>		C = (P + b) mod 26, b the letter of the key phrase at the position of P
+	rows <permutation>			row transposition of the least square matrix, as in CipherEngine
+	columns <order>				columnar transposition: the text is written row by row into rows as wide as the order
+								has entries, and the columns are read out one after another in the order given
+	rounds <count>				runs every stage of the file this many times, once if left out
+
+Permutations and orders are numbers separated by commas or spaces. "affine 7", "vigenere secret" and "rows 2,0,1"
+together are the cipher of CipherEngine with keyNum 7, key phrase "secret" and permutation 2,0,1.
+*/
+#pragma once
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<string>
+#include<string_view>
+#include<vector>
+#include "CipherEngine.h"
+#include "Substitution.h"
+#include "Transposition.h"
+
+//what a stage of a pipeline does to the text
+enum class PipelineStageType
+{
+	SUBSTITUTE,	//affine/vigenere substitution, C = (aP + b) mod 26
+	ROWS,	//row transposition of the least square matrix
+	COLUMNS	//columnar transposition
+};
+
+//a stage of a pipeline
+struct PipelineStage
+{
+	PipelineStageType type = PipelineStageType::SUBSTITUTE;	//what the stage does
+	int keyNum = 1;	//multiplier of a substitution
+	std::string keyPhrase = "a";	//key phrase of a substitution, "a" adding nothing
+	std::vector<int> order;	//permutation of the rows, or order the columns are read in
+};
+
+class CipherPipeline
+{
+	public:
+		/*
+		Purpose:		Creates a pipeline with no stages, which leaves text as it is.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		CipherPipeline();
+
+		CipherPipeline(const CipherPipeline&) = delete;
+		CipherPipeline& operator=(const CipherPipeline&) = delete;
+
+		/*
+		Purpose:		Adds every stage of a pipeline file.
+		Pre-condition:	Takes the path of the file.
+		Post-condition:	Returns OK if every stage was added. Returns STREAM_ERROR if the file could not be read,
+						INVALID_PIPELINE_FILE if a line is not understood, or the status of adding a stage it rejects,
+						and getErrorLine() gives the line of the problem. Stages before the problem are kept.
+		*/
+		CipherStatus load(const std::string&);
+
+		/*
+		Purpose:		Adds an affine/vigenere substitution stage.
+		Pre-condition:	Takes keyNum and a lower case key phrase.
+		Post-condition:	Returns OK if the stage was added, INVALID_KEY_NUM or INVALID_KEY_PHRASE otherwise.
+		*/
+		CipherStatus addSubstitution(int, const std::string&);
+
+		/*
+		Purpose:		Adds a row transposition stage.
+		Pre-condition:	Takes the permutation of the full rows, which must fit the length the pipeline is compiled for.
+		Post-condition:	Returns OK if the stage was added, INVALID_PERMUTATION if it is not a permutation.
+		*/
+		CipherStatus addRows(const std::vector<int>&);
+
+		/*
+		Purpose:		Adds a columnar transposition stage.
+		Pre-condition:	Takes the order the columns are read in, a permutation of 0 to (number of columns - 1).
+		Post-condition:	Returns OK if the stage was added, INVALID_PERMUTATION if it is empty or not a permutation.
+		*/
+		CipherStatus addColumns(const std::vector<int>&);
+
+		/*
+		Purpose:		Sets how many times the stages are run.
+		Pre-condition:	Takes a count of at least 1.
+		Post-condition:	None
+		*/
+		void setRounds(size_t);
+
+		/*
+		Purpose:		Folds the stages into one substitution and one reordering for messages of a given length.
+		Pre-condition:	Takes the message length, 1 to MAX_LENGTH.
+		Post-condition:	Returns OK if encrypt and decrypt may be used for messages of that length. Otherwise returns
+						EMPTY_INPUT, LENGTH_MISMATCH if the length is past MAX_LENGTH, or INVALID_PERMUTATION if a row
+						transposition does not order the full rows of the length, and nothing is compiled.
+		*/
+		CipherStatus compile(size_t);
+
+		/*
+		Purpose:		Encrypts lower case plaintext with the compiled pipeline.
+		Pre-condition:	Takes the plaintext and an output buffer of the same length. They may not overlap.
+		Post-condition:	Returns OK and output contains the ciphertext. Otherwise returns EMPTY_INPUT, LENGTH_MISMATCH if
+						the plaintext is not the length compiled for, or INVALID_CHARACTER.
+		*/
+		CipherStatus encrypt(std::string_view, char*) const;
+
+		/*
+		Purpose:		Decrypts lower case ciphertext with the compiled pipeline.
+		Pre-condition:	Takes the ciphertext and an output buffer of the same length. They may not overlap.
+		Post-condition:	Returns OK and output contains the plaintext. Otherwise returns the same as encrypt.
+		*/
+		CipherStatus decrypt(std::string_view, char*) const;
+
+		/*
+		Purpose:		Encrypts by running every stage in turn over the whole text, without compiling. It is far slower
+						and is kept to check the compiled pipeline against.
+		Pre-condition:	Takes lower case plaintext of any length and an output buffer of the same length.
+		Post-condition:	Returns OK and output contains the ciphertext. Otherwise returns EMPTY_INPUT, INVALID_CHARACTER
+						or INVALID_PERMUTATION if a row transposition does not fit the length.
+		*/
+		CipherStatus encryptByStage(std::string_view, char*) const;
+
+		/*
+		Purpose:		Decrypts by undoing every stage in turn, last stage first.
+		Pre-condition:	Takes lower case ciphertext of any length and an output buffer of the same length.
+		Post-condition:	Returns OK and output contains the plaintext. Otherwise returns the same as encryptByStage.
+		*/
+		CipherStatus decryptByStage(std::string_view, char*) const;
+
+		const std::vector<PipelineStage>& getStages() const;	//returns the stages of one round
+		size_t getRounds() const;	//returns the number of times the stages are run
+		size_t getLength() const;	//returns the length compiled for, 0 if not compiled
+		size_t getErrorLine() const;	//returns the line of the pipeline file load stopped at, 0 if none
+		bool isEngineCipher() const;	//returns true if the compiled pipeline runs through the kernels of CipherEngine
+
+		static constexpr size_t MAX_LENGTH = UINT32_MAX;	//longest message a pipeline can be compiled for
+	private:
+		//private data members
+		std::vector<PipelineStage> stages;	//stages of one round, in the order they run
+		size_t rounds;	//number of times the stages are run
+		size_t errorLine;	//line of the pipeline file load stopped at
+		size_t length;	//message length compiled for, 0 if not compiled
+		int keyNum;	//multiplier of the folded substitution
+		std::string plainStream;	//key letters of the folded substitution, by position of the plaintext
+		std::string cipherStream;	//the same key letters, by position of the ciphertext, empty for the engine cipher
+		std::vector<uint32_t> sources;	//position in the plaintext of each letter of the ciphertext
+		std::vector<uint32_t> targets;	//position in the ciphertext of each letter of the plaintext
+		std::vector<int> permutation;	//permutation of the one row transposition of the engine cipher
+		std::unique_ptr<Substitution> plainSubstitution;	//folded substitution read by position of the plaintext
+		std::unique_ptr<Substitution> cipherSubstitution;	//folded substitution read by position of the ciphertext
+		std::unique_ptr<Transposition> transposition;	//row transposition of the engine cipher, or nullptr
+
+		/*
+		Purpose:		Checks text handed to one of the ciphers.
+		Pre-condition:	Takes the text.
+		Post-condition:	Returns OK, EMPTY_INPUT or INVALID_CHARACTER.
+		*/
+		static CipherStatus validateText(std::string_view);
+};
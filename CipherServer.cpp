@@ -0,0 +1,719 @@
+/*
+Author:			My Tran
+Filename:		CipherServer.cpp
+Description:	This file implements the header file CipherServer.h providing the definitions for the methods of the
+CipherServer class using epoll on Linux. On other systems the service cannot listen.
+*/
+#include "CipherServer.h"
+#include "ByteOrder.h"
+#include "CipherEngine.h"
+#include<cerrno>
+#include<iterator>
+#include<thread>
+
+#ifdef __linux__
+#include<netinet/in.h>
+#include<netinet/tcp.h>
+#include<sys/epoll.h>
+#include<sys/eventfd.h>
+#include<sys/socket.h>
+#include<sys/stat.h>
+#include<sys/un.h>
+#include<unistd.h>
+#endif
+
+const size_t SIZE_BYTES = 4;	//bytes of the size every request and reply starts with
+const size_t REQUEST_HEADER_SIZE = 9;	//bytes of a request between its size and its text
+const size_t REPLY_HEADER_SIZE = 5;	//bytes of a reply between its size and its text
+const size_t MIN_PARALLEL_LETTERS = 1 << 14;	//smaller batches are run on the batch thread without waking the workers
+const size_t BATCH_GRAIN = 4;	//requests handed to a worker at once
+
+#ifdef __linux__
+const uint64_t LISTENER_EVENT = 0;	//epoll data of the listening socket
+const uint64_t WAKER_EVENT = 1;	//epoll data of the event that wakes the loop
+const uint64_t FIRST_CONNECTION = 2;	//number of the first connection, after the numbers above
+const int MAX_EVENTS = 256;	//most events taken from epoll at once
+const size_t READ_SIZE = 1 << 16;	//bytes read from a socket at once
+const size_t MAX_RUNNING_REQUESTS = 4096;	//requests of one connection in flight before it is no longer read
+const size_t MAX_WAITING_OUTPUT = 1 << 22;	//bytes of replies waiting for one connection before it is no longer read
+#endif
+
+//a client and the bytes waiting to be read from or written to it
+struct CipherServer::Connection
+{
+	uint64_t number = 0;	//number the connection is known by
+	int socket = -1;	//socket of the client
+	std::string input;	//bytes received that do not make a whole request yet
+	std::string output;	//replies waiting to be written
+	size_t running = 0;	//requests read whose replies are not in output yet
+	uint32_t interest = 0;	//events epoll watches the socket for
+	bool peerClosed = false;	//true once the client has finished sending
+};
+
+CipherServer::CipherServer(KeyStore& keys, size_t threads)
+	: keys(keys), pool(threads), stopping(false), requestCount(0), batchCount(0)
+{
+	nextConnection = 0;
+	batchStopping = false;
+	listener = -1;
+#ifdef __linux__
+	nextConnection = FIRST_CONNECTION;
+	poller = epoll_create1(EPOLL_CLOEXEC);
+	waker = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+	poller = -1;
+	waker = -1;
+#endif
+}
+
+size_t CipherServer::getRequestCount() const
+{
+	return requestCount.load();
+}
+
+size_t CipherServer::getBatchCount() const
+{
+	return batchCount.load();
+}
+
+void CipherServer::appendRequest(std::string& buffer, ServiceOperation operation, uint32_t keyId, uint32_t tag,
+	std::string_view text)
+{
+	char header[SIZE_BYTES + REQUEST_HEADER_SIZE];
+	ByteOrder::storeNumber(header, REQUEST_HEADER_SIZE + text.length(), SIZE_BYTES);
+	header[SIZE_BYTES] = (char)operation;
+	ByteOrder::storeNumber(header + SIZE_BYTES + 1, keyId, 4);
+	ByteOrder::storeNumber(header + SIZE_BYTES + 5, tag, 4);
+
+	buffer.append(header, sizeof(header));
+	buffer.append(text.data(), text.length());
+}
+
+size_t CipherServer::parseReply(const char* bytes, size_t size, ServiceReply& reply)
+{
+	if (size < SIZE_BYTES)
+	{
+		return 0;
+	}
+
+	size_t length = (size_t)ByteOrder::loadNumber(bytes, SIZE_BYTES);
+	if (size - SIZE_BYTES < length)
+	{
+		return 0;
+	}
+
+	//a reply too short to hold its header can only come from something other than the service
+	if (length < REPLY_HEADER_SIZE)
+	{
+		reply.status = CipherStatus::STREAM_ERROR;
+		reply.tag = 0;
+		reply.text = std::string_view();
+		return SIZE_BYTES + length;
+	}
+
+	reply.status = (CipherStatus)(unsigned char)bytes[SIZE_BYTES];
+	reply.tag = (uint32_t)ByteOrder::loadNumber(bytes + SIZE_BYTES + 1, 4);
+	reply.text = std::string_view(bytes + SIZE_BYTES + REPLY_HEADER_SIZE, length - REPLY_HEADER_SIZE);
+
+	return SIZE_BYTES + length;
+}
+
+void CipherServer::batchLoop()
+{
+	std::vector<Job> batch;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> guard(batchLock);
+			batchReady.wait(guard, [this] { return batchStopping || !queued.empty(); });
+
+			if (batchStopping)
+			{
+				return;
+			}
+
+			batch.swap(queued);
+		}
+
+		runBatch(batch);
+
+		{
+			std::lock_guard<std::mutex> guard(batchLock);
+			if (finished.empty())
+			{
+				finished.swap(batch);
+			}
+			else
+			{
+				finished.insert(finished.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+			}
+		}
+
+		batch.clear();
+
+#ifdef __linux__
+		//the loop is waiting on epoll, so it is woken through the event to write the replies
+		uint64_t one = 1;
+		if (write(waker, &one, sizeof(one)) < 0)
+		{
+			//the event only fails to count past its limit, when the loop has a wake up waiting anyway
+		}
+#endif
+	}
+}
+
+void CipherServer::runBatch(std::vector<Job>& batch)
+{
+	//schedules come from the shared cache, so every request of the batch with the same key and shape uses the same one
+	size_t letters = 0;
+	for (Job& job : batch)
+	{
+		job.status = keys.getSchedule(job.keyId, job.text.length(), job.schedule);
+		letters += job.text.length();
+	}
+
+	auto runJobs = [&batch](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			Job& job = batch[i];
+			if (job.status != CipherStatus::OK)
+			{
+				continue;
+			}
+
+			job.result.resize(job.text.length());
+
+			if (job.operation == ServiceOperation::ENCRYPT)
+			{
+				job.status = CipherEngine::encrypt(job.text, *job.schedule, &job.result[0]);
+			}
+			else
+			{
+				job.status = CipherEngine::decrypt(job.text, *job.schedule, &job.result[0]);
+			}
+
+			if (job.status != CipherStatus::OK)
+			{
+				job.result.clear();
+			}
+		}
+	};
+
+	//waking the workers costs more than a little work, which is quicker to run here
+	if (batch.size() == 1 || letters < MIN_PARALLEL_LETTERS)
+	{
+		runJobs(0, batch.size());
+	}
+	else
+	{
+		pool.parallelFor(batch.size(), BATCH_GRAIN, runJobs);
+	}
+
+	requestCount += batch.size();
+	batchCount++;
+}
+
+#ifdef __linux__
+CipherServer::~CipherServer()
+{
+	for (auto& entry : connections)
+	{
+		close(entry.second->socket);
+	}
+
+	if (listener >= 0)
+	{
+		close(listener);
+	}
+
+	if (!socketPath.empty())
+	{
+		unlink(socketPath.c_str());
+	}
+
+	if (poller >= 0)
+	{
+		close(poller);
+	}
+
+	if (waker >= 0)
+	{
+		close(waker);
+	}
+}
+
+bool CipherServer::listenLocal(const std::string& path)
+{
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+
+	if (path.empty() || path.length() >= sizeof(address.sun_path))
+	{
+		errno = ENAMETOOLONG;
+		return false;
+	}
+
+	path.copy(address.sun_path, path.length());
+
+	//a socket left behind by a service that did not shut down cleanly would keep the path taken, but any other kind of
+	//file is left alone and the bind below fails
+	struct stat status;
+	if (lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+	{
+		unlink(path.c_str());
+	}
+
+	listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (listener < 0 || bind(listener, (const sockaddr*)&address, sizeof(address)) < 0)
+	{
+		int error = errno;
+		if (listener >= 0)
+		{
+			close(listener);
+			listener = -1;
+		}
+		errno = error;
+		return false;
+	}
+
+	socketPath = path;
+
+	return startListening();
+}
+
+bool CipherServer::listenTcp(uint16_t port)
+{
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	//a restarted service can take the port again while connections of the last one are still closing
+	int reuse = 1;
+	if (listener < 0 || setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+		bind(listener, (const sockaddr*)&address, sizeof(address)) < 0)
+	{
+		int error = errno;
+		if (listener >= 0)
+		{
+			close(listener);
+			listener = -1;
+		}
+		errno = error;
+		return false;
+	}
+
+	return startListening();
+}
+
+bool CipherServer::startListening()
+{
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.u64 = LISTENER_EVENT;
+
+	if (poller < 0 || listen(listener, SOMAXCONN) < 0 || epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event) < 0)
+	{
+		int error = errno;
+		close(listener);
+		listener = -1;
+		errno = error;
+		return false;
+	}
+
+	return true;
+}
+
+bool CipherServer::run()
+{
+	epoll_event wake = {};
+	wake.events = EPOLLIN;
+	wake.data.u64 = WAKER_EVENT;
+
+	if (listener < 0 || waker < 0 || epoll_ctl(poller, EPOLL_CTL_ADD, waker, &wake) < 0)
+	{
+		return false;
+	}
+
+	batchStopping = false;
+	std::thread batcher(&CipherServer::batchLoop, this);
+	bool waited = true;
+	epoll_event events[MAX_EVENTS];
+
+	while (!stopping.load())
+	{
+		int ready = epoll_wait(poller, events, MAX_EVENTS, -1);
+		if (ready < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			waited = false;
+			break;
+		}
+
+		for (int i = 0; i < ready; i++)
+		{
+			uint64_t number = events[i].data.u64;
+
+			if (number == LISTENER_EVENT)
+			{
+				acceptClients();
+				continue;
+			}
+
+			if (number == WAKER_EVENT)
+			{
+				uint64_t count = 0;
+				if (read(waker, &count, sizeof(count)) == sizeof(count))
+				{
+					deliverReplies();
+				}
+				continue;
+			}
+
+			//an earlier event of this round may have closed the connection already
+			auto found = connections.find(number);
+			if (found == connections.end())
+			{
+				continue;
+			}
+
+			Connection& connection = *found->second;
+			uint32_t happened = events[i].events;
+
+			//once the client has gone entirely there is no one to reply to
+			bool open = (happened & (EPOLLERR | EPOLLHUP)) == 0;
+
+			if (open && (happened & EPOLLIN) != 0)
+			{
+				open = readRequests(connection);
+			}
+
+			if (open && (happened & EPOLLOUT) != 0)
+			{
+				open = writeReplies(connection);
+			}
+
+			if (!open || !updateInterest(connection))
+			{
+				closeConnection(number);
+			}
+		}
+
+		//everything read in this round goes to the batch thread together, and joins the batch after the one running
+		if (!received.empty())
+		{
+			{
+				std::lock_guard<std::mutex> guard(batchLock);
+				if (queued.empty())
+				{
+					queued.swap(received);
+				}
+				else
+				{
+					queued.insert(queued.end(), std::make_move_iterator(received.begin()), std::make_move_iterator(received.end()));
+				}
+			}
+
+			received.clear();
+			batchReady.notify_one();
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(batchLock);
+		batchStopping = true;
+	}
+
+	batchReady.notify_one();
+	batcher.join();
+
+	epoll_ctl(poller, EPOLL_CTL_DEL, waker, nullptr);
+	received.clear();
+	queued.clear();
+	finished.clear();
+
+	return waited;
+}
+
+void CipherServer::stop()
+{
+	stopping.store(true);
+
+	//write is safe to call from a signal handler, where most of the service is not
+	uint64_t one = 1;
+	if (waker >= 0 && write(waker, &one, sizeof(one)) < 0)
+	{
+		//the event only fails to count past its limit, when the loop has a wake up waiting anyway
+	}
+}
+
+void CipherServer::acceptClients()
+{
+	while (true)
+	{
+		int client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (client < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return;
+		}
+
+		//replies are small and written whole, so waiting to fill a packet would only add latency
+		if (socketPath.empty())
+		{
+			int noDelay = 1;
+			setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		}
+
+		std::unique_ptr<Connection> connection(new Connection());
+		connection->number = nextConnection;
+		connection->socket = client;
+		connection->interest = EPOLLIN;
+
+		epoll_event event = {};
+		event.events = connection->interest;
+		event.data.u64 = nextConnection;
+
+		if (epoll_ctl(poller, EPOLL_CTL_ADD, client, &event) < 0)
+		{
+			close(client);
+			continue;
+		}
+
+		connections[nextConnection++] = std::move(connection);
+	}
+}
+
+bool CipherServer::readRequests(Connection& connection)
+{
+	char buffer[READ_SIZE];
+
+	while (true)
+	{
+		ssize_t got = recv(connection.socket, buffer, sizeof(buffer), 0);
+
+		if (got > 0)
+		{
+			connection.input.append(buffer, (size_t)got);
+
+			//a short read means the socket is empty, which saves a call that would only say so
+			if ((size_t)got < sizeof(buffer))
+			{
+				break;
+			}
+		}
+		else if (got == 0)
+		{
+			connection.peerClosed = true;
+			break;
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			break;
+		}
+		else if (errno != EINTR)
+		{
+			return false;
+		}
+	}
+
+	size_t used = 0;
+	while (connection.input.length() - used >= SIZE_BYTES)
+	{
+		const char* request = connection.input.data() + used;
+		size_t length = (size_t)ByteOrder::loadNumber(request, SIZE_BYTES);
+
+		if (length < REQUEST_HEADER_SIZE || length - REQUEST_HEADER_SIZE > MAX_TEXT_LENGTH)
+		{
+			return false;
+		}
+
+		if (connection.input.length() - used - SIZE_BYTES < length)
+		{
+			break;
+		}
+
+		ServiceOperation operation = (ServiceOperation)request[SIZE_BYTES];
+		if (operation != ServiceOperation::ENCRYPT && operation != ServiceOperation::DECRYPT)
+		{
+			return false;
+		}
+
+		Job job;
+		job.connection = connection.number;
+		job.operation = operation;
+		job.keyId = (uint32_t)ByteOrder::loadNumber(request + SIZE_BYTES + 1, 4);
+		job.tag = (uint32_t)ByteOrder::loadNumber(request + SIZE_BYTES + 5, 4);
+		job.text.assign(request + SIZE_BYTES + REQUEST_HEADER_SIZE, length - REQUEST_HEADER_SIZE);
+		job.status = CipherStatus::OK;
+
+		received.push_back(std::move(job));
+		connection.running++;
+		used += SIZE_BYTES + length;
+	}
+
+	connection.input.erase(0, used);
+
+	return true;
+}
+
+bool CipherServer::writeReplies(Connection& connection)
+{
+	size_t sent = 0;
+
+	while (sent < connection.output.length())
+	{
+		//the client may have gone, which must close the connection rather than raise SIGPIPE
+		ssize_t wrote = send(connection.socket, connection.output.data() + sent, connection.output.length() - sent, MSG_NOSIGNAL);
+
+		if (wrote > 0)
+		{
+			sent += (size_t)wrote;
+		}
+		else if (wrote < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		else if (wrote == 0 || errno != EINTR)
+		{
+			return false;
+		}
+	}
+
+	connection.output.erase(0, sent);
+
+	return true;
+}
+
+void CipherServer::deliverReplies()
+{
+	std::vector<Job> done;
+	{
+		std::lock_guard<std::mutex> guard(batchLock);
+		done.swap(finished);
+	}
+
+	std::vector<uint64_t> touched;
+
+	for (Job& job : done)
+	{
+		auto found = connections.find(job.connection);
+		if (found == connections.end())
+		{
+			continue;
+		}
+
+		Connection& connection = *found->second;
+		size_t length = (job.status == CipherStatus::OK) ? job.result.length() : 0;
+
+		char header[SIZE_BYTES + REPLY_HEADER_SIZE];
+		ByteOrder::storeNumber(header, REPLY_HEADER_SIZE + length, SIZE_BYTES);
+		header[SIZE_BYTES] = (char)job.status;
+		ByteOrder::storeNumber(header + SIZE_BYTES + 1, job.tag, 4);
+
+		connection.output.append(header, sizeof(header));
+		connection.output.append(job.result.data(), length);
+		connection.running--;
+
+		//the replies of one connection usually sit together in a batch
+		if (touched.empty() || touched.back() != job.connection)
+		{
+			touched.push_back(job.connection);
+		}
+	}
+
+	for (uint64_t number : touched)
+	{
+		auto found = connections.find(number);
+		if (found == connections.end())
+		{
+			continue;
+		}
+
+		if (!writeReplies(*found->second) || !updateInterest(*found->second))
+		{
+			closeConnection(number);
+		}
+	}
+}
+
+bool CipherServer::updateInterest(Connection& connection)
+{
+	bool writing = !connection.output.empty();
+
+	//a client that sends faster than it reads its replies is not read again until it catches up
+	bool reading = !connection.peerClosed && connection.running < MAX_RUNNING_REQUESTS &&
+		connection.output.length() < MAX_WAITING_OUTPUT;
+
+	//a client that has finished sending is closed once every one of its replies is written
+	if (connection.peerClosed && connection.running == 0 && !writing)
+	{
+		return false;
+	}
+
+	uint32_t interest = (reading ? (uint32_t)EPOLLIN : 0) | (writing ? (uint32_t)EPOLLOUT : 0);
+	if (interest == connection.interest)
+	{
+		return true;
+	}
+
+	epoll_event event = {};
+	event.events = interest;
+	event.data.u64 = connection.number;
+	connection.interest = interest;
+
+	return epoll_ctl(poller, EPOLL_CTL_MOD, connection.socket, &event) == 0;
+}
+
+void CipherServer::closeConnection(uint64_t number)
+{
+	auto found = connections.find(number);
+	if (found == connections.end())
+	{
+		return;
+	}
+
+	//closing the socket also takes it out of epoll
+	close(found->second->socket);
+	connections.erase(found);
+}
+#else
+CipherServer::~CipherServer()
+{
+}
+
+bool CipherServer::listenLocal(const std::string&)
+{
+	errno = ENOSYS;
+	return false;
+}
+
+bool CipherServer::listenTcp(uint16_t)
+{
+	errno = ENOSYS;
+	return false;
+}
+
+bool CipherServer::run()
+{
+	errno = ENOSYS;
+	return false;
+}
+
+void CipherServer::stop()
+{
+	stopping.store(true);
+}
+#endif
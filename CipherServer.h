@@ -0,0 +1,218 @@
+/*
+Author:			My Tran
+Filename:		CipherServer.h
+Description:	This file provides the declarations of the CipherServer class. CipherServer runs the cipher as a long
+lived service on a Unix domain socket or a TCP port of the local machine, with keys from a KeyStore, so a job no longer
+starts a program of its own. A single thread waits on every connection with epoll, reads requests as they arrive and
+writes replies as the sockets take them, never blocking on any one client. Requests are collected into batches, and
+while the workers run one batch every request that arrives meanwhile joins the next, so under load many small requests
+are handed to the workers together. Requests of a batch that use the same key and message shape share one schedule from
+the KeyStore cache. The service is only available on Linux.
+
+Protocol:	Every number is stored little endian. A connection carries any number of requests, which may be sent
+without waiting for the replies before them, and the replies come back in the order the requests were sent.
+
+	request	size of the rest of the request (4 bytes), operation (1 byte, 1 to encrypt, 2 to decrypt), key id (4 bytes),
+			tag (4 bytes, returned in the reply), followed by lower case text
+	reply	size of the rest of the reply (4 bytes), status (1 byte, the value of a CipherStatus), tag (4 bytes),
+			followed by the result if the status is OK
+
+A request that cannot be read, such as one with an unknown operation or longer than MAX_TEXT_LENGTH letters, closes
+its connection, since the requests after it cannot be found.
+*/
+#pragma once
+#include<atomic>
+#include<condition_variable>
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<mutex>
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<vector>
+#include "KeyStore.h"
+#include "ThreadPool.h"
+
+//what a request asks the service to do
+enum class ServiceOperation : unsigned char
+{
+	ENCRYPT = 1,	//encrypt the text
+	DECRYPT = 2	//decrypt the text
+};
+
+//a reply read back from the service
+struct ServiceReply
+{
+	CipherStatus status = CipherStatus::OK;	//outcome of the request
+	uint32_t tag = 0;	//tag of the request the reply is for
+	std::string_view text;	//result, empty unless the status is OK
+};
+
+class CipherServer
+{
+	public:
+		/*
+		Purpose:		Creates a service that is not listening yet.
+		Pre-condition:	Takes the keys requests may name, which must outlive the service, and the number of worker
+						threads, or 0 for one per hardware thread.
+		Post-condition:	None
+		*/
+		CipherServer(KeyStore&, size_t = 0);
+
+		/*
+		Purpose:		Closes every connection and the listening socket.
+		Pre-condition:	run has returned.
+		Post-condition:	A Unix domain socket made by listenLocal is removed.
+		*/
+		~CipherServer();
+
+		CipherServer(const CipherServer&) = delete;
+		CipherServer& operator=(const CipherServer&) = delete;
+
+		/*
+		Purpose:		Listens on a Unix domain socket.
+		Pre-condition:	Takes the path of the socket. A socket left behind at the path by an earlier run is replaced.
+		Post-condition:	Returns true if the service is listening. False otherwise, and errno tells why.
+		*/
+		bool listenLocal(const std::string&);
+
+		/*
+		Purpose:		Listens on a TCP port of the loopback address, so only the local machine can connect.
+		Pre-condition:	Takes the port.
+		Post-condition:	Returns true if the service is listening. False otherwise, and errno tells why.
+		*/
+		bool listenTcp(uint16_t);
+
+		/*
+		Purpose:		Serves connections until stop is called.
+		Pre-condition:	listenLocal or listenTcp succeeded.
+		Post-condition:	Returns true once stopped. False if the service could not wait on its sockets, and errno tells why.
+						Requests still waiting when it stops are dropped.
+		*/
+		bool run();
+
+		/*
+		Purpose:		Asks run to return.
+		Pre-condition:	None. It may be called from any thread or from a signal handler.
+		Post-condition:	run returns soon after.
+		*/
+		void stop();
+
+		size_t getRequestCount() const;	//returns the number of requests answered
+		size_t getBatchCount() const;	//returns the number of batches the requests were answered in
+
+		/*
+		Purpose:		Adds a request to the bytes to send to the service.
+		Pre-condition:	Takes the buffer, the operation, the number identifying the key, the tag and the text.
+		Post-condition:	The request is appended to the buffer.
+		*/
+		static void appendRequest(std::string&, ServiceOperation, uint32_t, uint32_t, std::string_view);
+
+		/*
+		Purpose:		Reads a reply from the bytes received from the service.
+		Pre-condition:	Takes the bytes, their number and where to store the reply.
+		Post-condition:	Returns the number of bytes the reply took and stores it, with the text as a view into the bytes.
+						Returns 0 if the reply is not complete yet.
+		*/
+		static size_t parseReply(const char*, size_t, ServiceReply&);
+
+		static constexpr size_t MAX_TEXT_LENGTH = 1 << 24;	//longest text a request may carry
+	private:
+		struct Connection;	//a client and the bytes waiting to be read from or written to it
+
+		//a request on its way through the workers
+		struct Job
+		{
+			uint64_t connection;	//number of the connection the request came in on
+			uint32_t tag;	//tag of the request
+			uint32_t keyId;	//number of the key the request names
+			ServiceOperation operation;	//what the request asks for
+			std::string text;	//text of the request
+			std::string result;	//result, once the job has run
+			CipherStatus status;	//outcome, once the job has run
+			std::shared_ptr<const KeySchedule> schedule;	//schedule of the key for the length of the text
+		};
+
+		//private data members
+		KeyStore& keys;	//keys requests may name
+		ThreadPool pool;	//workers the batches run on
+		std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections;	//open connections, by number
+		std::vector<Job> received;	//requests read since the last batch was handed over
+		std::vector<Job> queued;	//requests waiting for the next batch
+		std::vector<Job> finished;	//requests whose batch has run, waiting for their replies to be written
+		std::mutex batchLock;	//guards queued, finished and batchStopping
+		std::condition_variable batchReady;	//signalled when requests are queued or the batches stop
+		std::string socketPath;	//path of the Unix domain socket, empty for TCP
+		std::atomic<bool> stopping;	//true once stop has been called
+		std::atomic<size_t> requestCount;	//requests answered
+		std::atomic<size_t> batchCount;	//batches run
+		uint64_t nextConnection;	//number given to the next connection accepted
+		bool batchStopping;	//true once the batch thread is told to finish
+		int listener;	//listening socket
+		int poller;	//epoll instance every socket is watched with
+		int waker;	//event the batch thread and stop use to wake the loop
+
+		/*
+		Purpose:		Runs the batches handed over by the event loop until told to finish.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		void batchLoop();
+
+		/*
+		Purpose:		Runs a batch of requests on the workers.
+		Pre-condition:	Takes the batch.
+		Post-condition:	Every job holds its status and result.
+		*/
+		void runBatch(std::vector<Job>&);
+
+		/*
+		Purpose:		Accepts every client waiting on the listening socket.
+		Pre-condition:	None
+		Post-condition:	The clients are added to the connections.
+		*/
+		void acceptClients();
+
+		/*
+		Purpose:		Reads what a client has sent and turns every complete request into a job.
+		Pre-condition:	Takes the connection.
+		Post-condition:	Returns false if the connection should be closed.
+		*/
+		bool readRequests(Connection&);
+
+		/*
+		Purpose:		Writes as much of the waiting replies as the socket takes.
+		Pre-condition:	Takes the connection.
+		Post-condition:	Returns false if the connection should be closed.
+		*/
+		bool writeReplies(Connection&);
+
+		/*
+		Purpose:		Appends the replies of every finished job to their connections and writes them.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		void deliverReplies();
+
+		/*
+		Purpose:		Watches a connection for reading while it is not too far behind, and for writing while replies wait.
+		Pre-condition:	Takes the connection.
+		Post-condition:	Returns false if the connection should be closed.
+		*/
+		bool updateInterest(Connection&);
+
+		/*
+		Purpose:		Closes a connection and forgets it. Replies of its requests still running are dropped.
+		Pre-condition:	Takes the number of the connection.
+		Post-condition:	None
+		*/
+		void closeConnection(uint64_t);
+
+		/*
+		Purpose:		Makes the listening socket nonblocking and starts listening.
+		Pre-condition:	The socket is bound.
+		Post-condition:	Returns true if the service is listening.
+		*/
+		bool startListening();
+};
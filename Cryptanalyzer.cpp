@@ -0,0 +1,1286 @@
+/*
+Author:			My Tran
+Filename:		Cryptanalyzer.cpp
+Description:	This file implements the header file Cryptanalyzer.h providing the definitions for the methods of the
+Cryptanalyzer class.
+*/
+#include "Cryptanalyzer.h"
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cmath>
+#include<cstdint>
+#include<limits>
+#include<map>
+#include<mutex>
+#include<numeric>
+#include<random>
+
+const int ALPHABET_SIZE = SUBSTITUTION_ALPHABET_SIZE;	//number of letters the cipher operates on
+const int KEY_NUMS[] = { 1, 3, 5, 7, 9, 11, 15, 17, 19, 21, 23, 25 };	//every keyNum the affine cipher accepts
+const size_t MIN_CLASS_LETTERS = 4;	//fewest letters per key letter a period must leave to be tried
+const double IMPROVEMENT = 1e-6;	//smallest change in score a swap must make to be taken
+const size_t MAX_REFINEMENTS = 8;	//most times the key letters are solved again after the rows are put in order
+const double KEPT_COINCIDENCE = 0.25;	//periods within this share of the best index's lead over random text are kept
+const size_t KEY_NUM_COUNT = sizeof(KEY_NUMS) / sizeof(KEY_NUMS[0]);	//number of keyNums, summed side by side in an audit
+const size_t AUDIT_GRAIN = 1024;	//fewest phrases a worker scores at once in an audit
+const size_t AUDIT_TABLE_SCORES = 1 << 16;	//most scores held for a block of row orders in an audit, few enough to stay in cache
+const size_t AUDIT_KEPT_MATCHES = 1024;	//fewest of the best matches of an audit kept for decrypting, beyond resultCount
+
+//the ciphertext read back into rows without reordering them
+struct RowLayout
+{
+	size_t length = 0;	//number of letters
+	size_t matrixSize = 0;	//letters in a full row
+	size_t fullRows = 0;	//rows the permutation reorders
+	size_t bottomLength = 0;	//letters in the bottom row, which is never reordered
+	std::string rows;	//the rows as stacked by the key one after another, bottom row last
+};
+
+//one period measured by the index of coincidence
+struct PeriodResult
+{
+	double score = -1;	//sum over the key letters of each letter count times one less than it
+	std::vector<int> order;	//row placed at each position of the best assignment found
+	size_t candidates = 0;	//assignments scored
+};
+
+//a key whose letters were solved or taken from a candidate phrase, waiting for its rows to be put in order
+struct KeyCandidate
+{
+	size_t period = 0;	//length of the key phrase
+	int keyNum = 0;	//a of C = (aP + b)
+	std::string key;	//key letters, one per position of the period
+	double letterScore = 0;	//average log probability of a letter of the plaintext
+	std::vector<int> order;	//row placed at each position, from the period's assignment
+};
+
+//a key of an audit whose plaintext reached the threshold
+struct AuditMatch
+{
+	size_t phrase = 0;	//number of the phrase in the list
+	size_t order = 0;	//number of the row order
+	int keyNum = 0;	//a of C = (aP + b)
+	float score = 0;	//sum of the log probabilities of the plaintext letters
+};
+
+//a search over the order of the rows
+struct OrderResult
+{
+	double score = 0;	//score of the best order found
+	std::vector<int> order;	//the best order found
+	size_t candidates = 0;	//orders scored
+};
+
+/*
+Purpose:		Reads the ciphertext back into rows in the order they were stacked, which leaves every row's letters in
+				order.
+Pre-condition:	Takes lower case ciphertext.
+Post-condition:	Returns the rows.
+*/
+static RowLayout makeLayout(std::string_view ciphertext)
+{
+	RowLayout layout;
+	layout.length = ciphertext.length();
+	layout.matrixSize = Transposition::calcMatrixSize(layout.length);
+	layout.fullRows = Transposition::calcOccupiedRows(layout.length) - 1;
+	layout.bottomLength = layout.length - layout.fullRows * layout.matrixSize;
+	layout.rows.resize(layout.length);
+
+	std::vector<int> identity(layout.fullRows);
+	std::iota(identity.begin(), identity.end(), 0);
+	Transposition(layout.length, identity).untranspose(ciphertext.data(), &layout.rows[0]);
+
+	return layout;
+}
+
+/*
+Purpose:		Gives the greatest common divisor of two numbers.
+Pre-condition:	Takes the numbers, not both 0.
+Post-condition:	Returns the divisor.
+*/
+static size_t calcDivisor(size_t a, size_t b)
+{
+	while (b != 0)
+	{
+		size_t rest = a % b;
+		a = b;
+		b = rest;
+	}
+
+	return a;
+}
+
+/*
+Purpose:		Determines if every order of some rows can be tried.
+Pre-condition:	Takes the number of rows and the most orders allowed.
+Post-condition:	Returns true if the factorial of the rows is no more than the limit.
+*/
+static bool isEnumerable(size_t rows, size_t limit)
+{
+	size_t orders = 1;
+
+	for (size_t i = 2; i <= rows; i++)
+	{
+		if (orders > limit / i)
+		{
+			return false;
+		}
+		orders *= i;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Gives the number of positions whose rows share the same key letters. Position i starts at key letter
+				(i * matrixSize) mod period, which repeats every period / gcd(matrixSize, period) positions.
+Pre-condition:	Takes the matrix size and the period.
+Post-condition:	Returns the number of distinct starting key letters.
+*/
+static size_t calcResidues(size_t matrixSize, size_t period)
+{
+	return period / calcDivisor(matrixSize, period);
+}
+
+/*
+Purpose:		Moves every row to a position whose starting key letter is shift residues further along, keeping the rows
+				of each residue in the same order. Since the index of coincidence barely changes when every key letter is
+				relabelled, an assignment may be found in any of these rotations and only the bottom row tells them apart.
+Pre-condition:	Takes the order, the number of residues and the shift.
+Post-condition:	Returns the rotated order.
+*/
+static std::vector<int> rotateResidues(const std::vector<int>& order, size_t residues, size_t shift)
+{
+	std::vector<int> rotated(order.size(), -1);
+	std::vector<int> leftover;
+
+	for (size_t r = 0; r < residues; r++)
+	{
+		size_t target = (r + shift) % residues;
+		size_t i = r;
+		size_t j = target;
+
+		for (; i < order.size() && j < order.size(); i += residues, j += residues)
+		{
+			rotated[j] = order[i];
+		}
+		for (; i < order.size(); i += residues)
+		{
+			leftover.push_back(order[i]);
+		}
+	}
+
+	//residues of different sizes leave a few rows over, which fill the positions left empty
+	for (size_t i = 0, next = 0; i < rotated.size(); i++)
+	{
+		if (rotated[i] < 0)
+		{
+			rotated[i] = leftover[next++];
+		}
+	}
+
+	return rotated;
+}
+
+//scores an assignment of rows to positions by how alike the letters sharing each key letter are
+class CoincidenceObjective
+{
+	public:
+		CoincidenceObjective(const RowLayout& layout, size_t period)
+			: layout(layout), period(period), rowCounts(layout.fullRows * period * ALPHABET_SIZE, 0),
+			bottomCounts(period * ALPHABET_SIZE, 0), counts(period * ALPHABET_SIZE, 0)
+		{
+			for (size_t k = 0; k < layout.fullRows; k++)
+			{
+				for (size_t c = 0; c < layout.matrixSize; c++)
+				{
+					rowCounts[((k * period) + (c % period)) * ALPHABET_SIZE + (layout.rows[k * layout.matrixSize + c] - 'a')]++;
+				}
+			}
+
+			size_t bottomStart = layout.fullRows * layout.matrixSize;
+			for (size_t c = 0; c < layout.bottomLength; c++)
+			{
+				bottomCounts[((bottomStart + c) % period) * ALPHABET_SIZE + (layout.rows[bottomStart + c] - 'a')]++;
+			}
+		}
+
+		//recounts the letters of every key letter for an order and returns its score
+		double reset(const std::vector<int>& order)
+		{
+			counts = bottomCounts;
+
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				const int* row = &rowCounts[order[i] * period * ALPHABET_SIZE];
+				size_t start = getStart(i);
+
+				for (size_t j = 0; j < period; j++)
+				{
+					int* total = &counts[((start + j) % period) * ALPHABET_SIZE];
+					for (int l = 0; l < ALPHABET_SIZE; l++)
+					{
+						total[l] += row[j * ALPHABET_SIZE + l];
+					}
+				}
+			}
+
+			int64_t score = 0;
+			for (int count : counts)
+			{
+				score += (int64_t)count * (count - 1);
+			}
+
+			return (double)score;
+		}
+
+		//returns the change in score of swapping the rows at two positions
+		double swapDelta(std::vector<int>& order, size_t i, size_t j) const
+		{
+			return (double)visitSwap(order, i, j, nullptr);
+		}
+
+		//swaps the rows at two positions
+		void swap(std::vector<int>& order, size_t i, size_t j)
+		{
+			visitSwap(order, i, j, counts.data());
+			std::swap(order[i], order[j]);
+		}
+
+		//returns the index of coincidence of the last order counted, about 0.066 for English and 0.038 for random text
+		double getIndex() const
+		{
+			int64_t pairs = 0;
+			int64_t alike = 0;
+
+			for (size_t q = 0; q < period; q++)
+			{
+				int64_t letters = 0;
+				for (int l = 0; l < ALPHABET_SIZE; l++)
+				{
+					int64_t count = counts[q * ALPHABET_SIZE + l];
+					letters += count;
+					alike += count * (count - 1);
+				}
+				pairs += letters * (letters - 1);
+			}
+
+			return (pairs > 0) ? (double)alike / pairs : 0;
+		}
+
+		const std::vector<int>& getCounts() const	//returns the count of each ciphertext letter under each key letter
+		{
+			return counts;
+		}
+	private:
+		const RowLayout& layout;	//ciphertext rows
+		size_t period;	//length of the key phrase
+		std::vector<int> rowCounts;	//[row][column mod period][letter] counts of each full row
+		std::vector<int> bottomCounts;	//[key letter][letter] counts of the bottom row
+		std::vector<int> counts;	//[key letter][letter] counts of the last order
+
+		size_t getStart(size_t position) const	//returns the key letter of the first column of a position
+		{
+			return (position * layout.matrixSize) % period;
+		}
+
+		//works out the change in score of swapping the rows at two positions, and adds the change in counts to total if given
+		int64_t visitSwap(const std::vector<int>& order, size_t i, size_t j, int* total) const
+		{
+			size_t startI = getStart(i);
+			size_t startJ = getStart(j);
+			if (startI == startJ)
+			{
+				return 0;
+			}
+
+			const int* rowI = &rowCounts[order[i] * period * ALPHABET_SIZE];
+			const int* rowJ = &rowCounts[order[j] * period * ALPHABET_SIZE];
+			int64_t delta = 0;
+
+			for (size_t q = 0; q < period; q++)
+			{
+				//the row at i moves from start i to start j and the row at j the other way
+				const int* leavingI = rowI + ((q + period - startI) % period) * ALPHABET_SIZE;
+				const int* arrivingI = rowI + ((q + period - startJ) % period) * ALPHABET_SIZE;
+				const int* leavingJ = rowJ + ((q + period - startJ) % period) * ALPHABET_SIZE;
+				const int* arrivingJ = rowJ + ((q + period - startI) % period) * ALPHABET_SIZE;
+				const int* current = &counts[q * ALPHABET_SIZE];
+
+				for (int l = 0; l < ALPHABET_SIZE; l++)
+				{
+					int64_t change = (int64_t)arrivingI[l] - leavingI[l] + arrivingJ[l] - leavingJ[l];
+					delta += change * (2 * (int64_t)current[l] + change - 1);
+
+					if (total != nullptr)
+					{
+						total[q * ALPHABET_SIZE + l] += (int)change;
+					}
+				}
+			}
+
+			return delta;
+		}
+};
+
+//scores an order of the rows by the letter triples of the plaintext a fixed key gives
+class JoinObjective
+{
+	public:
+		JoinObjective(const RowLayout& layout, const LanguageModel& model, const KeyCandidate& candidate)
+			: model(model), residues(calcResidues(layout.matrixSize, candidate.period)), rows(layout.fullRows * residues)
+		{
+			//each row is decrypted once for every starting key letter it could be given
+			int keyNumInverse = CipherEngine::calcModInverse(candidate.keyNum);
+			std::vector<int> letters(layout.matrixSize);
+
+			for (size_t k = 0; k <= layout.fullRows; k++)
+			{
+				bool bottom = (k == layout.fullRows);
+				size_t rowLength = bottom ? layout.bottomLength : layout.matrixSize;
+
+				for (size_t r = 0; r < (bottom ? 1 : residues); r++)
+				{
+					size_t position = bottom ? layout.fullRows : r;
+					size_t start = (position * layout.matrixSize) % candidate.period;
+					RowEnds& ends = bottom ? bottomRow : rows[k * residues + r];
+
+					for (size_t c = 0; c < rowLength; c++)
+					{
+						int b = candidate.key[(start + c) % candidate.period] - 'a';
+						int x = layout.rows[k * layout.matrixSize + c] - 'a';
+						letters[c] = (keyNumInverse * (x - b + ALPHABET_SIZE)) % ALPHABET_SIZE;
+						ends.inner += (c >= 2) ? model.getTripleScore(letters[c - 2], letters[c - 1], letters[c]) : 0;
+					}
+
+					//full rows hold at least two letters whenever there are any to reorder, the bottom row may hold one
+					ends.first = (rowLength > 0) ? letters[0] : -1;
+					ends.second = (rowLength > 1) ? letters[1] : -1;
+					ends.secondLast = (rowLength > 1) ? letters[rowLength - 2] : -1;
+					ends.last = (rowLength > 0) ? letters[rowLength - 1] : -1;
+				}
+			}
+		}
+
+		//returns the score of an order
+		double reset(const std::vector<int>& order)
+		{
+			double score = bottomRow.inner;
+
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				score += getRow(order, i).inner + getJoin(order, i);
+			}
+
+			return score;
+		}
+
+		//returns the change in score of swapping the rows at two positions, which only touches the joins beside them
+		double swapDelta(std::vector<int>& order, size_t i, size_t j) const
+		{
+			double before = getLocal(order, i, j);
+			std::swap(order[i], order[j]);
+			double after = getLocal(order, i, j);
+			std::swap(order[i], order[j]);
+
+			return after - before;
+		}
+
+		//swaps the rows at two positions
+		void swap(std::vector<int>& order, size_t i, size_t j)
+		{
+			std::swap(order[i], order[j]);
+		}
+	private:
+		//what a decrypted row adds to the score on its own and the letters it offers to its neighbours
+		struct RowEnds
+		{
+			float inner = 0;	//score of the triples inside the row
+			int first = -1;	//first plaintext letter, -1 if there is none
+			int second = -1;	//second plaintext letter, -1 if there is none
+			int secondLast = -1;	//second to last plaintext letter, -1 if there is none
+			int last = -1;	//last plaintext letter, -1 if there is none
+		};
+
+		const LanguageModel& model;	//letter triple scores
+		size_t residues;	//distinct starting key letters of the positions
+		std::vector<RowEnds> rows;	//[row][residue] each full row decrypted from each starting key letter
+		RowEnds bottomRow;	//the bottom row, decrypted from its own position
+
+		const RowEnds& getRow(const std::vector<int>& order, size_t position) const	//returns the row placed at a position
+		{
+			return rows[order[position] * residues + position % residues];
+		}
+
+		//returns the score of the triples spanning position t and the next one, or the bottom row after the last
+		double getJoin(const std::vector<int>& order, size_t t) const
+		{
+			const RowEnds& before = getRow(order, t);
+			const RowEnds& after = (t + 1 < order.size()) ? getRow(order, t + 1) : bottomRow;
+			double score = 0;
+
+			if (after.first >= 0)
+			{
+				score += model.getTripleScore(before.secondLast, before.last, after.first);
+			}
+			if (after.second >= 0)
+			{
+				score += model.getTripleScore(before.last, after.first, after.second);
+			}
+
+			return score;
+		}
+
+		//returns the part of the score two positions take part in
+		double getLocal(const std::vector<int>& order, size_t i, size_t j) const
+		{
+			double score = getRow(order, i).inner + getRow(order, j).inner;
+			size_t joins[] = { i - 1, i, j - 1, j };
+
+			for (size_t n = 0; n < 4; n++)
+			{
+				bool repeated = false;
+				for (size_t m = 0; m < n; m++)
+				{
+					repeated = repeated || (joins[m] == joins[n]);
+				}
+
+				//i - 1 wraps around to a huge number when i is 0 and is left out with the positions past the end
+				if (!repeated && joins[n] < order.size())
+				{
+					score += getJoin(order, joins[n]);
+				}
+			}
+
+			return score;
+		}
+};
+
+/*
+Purpose:		Searches for the order of the rows with the highest score, trying every order if there are few enough
+				and otherwise swapping pairs of rows while any swap helps, from several starts.
+Pre-condition:	Takes the objective, the starting order, whether to try every order, the number of starts, the random
+				generator, and a check that is told the best score after each start and returns false to stop early.
+Post-condition:	Returns the best order, its score and the number of orders scored.
+*/
+template<class Objective, class Check>
+static OrderResult searchOrder(Objective& objective, std::vector<int> order, bool enumerating, size_t restarts,
+	std::mt19937& random, const Check& keepGoing)
+{
+	OrderResult result;
+	result.order = order;
+	result.score = objective.reset(order);
+	result.candidates = 1;
+
+	if (order.size() < 2)
+	{
+		return result;
+	}
+
+	if (enumerating)
+	{
+		//Heap's algorithm reaches every order by swapping one pair at a time, so each is scored from the one before
+		std::vector<size_t> counters(order.size(), 0);
+		double score = result.score;
+
+		for (size_t i = 1; i < order.size();)
+		{
+			if (counters[i] < i)
+			{
+				size_t j = (i % 2 == 0) ? 0 : counters[i];
+				score += objective.swapDelta(order, j, i);
+				objective.swap(order, j, i);
+				result.candidates++;
+
+				if (score > result.score + IMPROVEMENT)
+				{
+					result.score = score;
+					result.order = order;
+				}
+
+				counters[i]++;
+				i = 1;
+			}
+			else
+			{
+				counters[i] = 0;
+				i++;
+			}
+		}
+
+		result.score = objective.reset(result.order);
+		return result;
+	}
+
+	for (size_t start = 0; start < restarts; start++)
+	{
+		if (start > 0)
+		{
+			std::shuffle(order.begin(), order.end(), random);
+		}
+
+		double score = objective.reset(order);
+		result.candidates++;
+
+		for (bool improved = true; improved;)
+		{
+			improved = false;
+
+			for (size_t i = 0; i + 1 < order.size(); i++)
+			{
+				for (size_t j = i + 1; j < order.size(); j++)
+				{
+					double delta = objective.swapDelta(order, i, j);
+					result.candidates++;
+
+					if (delta > IMPROVEMENT)
+					{
+						objective.swap(order, i, j);
+						score += delta;
+						improved = true;
+					}
+				}
+			}
+		}
+
+		//the running score drifts with every swap taken, so the order is scored again before it is compared
+		score = objective.reset(order);
+		if (score > result.score + IMPROVEMENT || start == 0)
+		{
+			result.score = score;
+			result.order = order;
+		}
+
+		if (!keepGoing(result.score))
+		{
+			break;
+		}
+	}
+
+	return result;
+}
+
+/*
+Purpose:		Scores every key letter for every position of the period against the letter frequencies of the model.
+Pre-condition:	Takes the count of each ciphertext letter under each position of the period, the period, the keyNum and
+				the model.
+Post-condition:	Returns [position][b] the log probability of the letters at that position decrypted with key letter b.
+*/
+static std::vector<double> scoreKeyLetters(const std::vector<int>& counts, size_t period, int keyNum, const LanguageModel& model)
+{
+	int keyNumInverse = CipherEngine::calcModInverse(keyNum);
+	std::vector<double> scores(period * ALPHABET_SIZE, 0);
+
+	for (size_t q = 0; q < period; q++)
+	{
+		for (int b = 0; b < ALPHABET_SIZE; b++)
+		{
+			double score = 0;
+			for (int x = 0; x < ALPHABET_SIZE; x++)
+			{
+				score += counts[q * ALPHABET_SIZE + x] * model.getLetterScore((keyNumInverse * (x - b + ALPHABET_SIZE)) % ALPHABET_SIZE);
+			}
+			scores[q * ALPHABET_SIZE + b] = score;
+		}
+	}
+
+	return scores;
+}
+
+/*
+Purpose:		Counts the ciphertext letters under each position of the period with the rows in one order.
+Pre-condition:	Takes the rows, the row placed at each position, the period and the vector the counts are stored in.
+Post-condition:	counts holds [position][letter] the number of ciphertext letters.
+*/
+static void countKeyLetters(const RowLayout& layout, const std::vector<int>& order, size_t period, std::vector<int>& counts)
+{
+	counts.assign(period * ALPHABET_SIZE, 0);
+
+	for (size_t i = 0; i <= order.size(); i++)
+	{
+		//the bottom row follows the full rows and is never reordered
+		bool bottom = (i == order.size());
+		const char* row = &layout.rows[(bottom ? i : order[i]) * layout.matrixSize];
+		size_t count = bottom ? layout.bottomLength : layout.matrixSize;
+
+		for (size_t c = 0, q = (i * layout.matrixSize) % period; c < count; c++)
+		{
+			counts[q * ALPHABET_SIZE + (row[c] - 'a')]++;
+			q = (q + 1 < period) ? q + 1 : 0;
+		}
+	}
+}
+
+/*
+Purpose:		Picks the key letter each position of the period fits best.
+Pre-condition:	Takes the scores given by scoreKeyLetters and the period.
+Post-condition:	Returns the key letters.
+*/
+static std::string solveKey(const std::vector<double>& scores, size_t period)
+{
+	std::string key(period, 'a');
+
+	for (size_t q = 0; q < period; q++)
+	{
+		const double* letters = &scores[q * ALPHABET_SIZE];
+		key[q] = (char)('a' + (std::max_element(letters, letters + ALPHABET_SIZE) - letters));
+	}
+
+	return key;
+}
+
+/*
+Purpose:		Gives the shortest key phrase that repeats to the same key letters.
+Pre-condition:	Takes the key letters of one period.
+Post-condition:	Returns the shortest repeating part.
+*/
+static std::string reduceKey(const std::string& key)
+{
+	for (size_t length = 1; length < key.length(); length++)
+	{
+		if (key.length() % length != 0)
+		{
+			continue;
+		}
+
+		bool repeats = true;
+		for (size_t i = length; i < key.length() && repeats; i++)
+		{
+			repeats = (key[i] == key[i - length]);
+		}
+
+		if (repeats)
+		{
+			return key.substr(0, length);
+		}
+	}
+
+	return key;
+}
+
+/*
+Purpose:		Ranks two matches of an audit, breaking ties by where they came from so the ranking does not depend on
+				the order the workers finished in.
+Pre-condition:	Takes the matches.
+Post-condition:	Returns true if the first ranks above the second.
+*/
+static bool isBetterMatch(const AuditMatch& a, const AuditMatch& b)
+{
+	if (a.score != b.score)
+	{
+		return a.score > b.score;
+	}
+
+	return (a.phrase != b.phrase) ? a.phrase < b.phrase : (a.order != b.order) ? a.order < b.order : a.keyNum < b.keyNum;
+}
+
+/*
+Purpose:		Drops all but the best matches of an audit once there are twice as many as are kept, so a low threshold
+				cannot fill memory.
+Pre-condition:	Takes the matches and the number to keep.
+Post-condition:	At most twice the number kept are left, and every match dropped ranks below every match left.
+*/
+static void trimMatches(std::vector<AuditMatch>& matches, size_t kept)
+{
+	if (matches.size() > 2 * kept)
+	{
+		std::nth_element(matches.begin(), matches.begin() + kept, matches.end(), isBetterMatch);
+		matches.resize(kept);
+	}
+}
+
+Cryptanalyzer::Cryptanalyzer(const LanguageModel& model, size_t threads) : model(model), pool(threads)
+{
+	candidates = 0;
+	matches = 0;
+	seconds = 0;
+}
+
+CipherStatus Cryptanalyzer::crack(std::string_view ciphertext, const CrackSettings& settings, std::vector<CrackResult>& results)
+{
+	auto started = std::chrono::steady_clock::now();
+	results.clear();
+	candidates = 0;
+	seconds = 0;
+
+	if (ciphertext.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	if (!CipherEngine::isLowerCase(ciphertext))
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	for (const std::string& phrase : settings.keyPhrases)
+	{
+		if (phrase.empty() || !CipherEngine::isLowerCase(phrase))
+		{
+			return CipherStatus::INVALID_KEY_PHRASE;
+		}
+	}
+
+	RowLayout layout = makeLayout(ciphertext);
+	std::vector<int> identity(layout.fullRows);
+	std::iota(identity.begin(), identity.end(), 0);
+
+	bool enumerating = isEnumerable(layout.fullRows, settings.exhaustiveLimit);
+	size_t restarts = (settings.restarts > 0) ? settings.restarts : 1;
+
+	//candidate phrases fix the periods, otherwise every period leaving enough letters per key letter is measured
+	std::vector<size_t> periods;
+	for (const std::string& phrase : settings.keyPhrases)
+	{
+		periods.push_back(phrase.length());
+	}
+	for (size_t period = 1; settings.keyPhrases.empty() && period <= settings.maxPeriod; period++)
+	{
+		if (period == 1 || layout.length / period >= MIN_CLASS_LETTERS)
+		{
+			periods.push_back(period);
+		}
+	}
+	std::sort(periods.begin(), periods.end());
+	periods.erase(std::unique(periods.begin(), periods.end()), periods.end());
+
+	//step 1: each period's assignment is searched from several starts at once, unless every order is tried
+	std::vector<size_t> jobPeriods;
+	for (size_t p = 0; p < periods.size(); p++)
+	{
+		bool searching = !enumerating && calcResidues(layout.matrixSize, periods[p]) > 1;
+		jobPeriods.insert(jobPeriods.end(), searching ? restarts : 1, p);
+	}
+
+	std::vector<PeriodResult> periodJobs(jobPeriods.size());
+	pool.parallelFor(jobPeriods.size(), 1, [&](size_t begin, size_t end)
+	{
+		for (size_t job = begin; job < end; job++)
+		{
+			size_t period = periods[jobPeriods[job]];
+			CoincidenceObjective objective(layout, period);
+			std::mt19937 random(settings.seed + (unsigned)job);
+			std::vector<int> order = identity;
+
+			//the first start of each period is the rows as stacked, the others random
+			if (job > 0 && jobPeriods[job - 1] == jobPeriods[job])
+			{
+				std::shuffle(order.begin(), order.end(), random);
+			}
+
+			OrderResult found;
+			if (calcResidues(layout.matrixSize, period) > 1)
+			{
+				found = searchOrder(objective, order, enumerating, 1, random, [](double) { return true; });
+			}
+			else
+			{
+				found.order = order;
+				found.score = objective.reset(order);
+				found.candidates = 1;
+			}
+
+			periodJobs[job].score = found.score;
+			periodJobs[job].order = found.order;
+			periodJobs[job].candidates = found.candidates;
+		}
+	});
+
+	std::vector<PeriodResult> best(periods.size());
+	std::vector<double> indices(periods.size(), 0);
+	for (size_t job = 0; job < periodJobs.size(); job++)
+	{
+		PeriodResult& period = best[jobPeriods[job]];
+		candidates += periodJobs[job].candidates;
+
+		if (periodJobs[job].score > period.score)
+		{
+			period.score = periodJobs[job].score;
+			period.order = periodJobs[job].order;
+		}
+	}
+
+	double bestIndex = 0;
+	for (size_t p = 0; p < periods.size(); p++)
+	{
+		CoincidenceObjective objective(layout, periods[p]);
+		objective.reset(best[p].order);
+		indices[p] = objective.getIndex();
+		bestIndex = (indices[p] > bestIndex) ? indices[p] : bestIndex;
+	}
+
+	//a multiple of the period scores as well as the period itself, so the shortest periods near the best are kept
+	std::vector<size_t> kept;
+	double lead = (bestIndex > 1.0 / ALPHABET_SIZE) ? bestIndex - 1.0 / ALPHABET_SIZE : 0;
+	double threshold = bestIndex - KEPT_COINCIDENCE * lead;
+	for (size_t p = 0; p < periods.size(); p++)
+	{
+		if (!settings.keyPhrases.empty() || (indices[p] >= threshold && kept.size() < settings.periodCandidates))
+		{
+			kept.push_back(p);
+		}
+	}
+
+	//a short text can favour a multiple of the period by chance, so the divisors of each period kept are tried too
+	for (size_t i = 0, count = kept.size(); i < count && settings.keyPhrases.empty(); i++)
+	{
+		for (size_t p = 0; p < kept[i]; p++)
+		{
+			if (periods[kept[i]] % periods[p] == 0 && std::find(kept.begin(), kept.end(), p) == kept.end())
+			{
+				kept.push_back(p);
+			}
+		}
+	}
+
+	//step 2: the key letters of every keyNum are solved for each kept period and each rotation of its assignment
+	std::vector<KeyCandidate> keys;
+	std::map<size_t, double> bestLetterScores;
+
+	for (size_t p : kept)
+	{
+		size_t period = periods[p];
+		size_t residues = calcResidues(layout.matrixSize, period);
+		CoincidenceObjective objective(layout, period);
+
+		for (size_t shift = 0; shift < residues; shift++)
+		{
+			std::vector<int> order = rotateResidues(best[p].order, residues, shift);
+			objective.reset(order);
+			const std::vector<int>& counts = objective.getCounts();
+
+			for (int keyNum : KEY_NUMS)
+			{
+				std::vector<double> letterScores = scoreKeyLetters(counts, period, keyNum, model);
+
+				std::vector<std::string> phrases;
+				for (const std::string& phrase : settings.keyPhrases)
+				{
+					if (phrase.length() == period)
+					{
+						phrases.push_back(phrase);
+					}
+				}
+
+				//with no candidate phrases each key letter takes the b its letters fit best
+				if (settings.keyPhrases.empty())
+				{
+					phrases.push_back(solveKey(letterScores, period));
+				}
+
+				for (const std::string& key : phrases)
+				{
+					KeyCandidate candidate;
+					candidate.period = period;
+					candidate.keyNum = keyNum;
+					candidate.key = key;
+					candidate.order = order;
+
+					for (size_t q = 0; q < period; q++)
+					{
+						candidate.letterScore += letterScores[q * ALPHABET_SIZE + (key[q] - 'a')];
+					}
+					candidate.letterScore /= layout.length;
+					candidates++;
+
+					auto best = bestLetterScores.emplace(period, candidate.letterScore).first;
+					best->second = (candidate.letterScore > best->second) ? candidate.letterScore : best->second;
+					keys.push_back(candidate);
+				}
+			}
+		}
+	}
+
+	//a longer period fits the letter frequencies better just by having more key letters, so keys only compete with
+	//keys of the same period here
+	keys.erase(std::remove_if(keys.begin(), keys.end(), [&](const KeyCandidate& candidate)
+	{
+		return candidate.letterScore < bestLetterScores[candidate.period] - settings.pruneMargin;
+	}), keys.end());
+
+	//step 3: the rows of each key are put in order, dropping keys that fall behind the best found by any worker
+	std::atomic<double> bestPairScore(-std::numeric_limits<double>::infinity());
+	double pairs = (layout.length > 1) ? (double)(layout.length - 1) : 1;
+	std::vector<OrderResult> orders(keys.size());
+
+	pool.parallelFor(keys.size(), 1, [&](size_t begin, size_t end)
+	{
+		for (size_t k = begin; k < end; k++)
+		{
+			KeyCandidate& candidate = keys[k];
+			CoincidenceObjective counting(layout, candidate.period);
+			std::mt19937 random(settings.seed + (unsigned)k);
+			bool leading = true;
+			orders[k].order = candidate.order;
+
+			//a row put in the wrong residue spoils the key letters solved from it, so once the rows are in order the
+			//letters are solved again and the rows searched again until the key settles
+			for (size_t round = 0; round < MAX_REFINEMENTS && leading; round++)
+			{
+				JoinObjective objective(layout, model, candidate);
+				OrderResult found = searchOrder(objective, orders[k].order, enumerating, restarts, random, [&](double score)
+				{
+					double perPair = score / pairs;
+					double shared = bestPairScore.load();
+
+					while (perPair > shared && !bestPairScore.compare_exchange_weak(shared, perPair))
+					{
+					}
+
+					leading = perPair >= bestPairScore.load() - settings.pruneMargin;
+					return leading;
+				});
+
+				found.candidates += orders[k].candidates;
+				orders[k] = found;
+
+				if (!settings.keyPhrases.empty())
+				{
+					break;
+				}
+
+				counting.reset(orders[k].order);
+				std::string key = solveKey(scoreKeyLetters(counting.getCounts(), candidate.period, candidate.keyNum, model), candidate.period);
+				if (key == candidate.key)
+				{
+					break;
+				}
+
+				candidate.key = key;
+				orders[k].candidates++;
+			}
+		}
+	});
+
+	//every key found is decrypted by the engine itself, so a result is only listed if the cipher agrees with it
+	for (size_t k = 0; k < keys.size(); k++)
+	{
+		candidates += orders[k].candidates;
+
+		CrackResult result;
+		result.key.keyNum = keys[k].keyNum;
+		result.key.keyPhrase = reduceKey(keys[k].key);
+		result.key.permutation.resize(layout.fullRows);
+		for (size_t i = 0; i < layout.fullRows; i++)
+		{
+			result.key.permutation[orders[k].order[i]] = (int)i;
+		}
+
+		result.plaintext.resize(layout.length);
+		if (CipherEngine::decrypt(ciphertext, result.key, &result.plaintext[0]) == CipherStatus::OK)
+		{
+			result.score = model.score(result.plaintext.data(), result.plaintext.length()) / pairs;
+			results.push_back(result);
+		}
+	}
+
+	std::stable_sort(results.begin(), results.end(), [](const CrackResult& a, const CrackResult& b)
+	{
+		return a.score > b.score;
+	});
+
+	//the same plaintext is often reached through a multiple of the period or another rotation, and is listed once
+	std::vector<CrackResult> ranked;
+	for (CrackResult& result : results)
+	{
+		bool repeated = false;
+		for (size_t i = 0; i < ranked.size() && !repeated; i++)
+		{
+			repeated = (ranked[i].plaintext == result.plaintext);
+		}
+
+		if (!repeated && ranked.size() < settings.resultCount)
+		{
+			ranked.push_back(std::move(result));
+		}
+	}
+	results.swap(ranked);
+
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	return CipherStatus::OK;
+}
+
+CipherStatus Cryptanalyzer::audit(std::string_view ciphertext, const PhraseList& phrases, const AuditSettings& settings,
+	std::vector<CrackResult>& results)
+{
+	auto started = std::chrono::steady_clock::now();
+	results.clear();
+	candidates = 0;
+	matches = 0;
+	seconds = 0;
+
+	if (ciphertext.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	if (!CipherEngine::isLowerCase(ciphertext))
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	if (settings.keyNum != 0 && !CipherEngine::isValidKeyNum(settings.keyNum))
+	{
+		return CipherStatus::INVALID_KEY_NUM;
+	}
+
+	if (!CipherEngine::isLowerCase(phrases.letters) || phrases.ends.empty() || phrases.ends.back() != phrases.letters.length())
+	{
+		return CipherStatus::INVALID_KEY_PHRASE;
+	}
+
+	size_t longest = 0;
+	for (size_t i = 0; i < phrases.ends.size(); i++)
+	{
+		size_t start = (i > 0) ? phrases.ends[i - 1] : 0;
+		if (phrases.ends[i] <= start)
+		{
+			return CipherStatus::INVALID_KEY_PHRASE;
+		}
+		longest = (phrases.ends[i] - start > longest) ? phrases.ends[i] - start : longest;
+	}
+
+	RowLayout layout = makeLayout(ciphertext);
+
+	//the row order given, or every order of the full rows
+	std::vector<std::vector<int>> orders;
+	if (!settings.permutation.empty())
+	{
+		CipherKey key;
+		key.keyNum = 1;
+		key.keyPhrase = "a";
+		key.permutation = settings.permutation;
+		if (CipherEngine::validateKey(key, layout.length) != CipherStatus::OK)
+		{
+			return CipherStatus::INVALID_PERMUTATION;
+		}
+
+		std::vector<int> order(layout.fullRows);
+		for (size_t k = 0; k < layout.fullRows; k++)
+		{
+			order[settings.permutation[k]] = (int)k;
+		}
+		orders.push_back(order);
+	}
+	else
+	{
+		if (!isEnumerable(layout.fullRows, settings.exhaustiveLimit))
+		{
+			return CipherStatus::INVALID_PERMUTATION;
+		}
+
+		std::vector<int> order(layout.fullRows);
+		std::iota(order.begin(), order.end(), 0);
+		do
+		{
+			orders.push_back(order);
+		} while (std::next_permutation(order.begin(), order.end()));
+	}
+
+	//every keyNum keeps its place in the tables, and the ones not tried are left out when the sums are read
+	bool tried[KEY_NUM_COUNT];
+	for (size_t k = 0; k < KEY_NUM_COUNT; k++)
+	{
+		tried[k] = (settings.keyNum == 0 || settings.keyNum == KEY_NUMS[k]);
+	}
+
+	//a wrong key spreads the letters about as if they were drawn at random, so the cut is placed between the score of
+	//random letters and the score the model expects of English
+	double randomScore = 0;
+	double englishScore = 0;
+	for (int x = 0; x < ALPHABET_SIZE; x++)
+	{
+		double letterScore = model.getLetterScore(x);
+		randomScore += letterScore / ALPHABET_SIZE;
+		englishScore += std::exp(letterScore) * letterScore;
+	}
+	float cut = (float)((randomScore + settings.threshold * (englishScore - randomScore)) * layout.length);
+
+	//the phrases are sorted by length, since the tables of a row order depend on the period
+	std::vector<size_t> lengthStarts(longest + 2, 0);
+	for (size_t i = 0; i < phrases.ends.size(); i++)
+	{
+		lengthStarts[phrases.ends[i] - ((i > 0) ? phrases.ends[i - 1] : 0) + 1]++;
+	}
+	std::partial_sum(lengthStarts.begin(), lengthStarts.end(), lengthStarts.begin());
+
+	std::vector<size_t> sorted(phrases.ends.size());
+	std::vector<size_t> next(lengthStarts.begin(), lengthStarts.end() - 1);
+	for (size_t i = 0; i < phrases.ends.size(); i++)
+	{
+		sorted[next[phrases.ends[i] - ((i > 0) ? phrases.ends[i - 1] : 0)]++] = i;
+	}
+
+	std::vector<AuditMatch> found;
+	std::mutex foundLock;
+	size_t kept = settings.resultCount + AUDIT_KEPT_MATCHES;
+	std::vector<float> tables;
+
+	for (size_t period = 1; period <= longest; period++)
+	{
+		size_t first = lengthStarts[period];
+		size_t count = lengthStarts[period + 1] - first;
+		if (count == 0)
+		{
+			continue;
+		}
+
+		//[order][position][key letter][keyNum] the score of the letters at that position, held for a block of orders
+		size_t tableSize = period * ALPHABET_SIZE * KEY_NUM_COUNT;
+		size_t blockOrders = (AUDIT_TABLE_SCORES / tableSize > 0) ? AUDIT_TABLE_SCORES / tableSize : 1;
+
+		for (size_t blockStart = 0; blockStart < orders.size(); blockStart += blockOrders)
+		{
+			size_t blockEnd = (blockStart + blockOrders < orders.size()) ? blockStart + blockOrders : orders.size();
+			tables.assign((blockEnd - blockStart) * tableSize, 0);
+
+			pool.parallelFor(blockEnd - blockStart, 1, [&](size_t begin, size_t end)
+			{
+				std::vector<int> counts;
+				for (size_t o = begin; o < end; o++)
+				{
+					countKeyLetters(layout, orders[blockStart + o], period, counts);
+					float* table = &tables[o * tableSize];
+
+					for (size_t k = 0; k < KEY_NUM_COUNT; k++)
+					{
+						if (!tried[k])
+						{
+							continue;
+						}
+
+						std::vector<double> scores = scoreKeyLetters(counts, period, KEY_NUMS[k], model);
+						for (size_t entry = 0; entry < period * ALPHABET_SIZE; entry++)
+						{
+							table[entry * KEY_NUM_COUNT + k] = (float)scores[entry];
+						}
+					}
+				}
+			});
+
+			pool.parallelFor(count, AUDIT_GRAIN, [&](size_t begin, size_t end)
+			{
+				std::vector<AuditMatch> local;
+				size_t reached = 0;
+				for (size_t n = begin; n < end; n++)
+				{
+					size_t phrase = sorted[first + n];
+					const char* letters = &phrases.letters[phrases.ends[phrase] - period];
+
+					for (size_t o = 0; o < blockEnd - blockStart; o++)
+					{
+						//every keyNum is summed at once from the row of each key letter, which the compiler vectorizes
+						const float* table = &tables[o * tableSize];
+						float sums[KEY_NUM_COUNT] = {};
+
+						for (size_t q = 0; q < period; q++)
+						{
+							const float* row = &table[(q * ALPHABET_SIZE + (letters[q] - 'a')) * KEY_NUM_COUNT];
+							for (size_t k = 0; k < KEY_NUM_COUNT; k++)
+							{
+								sums[k] += row[k];
+							}
+						}
+
+						for (size_t k = 0; k < KEY_NUM_COUNT; k++)
+						{
+							if (tried[k] && sums[k] >= cut)
+							{
+								AuditMatch match;
+								match.phrase = phrase;
+								match.order = blockStart + o;
+								match.keyNum = KEY_NUMS[k];
+								match.score = sums[k];
+								local.push_back(match);
+								reached++;
+							}
+						}
+					}
+					trimMatches(local, kept);
+				}
+
+				if (!local.empty())
+				{
+					std::lock_guard<std::mutex> guard(foundLock);
+					matches += reached;
+					found.insert(found.end(), local.begin(), local.end());
+					trimMatches(found, kept);
+				}
+			});
+
+			candidates += count * (blockEnd - blockStart) * ((settings.keyNum != 0) ? 1 : KEY_NUM_COUNT);
+		}
+	}
+
+	std::sort(found.begin(), found.end(), isBetterMatch);
+
+	//the best matches are decrypted by the engine itself, and a plaintext reached by several keys is listed once
+	double pairs = (layout.length > 1) ? (double)(layout.length - 1) : 1;
+	for (size_t m = 0; m < found.size() && results.size() < settings.resultCount; m++)
+	{
+		size_t start = (found[m].phrase > 0) ? phrases.ends[found[m].phrase - 1] : 0;
+		const std::vector<int>& order = orders[found[m].order];
+
+		CrackResult result;
+		result.key.keyNum = found[m].keyNum;
+		result.key.keyPhrase = phrases.letters.substr(start, phrases.ends[found[m].phrase] - start);
+		result.key.permutation.resize(layout.fullRows);
+		for (size_t i = 0; i < layout.fullRows; i++)
+		{
+			result.key.permutation[order[i]] = (int)i;
+		}
+
+		result.plaintext.resize(layout.length);
+		if (CipherEngine::decrypt(ciphertext, result.key, &result.plaintext[0]) != CipherStatus::OK)
+		{
+			continue;
+		}
+
+		bool repeated = false;
+		for (size_t i = 0; i < results.size() && !repeated; i++)
+		{
+			repeated = (results[i].plaintext == result.plaintext);
+
+			//a phrase repeated back to back gives the same plaintext as the phrase itself, which is listed instead
+			if (repeated && result.key.keyPhrase.length() < results[i].key.keyPhrase.length())
+			{
+				results[i].key = result.key;
+			}
+		}
+
+		if (!repeated)
+		{
+			result.score = model.score(result.plaintext.data(), result.plaintext.length()) / pairs;
+			results.push_back(std::move(result));
+		}
+	}
+
+	std::stable_sort(results.begin(), results.end(), [](const CrackResult& a, const CrackResult& b)
+	{
+		return a.score > b.score;
+	});
+
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	return CipherStatus::OK;
+}
+
+size_t Cryptanalyzer::getCandidates() const
+{
+	return candidates;
+}
+
+double Cryptanalyzer::getSeconds() const
+{
+	return seconds;
+}
+
+size_t Cryptanalyzer::getMatches() const
+{
+	return matches;
+}
+
+size_t Cryptanalyzer::getThreadCount() const
+{
+	return pool.getThreadCount();
+}
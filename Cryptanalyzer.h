@@ -0,0 +1,119 @@
+/*
+Author:			My Tran
+Filename:		Cryptanalyzer.h
+Description:	This file provides the declarations of the Cryptanalyzer class. Cryptanalyzer recovers keys of the product
+cipher from ciphertext alone, for training and red team exercises. The rows of the transposition keep their letters in
+order, so the ciphertext is first read back into rows with no reordering and the search works on whole rows:
+
+	1. For every key phrase length (the period) the rows are assigned to positions so that the letters sharing a key
+	   letter look most like a single alphabet, measured by their index of coincidence. The periods that reach the
+	   highest index are kept.
+	2. For every kept period and each of the 12 keyNums, each key letter is solved on its own by matching its letters
+	   against English letter frequencies, or taken from the candidate key phrases when some are given. Keys whose
+	   letters fit much worse than the best key of the same period are pruned.
+	3. For every key left the rows are put in order by how well the letters run across the joins between rows, scored
+	   with the letter triples of the LanguageModel. Solved key letters are then solved again from the new order, and
+	   the rows searched again, until the key settles. Searches falling too far behind the best score found by any
+	   worker are abandoned early.
+
+Row orders are enumerated in full while there are few enough of them, and searched by swapping rows from several random
+starts otherwise. The periods, keys and starts are spread across a ThreadPool. Every key tried is decrypted by
+CipherEngine, and the results are ranked by how English the plaintext reads.
+
+An audit instead tests a list of key phrases, such as a wordlist of millions, against a ciphertext whose keyNum and row
+combination are known or few enough to try every one. The ciphertext is read back into rows once for every row order,
+and for each phrase length the letters under each position of the period are counted, so one table per order holds the
+letter frequency score of every key letter at every position under all 12 keyNums side by side. A phrase is then scored
+under every keyNum at once by adding one row of the table per letter of the phrase, without decrypting anything. The
+phrases are spread across a ThreadPool, and only the phrases whose score reaches the threshold are decrypted by
+CipherEngine and reported.
+*/
+#pragma once
+#include<cstddef>
+#include<string>
+#include<string_view>
+#include<vector>
+#include "CipherEngine.h"
+#include "LanguageModel.h"
+#include "ThreadPool.h"
+
+//limits of a search
+struct CrackSettings
+{
+	size_t maxPeriod = 16;	//longest key phrase tried when no candidate phrases are given
+	size_t periodCandidates = 3;	//periods kept after the index of coincidence is measured
+	size_t exhaustiveLimit = 40320;	//most row orders enumerated in full, searched by swapping above that
+	size_t restarts = 8;	//random starts of each swapping search
+	double pruneMargin = 0.25;	//log probability per letter a key may fall behind the best one before it is dropped
+	size_t resultCount = 10;	//most results returned
+	unsigned seed = 1;	//seed of the random starts
+	std::vector<std::string> keyPhrases;	//candidate key phrases, lower case; empty to solve the key letters
+};
+
+//candidate key phrases of an audit stored back to back, so millions of them take little more space than their letters
+struct PhraseList
+{
+	std::string letters;	//every phrase, lower case, one after another
+	std::vector<size_t> ends;	//position in letters just past the end of each phrase
+};
+
+//what an audit tries and what it reports
+struct AuditSettings
+{
+	int keyNum = 0;	//keyNum of the ciphertext, 0 to try every one
+	std::vector<int> permutation;	//row combination of the ciphertext, empty to try every order of the rows
+	size_t exhaustiveLimit = 40320;	//most row orders tried when the row combination is not given
+	double threshold = 0.5;	//share of the way from the score of random letters to that of English a plaintext must reach
+	size_t resultCount = 10;	//most results returned
+};
+
+//one recovered key and the plaintext it gives
+struct CrackResult
+{
+	CipherKey key;	//key that decrypts the ciphertext to the plaintext
+	double score = 0;	//average log probability of a letter pair of the plaintext, higher is better
+	std::string plaintext;	//plaintext given by the key
+};
+
+class Cryptanalyzer
+{
+	public:
+		/*
+		Purpose:		Creates a cryptanalyzer with its own worker threads.
+		Pre-condition:	Takes the language model, which is copied, and the number of threads, or 0 for one per hardware
+						thread.
+		Post-condition:	None
+		*/
+		Cryptanalyzer(const LanguageModel&, size_t = 0);
+
+		/*
+		Purpose:		Searches for the keys most likely to have produced a ciphertext.
+		Pre-condition:	Takes lower case ciphertext, the settings and the vector the results are stored in.
+		Post-condition:	Returns OK and stores up to resultCount results, best first, with no two giving the same plaintext.
+						Otherwise returns EMPTY_INPUT, INVALID_CHARACTER or INVALID_KEY_PHRASE for a bad candidate phrase.
+		*/
+		CipherStatus crack(std::string_view, const CrackSettings&, std::vector<CrackResult>&);
+
+		/*
+		Purpose:		Tests every key phrase of a list against a ciphertext, scoring the plaintext each one gives against
+						the letter frequencies of the model.
+		Pre-condition:	Takes lower case ciphertext, the phrases, the settings and the vector the results are stored in.
+		Post-condition:	Returns OK and stores up to resultCount of the keys reaching the threshold, best first, with no two
+						giving the same plaintext. Otherwise returns EMPTY_INPUT, INVALID_CHARACTER, INVALID_KEY_NUM,
+						INVALID_KEY_PHRASE if a phrase is empty or not lower case, or INVALID_PERMUTATION if the row
+						combination does not fit the ciphertext or is left out with more row orders than exhaustiveLimit.
+		*/
+		CipherStatus audit(std::string_view, const PhraseList&, const AuditSettings&, std::vector<CrackResult>&);
+
+		size_t getCandidates() const;	//returns the number of candidate keys scored by the last search
+		size_t getMatches() const;	//returns the number of candidate keys of the last audit that reached the threshold
+		double getSeconds() const;	//returns the time taken by the last search
+		size_t getThreadCount() const;	//returns the number of worker threads
+	private:
+		//private data members
+		LanguageModel model;	//statistics the plaintexts are scored with
+		ThreadPool pool;	//workers shared by every search
+		size_t candidates;	//candidate keys scored by the last search
+		size_t matches;	//candidate keys of the last audit that reached the threshold
+		double seconds;	//time taken by the last search
+};
@@ -0,0 +1,109 @@
+/*
+Author:			My Tran
+Filename:		FileCipher.cpp
+Description:	This file implements the header file FileCipher.h providing the definitions for the methods of the
+FileCipher class.
+*/
+#include "FileCipher.h"
+#include "Instrumentation.h"
+#include "MappedFile.h"
+#include<cstdio>
+#include<string_view>
+
+FileCipher::FileCipher(const KeySchedule& schedule, ParallelCipher* parallel) : schedule(schedule), parallel(parallel)
+{
+}
+
+CipherStatus FileCipher::encrypt(const std::string& inputPath, const std::string& outputPath)
+{
+	return run(inputPath, outputPath, true);
+}
+
+CipherStatus FileCipher::decrypt(const std::string& inputPath, const std::string& outputPath)
+{
+	return run(inputPath, outputPath, false);
+}
+
+CipherStatus FileCipher::run(const std::string& inputPath, const std::string& outputPath, bool encrypting)
+{
+	//creating the output would truncate the input, and cleaning up after a failure would remove it
+	if (MappedFile::isSameFile(inputPath, outputPath))
+	{
+		return CipherStatus::SAME_FILE;
+	}
+
+	MappedFile input;
+	{
+		INSTRUMENT_STAGE(CipherStage::INPUT, 0);
+		if (!input.openRead(inputPath))
+		{
+			return CipherStatus::STREAM_ERROR;
+		}
+	}
+
+	//a single trailing new line is left over from the tool or an editor, and is not part of the text
+	std::string_view text(input.getData(), input.getSize());
+	if (!text.empty() && text.back() == '\n')
+	{
+		text.remove_suffix(1);
+
+		//written on Windows, the new line is a carriage return and a line feed
+		if (!text.empty() && text.back() == '\r')
+		{
+			text.remove_suffix(1);
+		}
+	}
+
+	//the key is checked before the output is created so a bad key leaves no file behind, while the characters are
+	//checked by the cipher itself in the same pass that reads them
+	if (text.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	CipherStatus status = schedule.validateLength(text.length());
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	//a path that could not be opened is not ours to remove, whether it is a directory or a file we may not write
+	MappedFile output;
+	bool opened = false;
+	if (!output.create(outputPath, text.length() + 1, opened))
+	{
+		if (opened)
+		{
+			std::remove(outputPath.c_str());
+		}
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	//the cipher reads the input pages and writes the output pages with nothing in between
+	char* result = output.getData();
+	if (parallel != nullptr)
+	{
+		status = encrypting ? parallel->encrypt(text, schedule, result) : parallel->decrypt(text, schedule, result);
+	}
+	else
+	{
+		status = encrypting ? CipherEngine::encrypt(text, schedule, result) : CipherEngine::decrypt(text, schedule, result);
+	}
+	result[text.length()] = '\n';
+
+	{
+		//the pages of the output are only written back to the file here
+		INSTRUMENT_STAGE(CipherStage::OUTPUT, text.length() + 1);
+		if (!output.close() && status == CipherStatus::OK)
+		{
+			status = CipherStatus::STREAM_ERROR;
+		}
+	}
+
+	if (status != CipherStatus::OK)
+	{
+		std::remove(outputPath.c_str());
+	}
+
+	return status;
+}
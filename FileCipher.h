@@ -0,0 +1,56 @@
+/*
+Author:			My Tran
+Filename:		FileCipher.h
+Description:	This file provides the declarations of the FileCipher class. FileCipher encrypts and decrypts a file into
+another file without copying the text. The input file is mapped into memory, the output file is created at its final
+size and mapped too, and the substitution and transposition read the input pages and write the output pages directly.
+Large files are split across the workers of a ParallelCipher when one is given.
+
+File format:	The input holds only lower case letters, optionally followed by a single new line, which is the format the
+command line tool writes. The output holds the result followed by a new line.
+*/
+#pragma once
+#include<string>
+#include "KeySchedule.h"
+#include "ParallelCipher.h"
+
+class FileCipher
+{
+	public:
+		/*
+		Purpose:		Creates a file cipher for a key.
+		Pre-condition:	Takes the schedule of the key and, optionally, a parallel cipher to run large files on. Both must
+						outlive the FileCipher.
+		Post-condition:	None
+		*/
+		FileCipher(const KeySchedule&, ParallelCipher* = nullptr);
+
+		/*
+		Purpose:		Encrypts a file into another file.
+		Pre-condition:	Takes the path of the plaintext file and the path of the ciphertext file to write.
+		Post-condition:	Returns OK and the ciphertext file is written. Returns SAME_FILE, leaving both untouched, if
+						the two paths name the same file. Otherwise returns the problem found and no ciphertext file is
+						left behind.
+		*/
+		CipherStatus encrypt(const std::string&, const std::string&);
+
+		/*
+		Purpose:		Decrypts a file into another file.
+		Pre-condition:	Takes the path of the ciphertext file and the path of the plaintext file to write.
+		Post-condition:	Returns OK and the plaintext file is written. Returns SAME_FILE, leaving both untouched, if
+						the two paths name the same file. Otherwise returns the problem found and no plaintext file is
+						left behind.
+		*/
+		CipherStatus decrypt(const std::string&, const std::string&);
+	private:
+		//private data members
+		const KeySchedule& schedule;	//key material for every file
+		ParallelCipher* parallel;	//workers for large files, or nullptr to run on the calling thread
+
+		/*
+		Purpose:		Maps both files and runs encryption or decryption from one to the other.
+		Pre-condition:	Takes the input path, the output path and whether to encrypt.
+		Post-condition:	Same as encrypt and decrypt.
+		*/
+		CipherStatus run(const std::string&, const std::string&, bool);
+};
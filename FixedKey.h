@@ -0,0 +1,137 @@
+/*
+Author:			My Tran
+Filename:		FixedKey.h
+Description:	This file provides the FixedKey class template for deployments whose keyNum and key phrase are fixed when
+the program is compiled. The key is checked by static_assert, so an invalid keyNum or key phrase stops the build instead
+of being reported at runtime, and the inverse of keyNum, the substitution tables and the expanded key stream are all
+worked out by the compiler. Encrypting with a FixedKey therefore builds nothing at runtime.
+
+A key phrase is passed as a constexpr character array with static storage, for example:
+
+	static constexpr char DEPLOYMENT_PHRASE[] = "somekeyphrase";
+	typedef FixedKey<7, DEPLOYMENT_PHRASE> DeploymentKey;
+
+The permutation still depends on the length of each message, so it is given with every call. Calling
+DeploymentKey::install() once at startup makes every KeySchedule built for the same keyNum and key phrase use the
+compiled substitution as well, so the rest of the program (the menu, the command line tool, the stream and file ciphers)
+picks it up without changes.
+*/
+#pragma once
+#include<cstddef>
+#include<string_view>
+#include<vector>
+#include "CipherEngine.h"
+#include "KeySchedule.h"
+#include "Substitution.h"
+#include "Transposition.h"
+
+template<int KeyNum, const char* KeyPhrase>
+class FixedKey
+{
+	public:
+		static constexpr int KEY_NUM = KeyNum;	//a of C = (aP + b)
+		static constexpr int KEY_NUM_INVERSE = CipherEngine::calcModInverse(KeyNum);	//a^-1 of P = (a^-1)(C - b)
+		static constexpr std::string_view KEY_PHRASE = KeyPhrase;	//letters giving b
+
+		static_assert(CipherEngine::isValidKeyNum(KeyNum), "keyNum must be a positive odd integer less than 26 other than 13");
+		static_assert(!KEY_PHRASE.empty() && KEY_PHRASE.length() <= Substitution::MAX_EXPANDED_PHRASE,
+			"key phrase must hold 1 to Substitution::MAX_EXPANDED_PHRASE letters");
+
+		/*
+		Purpose:		Apply the affine/vigenere substitution and the row transposition to plaintext.
+		Pre-condition:	Takes lower case plaintext, the permutation for its length, and a buffer of at least
+						plaintext.length() characters.
+		Post-condition:	Returns OK and the ciphertext is stored in output. Otherwise output is left unspecified.
+		*/
+		static CipherStatus encrypt(std::string_view plaintext, const std::vector<int>& permutation, char* output)
+		{
+			CipherStatus status = validate(plaintext, permutation);
+			if (status != CipherStatus::OK)
+			{
+				return status;
+			}
+
+			Transposition transposition(plaintext.length(), permutation);
+			CipherEngine::encryptBlock(plaintext.data(), 0, SUBSTITUTION, transposition, output);
+
+			return CipherStatus::OK;
+		}
+
+		/*
+		Purpose:		Reverse the row transposition and the affine/vigenere substitution on ciphertext.
+		Pre-condition:	Takes lower case ciphertext, the permutation it was encrypted with, and a buffer of at least
+						ciphertext.length() characters.
+		Post-condition:	Returns OK and the plaintext is stored in output. Otherwise output is left unspecified.
+		*/
+		static CipherStatus decrypt(std::string_view ciphertext, const std::vector<int>& permutation, char* output)
+		{
+			CipherStatus status = validate(ciphertext, permutation);
+			if (status != CipherStatus::OK)
+			{
+				return status;
+			}
+
+			Transposition transposition(ciphertext.length(), permutation);
+			CipherEngine::decryptBlock(ciphertext.data(), 0, SUBSTITUTION, transposition, output);
+
+			return CipherStatus::OK;
+		}
+
+		/*
+		Purpose:		Makes every Substitution built for this key at runtime use the compiled one.
+		Pre-condition:	None. May be called while other threads use the cipher, but only schedules built afterwards are
+						sure to use the compiled key.
+		Post-condition:	Returns false if Substitution::MAX_INSTALLED keys are installed already.
+		*/
+		static bool install()
+		{
+			return Substitution::install(SUBSTITUTION);
+		}
+
+		static const Substitution& getSubstitution()	//returns the substitution built by the compiler
+		{
+			return SUBSTITUTION;
+		}
+	private:
+		/*
+		Purpose:		Determines if every letter of the key phrase is lower case.
+		Pre-condition:	None
+		Post-condition:	Returns true if the key phrase can be used.
+		*/
+		static constexpr bool isLowerCasePhrase()
+		{
+			for (char letter : KEY_PHRASE)
+			{
+				if (letter < 'a' || letter > 'z')
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		static_assert(isLowerCasePhrase(), "key phrase may only contain lower case letters");
+
+		/*
+		Purpose:		Checks text and a permutation before they are used.
+		Pre-condition:	Takes the text and the permutation.
+		Post-condition:	Returns OK if they can be used together, otherwise the status describing the first problem found.
+		*/
+		static CipherStatus validate(std::string_view text, const std::vector<int>& permutation)
+		{
+			if (text.empty())
+			{
+				return CipherStatus::EMPTY_INPUT;
+			}
+
+			if (!KeySchedule::fitsLength(permutation, text.length()) || !KeySchedule::isPermutation(permutation))
+			{
+				return CipherStatus::INVALID_PERMUTATION;
+			}
+
+			return CipherEngine::isLowerCase(text) ? CipherStatus::OK : CipherStatus::INVALID_CHARACTER;
+		}
+
+		static constexpr Substitution SUBSTITUTION = Substitution(Substitution::CompileTime(), KeyNum, KEY_NUM_INVERSE, KEY_PHRASE);	//tables and key stream of the key
+};
@@ -0,0 +1,276 @@
+/*
+Author:			My Tran
+Filename:		Instrumentation.cpp
+Description:	This file implements the header file Instrumentation.h providing the definitions for the methods of the
+Instrumentation class. When ENCRYPTOR_INSTRUMENTATION is defined it also replaces the global operator new so heap
+allocations are counted.
+*/
+#include "Instrumentation.h"
+#include<cstdio>
+#include<cstdlib>
+#include<new>
+
+Instrumentation::StageCounters Instrumentation::stages[STAGE_COUNT];
+std::atomic<uint64_t> Instrumentation::messages(0);
+std::atomic<uint64_t> Instrumentation::bytes(0);
+std::atomic<uint64_t> Instrumentation::allocations(0);
+std::atomic<int64_t> Instrumentation::startTime(0);
+
+/*
+Purpose:		Reads the steady clock in nanoseconds.
+Pre-condition:	None
+Post-condition:	Returns the time.
+*/
+static int64_t now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef ENCRYPTOR_INSTRUMENTATION
+//every allocation of the program goes through these so it can be counted
+void* operator new(size_t size)
+{
+	Instrumentation::recordAllocation();
+
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
+
+void Instrumentation::recordStage(CipherStage stage, uint64_t nanoseconds, size_t count)
+{
+	StageCounters& counters = stages[(size_t)stage];
+
+	//bucket i holds latencies from 2^(i - 1) up to 2^i nanoseconds
+	size_t bucket = 0;
+	while (bucket < HISTOGRAM_BUCKETS - 1 && (nanoseconds >> bucket) != 0)
+	{
+		bucket++;
+	}
+
+	counters.calls.fetch_add(1, std::memory_order_relaxed);
+	counters.bytes.fetch_add(count, std::memory_order_relaxed);
+	counters.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+	counters.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Instrumentation::recordMessage(size_t length)
+{
+	//the clock starts with the first message unless reset started it already
+	int64_t unset = 0;
+	startTime.compare_exchange_strong(unset, now(), std::memory_order_relaxed);
+
+	messages.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(length, std::memory_order_relaxed);
+}
+
+void Instrumentation::recordAllocation()
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+CipherStats Instrumentation::getStats()
+{
+	CipherStats stats;
+
+	for (size_t s = 0; s < STAGE_COUNT; s++)
+	{
+		stats.stages[s].calls = stages[s].calls.load(std::memory_order_relaxed);
+		stats.stages[s].bytes = stages[s].bytes.load(std::memory_order_relaxed);
+		stats.stages[s].totalNanoseconds = stages[s].totalNanoseconds.load(std::memory_order_relaxed);
+
+		for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+		{
+			stats.stages[s].buckets[b] = stages[s].buckets[b].load(std::memory_order_relaxed);
+		}
+	}
+
+	stats.messages = messages.load(std::memory_order_relaxed);
+	stats.bytes = bytes.load(std::memory_order_relaxed);
+	stats.allocations = allocations.load(std::memory_order_relaxed);
+
+	int64_t start = startTime.load(std::memory_order_relaxed);
+	stats.seconds = (start != 0) ? (now() - start) / 1e9 : 0;
+
+	if (stats.seconds > 0)
+	{
+		stats.messagesPerSecond = stats.messages / stats.seconds;
+		stats.bytesPerSecond = stats.bytes / stats.seconds;
+	}
+
+	return stats;
+}
+
+void Instrumentation::reset()
+{
+	for (size_t s = 0; s < STAGE_COUNT; s++)
+	{
+		stages[s].calls.store(0, std::memory_order_relaxed);
+		stages[s].bytes.store(0, std::memory_order_relaxed);
+		stages[s].totalNanoseconds.store(0, std::memory_order_relaxed);
+
+		for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+		{
+			stages[s].buckets[b].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	messages.store(0, std::memory_order_relaxed);
+	bytes.store(0, std::memory_order_relaxed);
+	allocations.store(0, std::memory_order_relaxed);
+	startTime.store(now(), std::memory_order_relaxed);
+}
+
+void Instrumentation::writeJson(std::ostream& output)
+{
+	CipherStats stats = getStats();
+	char number[64];
+
+	output << "{\"enabled\":" << (isEnabled() ? "true" : "false");
+	output << ",\"messages\":" << stats.messages << ",\"bytes\":" << stats.bytes << ",\"allocations\":" << stats.allocations;
+	std::snprintf(number, sizeof(number), ",\"seconds\":%.6f", stats.seconds);
+	output << number;
+	std::snprintf(number, sizeof(number), ",\"messagesPerSecond\":%.3f", stats.messagesPerSecond);
+	output << number;
+	std::snprintf(number, sizeof(number), ",\"bytesPerSecond\":%.3f", stats.bytesPerSecond);
+	output << number;
+
+	//every histogram has the same buckets, so their upper bounds in nanoseconds are written once, with null for the last
+	output << ",\"histogramBounds\":[";
+	for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+	{
+		output << (b > 0 ? "," : "");
+		if (b < HISTOGRAM_BUCKETS - 1)
+		{
+			output << ((uint64_t)1 << b);
+		}
+		else
+		{
+			output << "null";
+		}
+	}
+
+	output << "],\"stages\":{";
+
+	for (size_t s = 0; s < STAGE_COUNT; s++)
+	{
+		const StageStats& stage = stats.stages[s];
+
+		output << (s > 0 ? "," : "") << "\"" << getStageName((CipherStage)s) << "\":{";
+		output << "\"calls\":" << stage.calls << ",\"bytes\":" << stage.bytes << ",\"totalNanoseconds\":" << stage.totalNanoseconds;
+
+		output << ",\"histogram\":[";
+		for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+		{
+			output << (b > 0 ? "," : "") << stage.buckets[b];
+		}
+		output << "]}";
+	}
+
+	output << "}}\n";
+}
+
+void Instrumentation::writePrometheus(std::ostream& output)
+{
+	CipherStats stats = getStats();
+	char number[64];
+
+	output << "# HELP encryptor_messages_total Messages encrypted or decrypted.\n";
+	output << "# TYPE encryptor_messages_total counter\n";
+	output << "encryptor_messages_total " << stats.messages << "\n";
+	output << "# HELP encryptor_bytes_total Bytes of the messages encrypted or decrypted.\n";
+	output << "# TYPE encryptor_bytes_total counter\n";
+	output << "encryptor_bytes_total " << stats.bytes << "\n";
+	output << "# HELP encryptor_allocations_total Heap allocations made by the program.\n";
+	output << "# TYPE encryptor_allocations_total counter\n";
+	output << "encryptor_allocations_total " << stats.allocations << "\n";
+	output << "# HELP encryptor_stage_bytes_total Bytes handled by each stage of the cipher.\n";
+	output << "# TYPE encryptor_stage_bytes_total counter\n";
+
+	for (size_t s = 0; s < STAGE_COUNT; s++)
+	{
+		output << "encryptor_stage_bytes_total{stage=\"" << getStageName((CipherStage)s) << "\"} " << stats.stages[s].bytes << "\n";
+	}
+
+	//prometheus histograms are cumulative and measured in seconds
+	output << "# HELP encryptor_stage_duration_seconds Time taken by each run of a stage of the cipher.\n";
+	output << "# TYPE encryptor_stage_duration_seconds histogram\n";
+
+	for (size_t s = 0; s < STAGE_COUNT; s++)
+	{
+		const StageStats& stage = stats.stages[s];
+		const char* name = getStageName((CipherStage)s);
+		uint64_t cumulative = 0;
+
+		for (size_t b = 0; b < HISTOGRAM_BUCKETS - 1; b++)
+		{
+			cumulative += stage.buckets[b];
+			std::snprintf(number, sizeof(number), "%.9g", ((uint64_t)1 << b) / 1e9);
+			output << "encryptor_stage_duration_seconds_bucket{stage=\"" << name << "\",le=\"" << number << "\"} " << cumulative << "\n";
+		}
+
+		std::snprintf(number, sizeof(number), "%.9f", stage.totalNanoseconds / 1e9);
+		output << "encryptor_stage_duration_seconds_bucket{stage=\"" << name << "\",le=\"+Inf\"} " << stage.calls << "\n";
+		output << "encryptor_stage_duration_seconds_sum{stage=\"" << name << "\"} " << number << "\n";
+		output << "encryptor_stage_duration_seconds_count{stage=\"" << name << "\"} " << stage.calls << "\n";
+	}
+}
+
+const char* Instrumentation::getStageName(CipherStage stage)
+{
+	switch (stage)
+	{
+	case CipherStage::KEY_SCHEDULE:
+		return "key_schedule";
+	case CipherStage::NORMALIZE:
+		return "normalize";
+	case CipherStage::SUBSTITUTE:
+		return "substitute";
+	case CipherStage::TRANSPOSE:
+		return "transpose";
+	case CipherStage::UNTRANSPOSE:
+		return "untranspose";
+	case CipherStage::INVERT_SUBSTITUTE:
+		return "invert_substitute";
+	case CipherStage::INPUT:
+		return "input";
+	case CipherStage::OUTPUT:
+		return "output";
+	case CipherStage::ENCRYPT:
+		return "encrypt";
+	case CipherStage::DECRYPT:
+		return "decrypt";
+	default:
+		return "unknown";
+	}
+}
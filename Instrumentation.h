@@ -0,0 +1,176 @@
+/*
+Author:			My Tran
+Filename:		Instrumentation.h
+Description:	This file provides the declarations of the Instrumentation class, which records how long each stage of the
+cipher takes so a slow encryption tier can be traced to substitution, transposition, normalization or I/O. Every stage
+keeps a latency histogram with power of two buckets of nanoseconds along with the bytes it handled, and the whole program
+keeps the number of messages, bytes and heap allocations. The counters are atomic, so every thread of a ParallelCipher
+records into the same totals.
+
+Recording is compiled out unless ENCRYPTOR_INSTRUMENTATION is defined when building every file, in which case the
+INSTRUMENT_ macros below time the code they are placed in. Without it the macros expand to nothing and the stats stay at
+zero, so the hot paths carry no cost. The stats can be read as a CipherStats or written as JSON or in the Prometheus text
+format either way.
+*/
+#pragma once
+#include<atomic>
+#include<chrono>
+#include<cstddef>
+#include<cstdint>
+#include<iostream>
+
+//stages of the cipher that are timed
+enum class CipherStage
+{
+	KEY_SCHEDULE,	//building the tables and key stream of a key
+	NORMALIZE,	//removing whitespace and making letters lower case
+	SUBSTITUTE,	//affine/vigenere substitution
+	TRANSPOSE,	//filling, reordering and reading out the rows of the matrix
+	UNTRANSPOSE,	//putting the rows of the matrix back in order
+	INVERT_SUBSTITUTE,	//undoing the substitution
+	INPUT,	//reading text
+	OUTPUT,	//writing results
+	ENCRYPT,	//a whole message being encrypted
+	DECRYPT,	//a whole message being decrypted
+	COUNT	//number of stages, not a stage
+};
+
+const size_t STAGE_COUNT = (size_t)CipherStage::COUNT;	//number of stages timed
+const size_t HISTOGRAM_BUCKETS = 36;	//bucket i counts latencies under 2^i nanoseconds, the last one everything else
+
+//snapshot of one stage
+struct StageStats
+{
+	uint64_t calls = 0;	//times the stage ran
+	uint64_t bytes = 0;	//bytes the stage handled
+	uint64_t totalNanoseconds = 0;	//time spent in the stage
+	uint64_t buckets[HISTOGRAM_BUCKETS] = {};	//latency histogram, not cumulative
+};
+
+//snapshot of everything recorded
+struct CipherStats
+{
+	StageStats stages[STAGE_COUNT];	//one entry per CipherStage
+	uint64_t messages = 0;	//messages encrypted or decrypted
+	uint64_t bytes = 0;	//bytes of the messages
+	uint64_t allocations = 0;	//heap allocations made by the program
+	double seconds = 0;	//time since the stats started or were reset
+	double messagesPerSecond = 0;	//messages divided by seconds
+	double bytesPerSecond = 0;	//bytes divided by seconds
+};
+
+class Instrumentation
+{
+	public:
+		/*
+		Purpose:		Adds one run of a stage to its histogram.
+		Pre-condition:	Takes the stage, how long it took and the bytes it handled, which is 0 for reads whose size is only
+						known once they finish. The bytes read are counted by the normalization that follows them.
+		Post-condition:	None
+		*/
+		static void recordStage(CipherStage, uint64_t, size_t);
+
+		/*
+		Purpose:		Counts a message that was encrypted or decrypted.
+		Pre-condition:	Takes the length of the message.
+		Post-condition:	None
+		*/
+		static void recordMessage(size_t);
+
+		/*
+		Purpose:		Counts a heap allocation.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		static void recordAllocation();
+
+		/*
+		Purpose:		Takes a snapshot of everything recorded.
+		Pre-condition:	None
+		Post-condition:	Returns the stats. Counters updated while the snapshot is taken may or may not be in it.
+		*/
+		static CipherStats getStats();
+
+		/*
+		Purpose:		Sets every counter back to zero and restarts the clock used for rates.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		static void reset();
+
+		/*
+		Purpose:		Writes the stats as a JSON object.
+		Pre-condition:	Takes the stream to write to.
+		Post-condition:	The stats are written.
+		*/
+		static void writeJson(std::ostream&);
+
+		/*
+		Purpose:		Writes the stats in the Prometheus text exposition format.
+		Pre-condition:	Takes the stream to write to.
+		Post-condition:	The stats are written.
+		*/
+		static void writePrometheus(std::ostream&);
+
+		static const char* getStageName(CipherStage);	//returns the name of a stage as used in the dumps
+
+		//returns true if the program was built with ENCRYPTOR_INSTRUMENTATION
+		static constexpr bool isEnabled()
+		{
+#ifdef ENCRYPTOR_INSTRUMENTATION
+			return true;
+#else
+			return false;
+#endif
+		}
+	private:
+		//counters of one stage, kept on their own cache lines so threads timing different stages do not collide
+		struct alignas(64) StageCounters
+		{
+			std::atomic<uint64_t> calls;
+			std::atomic<uint64_t> bytes;
+			std::atomic<uint64_t> totalNanoseconds;
+			std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+		};
+
+		//private data members
+		static StageCounters stages[STAGE_COUNT];	//counters of every stage
+		static std::atomic<uint64_t> messages;	//messages encrypted or decrypted
+		static std::atomic<uint64_t> bytes;	//bytes of the messages
+		static std::atomic<uint64_t> allocations;	//heap allocations
+		static std::atomic<int64_t> startTime;	//steady clock time in nanoseconds when the stats started or were reset
+};
+
+//times the scope it is created in as one run of a stage
+class StageTimer
+{
+	public:
+		StageTimer(CipherStage stage, size_t bytes) : stage(stage), bytes(bytes), start(std::chrono::steady_clock::now())
+		{
+		}
+
+		~StageTimer()
+		{
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			Instrumentation::recordStage(stage, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), bytes);
+		}
+
+		StageTimer(const StageTimer&) = delete;
+		StageTimer& operator=(const StageTimer&) = delete;
+	private:
+		CipherStage stage;	//stage being timed
+		size_t bytes;	//bytes the stage handles
+		std::chrono::steady_clock::time_point start;	//when the scope was entered
+};
+
+#ifdef ENCRYPTOR_INSTRUMENTATION
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+//times the rest of the enclosing scope as one run of a stage handling a number of bytes
+#define INSTRUMENT_STAGE(stage, bytes) StageTimer INSTRUMENT_CONCAT(stageTimer, __LINE__)((stage), (bytes))
+//counts one message of a number of bytes
+#define INSTRUMENT_MESSAGE(bytes) Instrumentation::recordMessage(bytes)
+#else
+#define INSTRUMENT_STAGE(stage, bytes) ((void)0)
+#define INSTRUMENT_MESSAGE(bytes) ((void)0)
+#endif
@@ -0,0 +1,130 @@
+/*
+Author:			My Tran
+Filename:		KeySchedule.cpp
+Description:	This file implements the header file KeySchedule.h providing the definitions for the methods of the
+KeySchedule class.
+*/
+#include "KeySchedule.h"
+#include "CipherEngine.h"
+#include "Transposition.h"
+#include<cstdint>
+#include<sstream>
+#include<vector>
+
+const size_t PICKED_WORD_BITS = 64;	//number of rows tracked by each word of the picked set
+const size_t MAX_TRACKED_ROWS = 4096;	//largest permutation that is checked with a picked set kept on the stack
+
+KeySchedule::KeySchedule(const CipherKey& key)
+	: key(key), status(validate()), substitution(key.keyNum, key.keyPhrase)
+{
+}
+
+CipherStatus KeySchedule::getStatus() const
+{
+	return status;
+}
+
+CipherStatus KeySchedule::validateLength(size_t length, size_t rowWidth) const
+{
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	return fitsLength(key.permutation, length, rowWidth) ? CipherStatus::OK : CipherStatus::INVALID_PERMUTATION;
+}
+
+bool KeySchedule::fitsLength(const std::vector<int>& permutation, size_t length, size_t rowWidth)
+{
+	//every row but the bottom one, which may be incomplete, gets reordered
+	return permutation.size() == Transposition::calcOccupiedRows(length, rowWidth) - 1;
+}
+
+const CipherKey& KeySchedule::getKey() const
+{
+	return key;
+}
+
+const Substitution& KeySchedule::getSubstitution() const
+{
+	return substitution;
+}
+
+CipherStatus KeySchedule::validate() const
+{
+	if (!CipherEngine::isValidKeyNum(key.keyNum))
+	{
+		return CipherStatus::INVALID_KEY_NUM;
+	}
+
+	if (key.keyPhrase.empty() || !CipherEngine::isLowerCase(key.keyPhrase))
+	{
+		return CipherStatus::INVALID_KEY_PHRASE;
+	}
+
+	if (!isPermutation(key.permutation))
+	{
+		return CipherStatus::INVALID_PERMUTATION;
+	}
+
+	return CipherStatus::OK;
+}
+
+bool KeySchedule::isPermutation(const std::vector<int>& permutation)
+{
+	size_t rows = permutation.size();
+
+	if (rows <= MAX_TRACKED_ROWS)
+	{
+		//set of rows already used, kept on the stack so that validation does not allocate
+		uint64_t picked[MAX_TRACKED_ROWS / PICKED_WORD_BITS] = {};
+
+		for (int row : permutation)
+		{
+			if (row < 0 || (size_t)row >= rows || (picked[row / PICKED_WORD_BITS] >> (row % PICKED_WORD_BITS)) & 1)
+			{
+				return false;
+			}
+
+			picked[row / PICKED_WORD_BITS] |= (uint64_t)1 << (row % PICKED_WORD_BITS);
+		}
+
+		return true;
+	}
+
+	//larger permutations, such as one read from a key file, keep the same set on the heap
+	std::vector<bool> picked(rows, false);
+
+	for (int row : permutation)
+	{
+		if (row < 0 || (size_t)row >= rows || picked[row])
+		{
+			return false;
+		}
+
+		picked[row] = true;
+	}
+
+	return true;
+}
+
+bool KeySchedule::parsePermutation(std::string text, std::vector<int>& permutation)
+{
+	for (char& letter : text)
+	{
+		if (letter == ',')
+		{
+			letter = ' ';
+		}
+	}
+
+	std::istringstream rows(text);
+	permutation.clear();
+
+	for (int row = 0; rows >> row;)
+	{
+		permutation.push_back(row);
+	}
+
+	return rows.eof();
+}
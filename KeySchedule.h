@@ -0,0 +1,81 @@
+/*
+Author:			My Tran
+Filename:		KeySchedule.h
+Description:	This file provides the declarations of the KeySchedule class. A KeySchedule validates a CipherKey once and
+holds everything derived from it: the inverse of keyNum, the expanded key stream and the 26 x 26 substitution tables.
+Messages encrypted or decrypted with the same key can then share one KeySchedule instead of repeating the setup.
+*/
+#pragma once
+#include<cstddef>
+#include<string>
+#include<vector>
+#include "CipherKey.h"
+#include "Substitution.h"
+
+class KeySchedule
+{
+	public:
+		/*
+		Purpose:		Validates a key and builds the material derived from it.
+		Pre-condition:	Takes the key. The key is not copied and must outlive the KeySchedule.
+		Post-condition:	getStatus() reports whether the key can be used.
+		*/
+		KeySchedule(const CipherKey&);
+
+		//the schedule refers to its key and its substitution may refer to the key phrase, so it is never copied
+		KeySchedule(const KeySchedule&) = delete;
+		KeySchedule& operator=(const KeySchedule&) = delete;
+
+		/*
+		Purpose:		Reports whether the key passed validation.
+		Pre-condition:	None
+		Post-condition:	Returns OK if the key is usable, otherwise the status describing the first problem found.
+		*/
+		CipherStatus getStatus() const;
+
+		/*
+		Purpose:		Checks that the key can be used on a message of the given length.
+		Pre-condition:	Takes the length of the message and the row width of its matrix, or 0 for the least square.
+		Post-condition:	Returns OK if the permutation orders exactly the full rows of a message that long, otherwise the
+						status describing the problem.
+		*/
+		CipherStatus validateLength(size_t, size_t = 0) const;
+
+		/*
+		Purpose:		Determines if a permutation orders the rows of a message of the given length.
+		Pre-condition:	Takes the permutation, the length of the message and the row width of its matrix, or 0 for the
+						least square.
+		Post-condition:	Returns true if it has one entry for every full row, which is every row but the bottom one.
+		*/
+		static bool fitsLength(const std::vector<int>&, size_t, size_t = 0);
+
+		const CipherKey& getKey() const;	//returns the key the schedule was built from
+		const Substitution& getSubstitution() const;	//returns the substitution built for the key
+
+		/*
+		Purpose:		Determines if a permutation uses each number from 0 to its size - 1 exactly once.
+		Pre-condition:	Takes permutation.
+		Post-condition:	Returns true if it is a permutation. False otherwise.
+		*/
+		static bool isPermutation(const std::vector<int>&);
+
+		/*
+		Purpose:		Reads a permutation such as "2,0,1" or "2 0 1", as written in key files and on the command line.
+		Pre-condition:	Takes the text and the vector the numbers are stored in.
+		Post-condition:	Returns true if every entry was a number. False otherwise. Whether it is a permutation is left
+						to isPermutation.
+		*/
+		static bool parsePermutation(std::string, std::vector<int>&);
+	private:
+		//private data members
+		const CipherKey& key;	//key the schedule was built from
+		CipherStatus status;	//result of validating the key
+		Substitution substitution;	//key stream and substitution tables of the key
+
+		/*
+		Purpose:		Validates every part of the key that does not depend on the message length.
+		Pre-condition:	None
+		Post-condition:	Returns OK if the key is usable, otherwise the status describing the first problem found.
+		*/
+		CipherStatus validate() const;
+};
@@ -0,0 +1,258 @@
+/*
+Author:			My Tran
+Filename:		KeyStore.cpp
+Description:	This file implements the header file KeyStore.h providing the definitions for the methods of the KeyStore
+class.
+*/
+#include "KeyStore.h"
+#include "Normalizer.h"
+#include "Transposition.h"
+#include<fstream>
+#include<sstream>
+
+//a key restricted to the rows of one message shape; the schedule refers to the key, so it is built after it
+struct KeyStore::ShapedKey
+{
+	CipherKey key;	//key with its row combination restricted to the full rows of the shape
+	KeySchedule schedule;	//schedule of the restricted key
+
+	ShapedKey(const CipherKey& shaped)
+		: key(shaped), schedule(key)
+	{
+	}
+};
+
+KeyStore::KeyStore(size_t capacity)
+	: capacity(capacity)
+{
+	errorLine = 0;
+	hits = 0;
+	misses = 0;
+}
+
+CipherStatus KeyStore::load(const std::string& path)
+{
+	errorLine = 0;
+
+	std::ifstream file(path);
+	if (!file)
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	uint32_t id = 0;
+	std::string name;
+	CipherKey key;
+	size_t keyLine = 0;	//line the key being read started on, 0 before the first key
+	size_t number = 0;
+
+	for (std::string line; std::getline(file, line);)
+	{
+		number++;
+
+		std::istringstream fields(line);
+		std::string entry;
+		fields >> entry;
+
+		std::string value;
+		std::getline(fields >> std::ws, value);
+
+		//blank lines and lines starting with # are skipped
+		if (entry.empty() || entry[0] == '#')
+		{
+			continue;
+		}
+
+		bool understood = true;
+
+		if (entry == "key")
+		{
+			//the key before this one is complete and is added first
+			if (keyLine > 0)
+			{
+				CipherStatus status = add(id, name, key);
+				if (status != CipherStatus::OK)
+				{
+					errorLine = keyLine;
+					return status;
+				}
+			}
+
+			std::istringstream header(value);
+			std::string extra;
+			understood = (header >> id >> name) && !(header >> extra) && value[0] != '-';
+			key = CipherKey();
+			keyLine = number;
+		}
+		else if (keyLine == 0)
+		{
+			understood = false;
+		}
+		else if (entry == "keyNum")
+		{
+			std::istringstream digits(value);
+			understood = (digits >> key.keyNum) && digits.eof();
+		}
+		else if (entry == "keyPhrase")
+		{
+			size_t invalidOffset = 0;
+			understood = Normalizer::normalize(value, key.keyPhrase, Normalizer::Whitespace::SPACES, invalidOffset) == CipherStatus::OK;
+		}
+		else if (entry == "permutation")
+		{
+			understood = KeySchedule::parsePermutation(value, key.permutation);
+		}
+		else
+		{
+			understood = false;
+		}
+
+		if (!understood)
+		{
+			errorLine = number;
+			return CipherStatus::INVALID_KEY_FILE;
+		}
+	}
+
+	if (file.bad())
+	{
+		errorLine = number;
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	CipherStatus status = (keyLine > 0) ? add(id, name, key) : CipherStatus::OK;
+	if (status != CipherStatus::OK)
+	{
+		errorLine = keyLine;
+	}
+
+	return status;
+}
+
+CipherStatus KeyStore::add(uint32_t id, const std::string& name, const CipherKey& key)
+{
+	//everything about the key but the message length is checked here, once
+	CipherStatus status = KeySchedule(key).getStatus();
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+
+	if (keys.count(id) > 0 || names.count(name) > 0)
+	{
+		return CipherStatus::DUPLICATE_KEY;
+	}
+
+	keys[id] = StoredKey{ name, key };
+	names[name] = id;
+
+	return CipherStatus::OK;
+}
+
+CipherStatus KeyStore::findId(const std::string& name, uint32_t& id) const
+{
+	std::lock_guard<std::mutex> guard(lock);
+
+	auto found = names.find(name);
+	if (found == names.end())
+	{
+		return CipherStatus::UNKNOWN_KEY;
+	}
+
+	id = found->second;
+
+	return CipherStatus::OK;
+}
+
+CipherStatus KeyStore::getSchedule(uint32_t id, size_t length, std::shared_ptr<const KeySchedule>& schedule, size_t rowWidth)
+{
+	schedule.reset();
+
+	if (length == 0)
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	//the restricted key only depends on the number of full rows, whatever width gave that number
+	size_t rows = Transposition::calcOccupiedRows(length, rowWidth) - 1;
+	uint64_t cacheKey = ((uint64_t)id << 32) | (uint64_t)rows;
+
+	std::lock_guard<std::mutex> guard(lock);
+
+	auto cached = cache.find(cacheKey);
+	if (cached != cache.end())
+	{
+		//the entry moves to the front so the least recently used one is always at the back
+		recent.splice(recent.begin(), recent, cached->second);
+		hits++;
+
+		const std::shared_ptr<const ShapedKey>& shaped = cached->second->second;
+		schedule = std::shared_ptr<const KeySchedule>(shaped, &shaped->schedule);
+		return CipherStatus::OK;
+	}
+
+	auto stored = keys.find(id);
+	if (stored == keys.end())
+	{
+		return CipherStatus::UNKNOWN_KEY;
+	}
+
+	const CipherKey& key = stored->second.key;
+	if (rows > key.permutation.size())
+	{
+		return CipherStatus::INVALID_PERMUTATION;
+	}
+
+	CipherKey restricted;
+	restricted.keyNum = key.keyNum;
+	restricted.keyPhrase = key.keyPhrase;
+	restricted.permutation.reserve(rows);
+	for (int row : key.permutation)
+	{
+		if ((size_t)row < rows)
+		{
+			restricted.permutation.push_back(row);
+		}
+	}
+
+	std::shared_ptr<const ShapedKey> shaped = std::make_shared<const ShapedKey>(restricted);
+	misses++;
+
+	recent.emplace_front(cacheKey, shaped);
+	cache[cacheKey] = recent.begin();
+
+	if (recent.size() > capacity)
+	{
+		cache.erase(recent.back().first);
+		recent.pop_back();
+	}
+
+	schedule = std::shared_ptr<const KeySchedule>(shaped, &shaped->schedule);
+
+	return CipherStatus::OK;
+}
+
+size_t KeyStore::getKeyCount() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return keys.size();
+}
+
+size_t KeyStore::getErrorLine() const
+{
+	return errorLine;
+}
+
+size_t KeyStore::getHits() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return hits;
+}
+
+size_t KeyStore::getMisses() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return misses;
+}
@@ -0,0 +1,106 @@
+/*
+Author:			My Tran
+Filename:		KeyStore.h
+Description:	This file provides the declarations of the KeyStore class. A KeyStore holds named keys, each with a number
+identifying it, loaded from a key store file or added from code. Every key is validated once, when it is added, and the
+schedules built from it are kept in a cache of the most recently used ones, so a batch of many messages under a few keys
+builds each schedule once rather than once per message.
+
+A key's row combination orders the full rows of the longest message it is meant for. A shorter message, with fewer full
+rows, uses the combination restricted to the rows it has, in the same order, the same way the last block of a stream is
+transposed. Schedules are cached by key and number of full rows, since every message length with the same number of
+rows uses the same one. The cache may be used by several threads at once, and a schedule stays usable for as long as
+its caller holds it, even once the cache has dropped it.
+
+Key store file:	one key after another, each starting with a "key <id> <name>" line followed by its "keyNum", "keyPhrase"
+and "permutation" lines, the same as a key file of the command line tool. Blank lines and lines starting with # are
+skipped.
+*/
+#pragma once
+#include<cstddef>
+#include<cstdint>
+#include<list>
+#include<memory>
+#include<mutex>
+#include<string>
+#include<unordered_map>
+#include<utility>
+#include<vector>
+#include "KeySchedule.h"
+
+class KeyStore
+{
+	public:
+		/*
+		Purpose:		Creates an empty key store.
+		Pre-condition:	Takes the most schedules the cache keeps.
+		Post-condition:	None
+		*/
+		KeyStore(size_t = DEFAULT_CACHE_CAPACITY);
+
+		KeyStore(const KeyStore&) = delete;
+		KeyStore& operator=(const KeyStore&) = delete;
+
+		/*
+		Purpose:		Adds every key of a key store file.
+		Pre-condition:	Takes the path of the file.
+		Post-condition:	Returns OK if every key was added. Returns STREAM_ERROR if the file could not be read,
+						INVALID_KEY_FILE if a line is not understood, or the status of add for a key it rejects, and
+						getErrorLine() gives the line of the problem. Keys before the problem are kept.
+		*/
+		CipherStatus load(const std::string&);
+
+		/*
+		Purpose:		Validates a key and adds it to the store.
+		Pre-condition:	Takes the number identifying the key, its name and the key, with a lower case key phrase.
+		Post-condition:	Returns OK if the key was added. Otherwise returns DUPLICATE_KEY if the number or name is taken,
+						or the status of validating the key, and the key is not added.
+		*/
+		CipherStatus add(uint32_t, const std::string&, const CipherKey&);
+
+		/*
+		Purpose:		Finds the number of a key from its name.
+		Pre-condition:	Takes the name and where to store the number.
+		Post-condition:	Returns OK and stores the number, or UNKNOWN_KEY if no key has the name.
+		*/
+		CipherStatus findId(const std::string&, uint32_t&) const;
+
+		/*
+		Purpose:		Gives the schedule of a key for a message length, from the cache when it is there.
+		Pre-condition:	Takes the number identifying the key, the message length, the pointer the schedule is returned
+						in and the row width of the message's matrix, or 0 for the least square.
+		Post-condition:	Returns OK and the schedule, which is ready for a message of that length and row width. Otherwise
+						returns EMPTY_INPUT, UNKNOWN_KEY, or INVALID_PERMUTATION if the message has more full rows than the
+						key's row combination orders, and the pointer is empty.
+		*/
+		CipherStatus getSchedule(uint32_t, size_t, std::shared_ptr<const KeySchedule>&, size_t = 0);
+
+		size_t getKeyCount() const;	//returns the number of keys in the store
+		size_t getErrorLine() const;	//returns the line of the key store file the last load stopped at, 0 if it did not
+		size_t getHits() const;	//returns the number of schedules found in the cache
+		size_t getMisses() const;	//returns the number of schedules built because the cache did not have them
+
+		static constexpr size_t DEFAULT_CACHE_CAPACITY = 256;	//schedules kept in the cache unless another number is given
+	private:
+		struct ShapedKey;	//key restricted to the rows of one message shape, and its schedule
+
+		//a key as it was added
+		struct StoredKey
+		{
+			std::string name;	//name the key was added under
+			CipherKey key;	//the key, with the row combination for its longest message
+		};
+
+		typedef std::pair<uint64_t, std::shared_ptr<const ShapedKey>> CacheEntry;	//cache key and the schedule it holds
+
+		//private data members
+		std::unordered_map<uint32_t, StoredKey> keys;	//every key, by number
+		std::unordered_map<std::string, uint32_t> names;	//number of every key, by name
+		std::list<CacheEntry> recent;	//cached schedules, most recently used first
+		std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cache;	//entry of recent for each cache key
+		mutable std::mutex lock;	//guards the keys and the cache
+		size_t capacity;	//most schedules kept in the cache
+		size_t errorLine;	//line of the key store file the last load stopped at
+		size_t hits;	//schedules found in the cache
+		size_t misses;	//schedules built because the cache did not have them
+};
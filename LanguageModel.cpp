@@ -0,0 +1,173 @@
+/*
+Author:			My Tran
+Filename:		LanguageModel.cpp
+Description:	This file implements the header file LanguageModel.h providing the definitions for the methods of the
+LanguageModel class.
+*/
+#include "LanguageModel.h"
+#include "Normalizer.h"
+#include<cmath>
+#include<string>
+#include<vector>
+
+const double UNSEEN_COUNT = 0.5;	//added to every letter count so a letter missing from the training text is not impossible
+const double CONTEXT_WEIGHT = 4;	//times a context must be seen before its own counts are trusted as much as the ones below
+
+//plain English prose the default statistics are counted from, kept free of punctuation so it normalizes as is
+const char SAMPLE_TEXT[] =
+	"the history of secret writing is almost as old as writing itself and for most of that time the methods were "
+	"simple enough to be done by hand with nothing more than a pencil and a sheet of paper a message was written out "
+	"and then each letter was replaced by another according to a rule that both the sender and the receiver had agreed "
+	"upon before they parted the rule might be as plain as moving every letter three places along the alphabet or it "
+	"might depend on a word that was repeated over the whole message so that the same letter of the text was written "
+	"differently each time it appeared people who tried to read such messages without the key soon learned that the "
+	"language itself gives the secret away because some letters are far more common than others and some pairs of "
+	"letters follow each other again and again while others almost never meet in any word of the language a careful "
+	"reader who counts the letters of a long message can often guess which of them stands for the most common letter "
+	"and from there the rest of the message begins to fall into place one word at a time\n"
+	"when a single alphabet is used the counting is enough on its own but when the key changes from letter to letter "
+	"the reader first has to find out how long the key word is this can be done by taking every second letter or every "
+	"third letter and so on and asking whether the letters picked out in this way look like a single shifted alphabet "
+	"if the guess about the length is right each group of letters will have the uneven spread of an ordinary language "
+	"and if it is wrong the groups will look flat and random the same idea works when the letters have also been moved "
+	"around in blocks as long as the blocks are large enough that most of the text keeps its order within them\n"
+	"moving the letters around is the other great family of methods a message is written into the rows of a square "
+	"and then read out down the columns or the rows are shuffled before they are read so that letters which were next "
+	"to each other end up far apart the letters themselves are not changed at all which means that their counts are "
+	"the same as in the original message and a reader who sees the usual spread of common and rare letters can tell "
+	"at once that the letters have only been moved the work is then to put the rows back in the right order and the "
+	"best guide is again the language because a wrong order breaks words apart at every join while the right order "
+	"makes the ends of the rows run smoothly into the beginnings of the next\n"
+	"putting the two families together gives a much stronger cipher than either one alone since the counting that "
+	"would break the substitution is spoiled by the moving and the joins that would break the moving are hidden by "
+	"the substitution even so a patient reader with a good model of the language and enough time can usually find "
+	"the key because each part of the key can be tested on its own and the number of choices for each part is small "
+	"compared to the number of choices for the whole the computer makes this kind of search very quick since it can "
+	"try many thousands of keys in the time it would take a person to try one and it never grows tired of checking "
+	"whether the letters that come out look like words\n"
+	"in the classroom these ciphers are still useful because they show why a good modern cipher must hide every trace "
+	"of the language it protects students who have broken a simple cipher by hand understand much better what it means "
+	"for a method to be secure and they learn to think about the people who will try to read their messages as well "
+	"as about the people who are meant to read them the same lessons apply to passwords to keys and to the way that "
+	"information is stored and sent over a network where small patterns that seem harmless can tell an attacker a "
+	"great deal about what is being said and who is saying it\n"
+	"the weather had turned cold by the time the train reached the station and the few people waiting on the platform "
+	"were wrapped in heavy coats with their hands in their pockets a boy was selling newspapers near the gate and an "
+	"old man sat on a bench reading a letter that he had clearly read many times before the clock above the ticket "
+	"office showed that it was nearly seven in the evening and the lights of the town were coming on one after another "
+	"along the road that led down to the river where the boats were tied up for the night and the water was quiet\n";
+
+LanguageModel::LanguageModel()
+{
+	train(SAMPLE_TEXT);
+}
+
+CipherStatus LanguageModel::train(std::string_view text)
+{
+	std::string letters(text.length(), ' ');
+	size_t invalidOffset = 0;
+	letters.resize(Normalizer::normalize(text.data(), text.length(), &letters[0], Normalizer::Whitespace::ALL, invalidOffset));
+
+	if (invalidOffset != Normalizer::NO_INVALID)
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	if (letters.length() < 2)
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	const int SIZE = SUBSTITUTION_ALPHABET_SIZE;
+	std::vector<double> letterCounts(SIZE, 0);
+	std::vector<double> pairCounts(SIZE * SIZE, 0);
+	std::vector<double> tripleCounts(SIZE * SIZE * SIZE, 0);
+
+	for (size_t i = 0; i < letters.length(); i++)
+	{
+		int letter = letters[i] - 'a';
+		int pair = (i >= 1) ? (letters[i - 1] - 'a') * SIZE + letter : -1;
+
+		letterCounts[letter]++;
+		if (pair >= 0)
+		{
+			pairCounts[pair]++;
+		}
+		if (i >= 2)
+		{
+			tripleCounts[(letters[i - 2] - 'a') * SIZE * SIZE + pair]++;
+		}
+	}
+
+	//every estimate is mixed with the one below it, trusting it more the more often its context was seen
+	double total = letters.length() + UNSEEN_COUNT * SIZE;
+	for (int first = 0; first < SIZE; first++)
+	{
+		letterScores[first] = (float)((letterCounts[first] + UNSEEN_COUNT) / total);
+	}
+
+	for (int first = 0; first < SIZE; first++)
+	{
+		double followed = 0;
+		for (int second = 0; second < SIZE; second++)
+		{
+			followed += pairCounts[first * SIZE + second];
+		}
+
+		double weight = followed / (followed + CONTEXT_WEIGHT);
+		for (int second = 0; second < SIZE; second++)
+		{
+			double seen = (followed > 0) ? pairCounts[first * SIZE + second] / followed : 0;
+			pairScores[first][second] = (float)(weight * seen + (1 - weight) * letterScores[second]);
+		}
+	}
+
+	for (int first = 0; first < SIZE; first++)
+	{
+		for (int second = 0; second < SIZE; second++)
+		{
+			const double* counts = &tripleCounts[(first * SIZE + second) * SIZE];
+			double followed = 0;
+			for (int third = 0; third < SIZE; third++)
+			{
+				followed += counts[third];
+			}
+
+			double weight = followed / (followed + CONTEXT_WEIGHT);
+			for (int third = 0; third < SIZE; third++)
+			{
+				double seen = (followed > 0) ? counts[third] / followed : 0;
+				tripleScores[first][second][third] = (float)std::log(weight * seen + (1 - weight) * pairScores[second][third]);
+			}
+		}
+	}
+
+	//the lower estimates were kept as probabilities until every mix was made
+	for (int first = 0; first < SIZE; first++)
+	{
+		letterScores[first] = (float)std::log(letterScores[first]);
+		for (int second = 0; second < SIZE; second++)
+		{
+			pairScores[first][second] = (float)std::log(pairScores[first][second]);
+		}
+	}
+
+	return CipherStatus::OK;
+}
+
+double LanguageModel::score(const char* text, size_t length) const
+{
+	double total = (length >= 2) ? pairScores[text[0] - 'a'][text[1] - 'a'] : 0;
+
+	for (size_t i = 2; i < length; i++)
+	{
+		total += tripleScores[text[i - 2] - 'a'][text[i - 1] - 'a'][text[i] - 'a'];
+	}
+
+	return total;
+}
+
+std::string_view LanguageModel::getSampleText()
+{
+	return SAMPLE_TEXT;
+}
@@ -0,0 +1,64 @@
+/*
+Author:			My Tran
+Filename:		LanguageModel.h
+Description:	This file provides the declarations of the LanguageModel class. A LanguageModel holds the log probability of
+every letter, of every letter following another and of every letter following a pair of letters, which is how the
+cryptanalyzer tells English from the output of a wrong key. The statistics are counted from lower case letters with no
+spaces between words, the same form the cipher works on, and triples seen rarely lean on the statistics of the pair and
+the single letter so a small sample still gives usable scores. A model made without training text uses a sample of
+English built into the program; a larger corpus can be given to train() for better scores.
+*/
+#pragma once
+#include<cstddef>
+#include<string_view>
+#include "CipherKey.h"
+#include "Substitution.h"
+
+class LanguageModel
+{
+	public:
+		/*
+		Purpose:		Creates a model from the sample of English built into the program.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		LanguageModel();
+
+		/*
+		Purpose:		Replaces the statistics with the ones counted from a corpus.
+		Pre-condition:	Takes text as typed or read. Whitespace is left out and letters are made lower case.
+		Post-condition:	Returns OK, EMPTY_INPUT if the text has fewer than two letters, or INVALID_CHARACTER if it has a
+						character other than letters and whitespace. The statistics are unchanged unless it is OK.
+		*/
+		CipherStatus train(std::string_view);
+
+		/*
+		Purpose:		Scores lower case text by how likely each letter is to follow the two before it.
+		Pre-condition:	Takes the text and its length.
+		Post-condition:	Returns the sum of the log probabilities of every letter after the first, higher for text closer to
+						the training text.
+		*/
+		double score(const char*, size_t) const;
+
+		float getLetterScore(int letter) const	//returns the log probability of a letter from 0 to 25
+		{
+			return letterScores[letter];
+		}
+
+		float getPairScore(int first, int second) const	//returns the log probability of second following first
+		{
+			return pairScores[first][second];
+		}
+
+		float getTripleScore(int first, int second, int third) const	//returns the log probability of third following the others
+		{
+			return tripleScores[first][second][third];
+		}
+
+		static std::string_view getSampleText();	//returns the sample of English the default model is counted from
+	private:
+		//private data members
+		float letterScores[SUBSTITUTION_ALPHABET_SIZE];	//log probability of each letter
+		float pairScores[SUBSTITUTION_ALPHABET_SIZE][SUBSTITUTION_ALPHABET_SIZE];	//log probability of [first][second]
+		float tripleScores[SUBSTITUTION_ALPHABET_SIZE][SUBSTITUTION_ALPHABET_SIZE][SUBSTITUTION_ALPHABET_SIZE];	//[first][second][third]
+};
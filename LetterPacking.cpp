@@ -0,0 +1,127 @@
+/*
+Author:			My Tran
+Filename:		LetterPacking.cpp
+Description:	This file implements the header file LetterPacking.h providing the definitions for the methods of the
+LetterPacking class.
+*/
+#include "LetterPacking.h"
+#include<cstdint>
+#include<cstring>
+
+//a 64 bit load puts the first letter of a group in the lowest byte only on little endian machines
+#if defined(__x86_64__) || defined(_M_X64)
+#define PACKING_WORDS
+#endif
+
+const uint64_t LETTER_MASK = 0x1F;	//bits of one packed letter
+const int ASCII_VAL_LOWER_A = 97;	//ascii value for lowercase a
+
+#ifdef PACKING_WORDS
+const uint64_t EVERY_BYTE = 0x0101010101010101;	//multiplying a byte by this repeats it in every byte of a word
+#endif
+
+size_t LetterPacking::calcPackedSize(size_t letters)
+{
+	return (letters / GROUP_LETTERS) * GROUP_BYTES + ((letters % GROUP_LETTERS) * LETTER_BITS + 7) / 8;
+}
+
+void LetterPacking::pack(const char* letters, size_t count, unsigned char* packed)
+{
+	size_t i = 0;
+
+#ifdef PACKING_WORDS
+	//each step halves the number of fields by sliding every second field down against the one below it: eight 5 bit
+	//values in bytes become four 10 bit values, then two 20 bit values, then one 40 bit value
+	for (; i + GROUP_LETTERS <= count; i += GROUP_LETTERS, packed += GROUP_BYTES)
+	{
+		uint64_t word;
+		std::memcpy(&word, letters + i, sizeof(word));
+
+		word -= EVERY_BYTE * ASCII_VAL_LOWER_A;
+		word = (word & 0x001F001F001F001F) | ((word & 0x1F001F001F001F00) >> 3);
+		word = (word & 0x000003FF000003FF) | ((word & 0x03FF000003FF0000) >> 6);
+		word = (word & 0x00000000000FFFFF) | ((word & 0x000FFFFF00000000) >> 12);
+
+		//while another group follows, the three bytes of 0 stored past this group are overwritten by the next one
+		if (i + 2 * GROUP_LETTERS <= count)
+		{
+			std::memcpy(packed, &word, sizeof(word));
+		}
+		else
+		{
+			std::memcpy(packed, &word, GROUP_BYTES);
+		}
+	}
+#endif
+
+	//the remaining letters are packed a bit at a time, which any machine can do
+	uint64_t bits = 0;
+	int filled = 0;
+	for (; i < count; i++)
+	{
+		bits |= (uint64_t)(letters[i] - ASCII_VAL_LOWER_A) << filled;
+		filled += LETTER_BITS;
+
+		if (filled >= 8 * (int)GROUP_BYTES)
+		{
+			for (size_t b = 0; b < GROUP_BYTES; b++)
+			{
+				*packed++ = (unsigned char)(bits >> (8 * b));
+			}
+			bits = 0;
+			filled = 0;
+		}
+	}
+
+	for (; filled > 0; filled -= 8)
+	{
+		*packed++ = (unsigned char)bits;
+		bits >>= 8;
+	}
+}
+
+void LetterPacking::unpack(const unsigned char* packed, size_t count, char* letters)
+{
+	size_t i = 0;
+
+#ifdef PACKING_WORDS
+	//the steps of pack in reverse, spreading one 40 bit value back out into eight bytes; a whole word is loaded while
+	//another group follows to keep it inside the packed bytes, and only the last group is loaded a byte at a time
+	for (; i + GROUP_LETTERS <= count; i += GROUP_LETTERS, packed += GROUP_BYTES)
+	{
+		uint64_t word = 0;
+		if (i + 2 * GROUP_LETTERS <= count)
+		{
+			std::memcpy(&word, packed, sizeof(word));
+			word &= 0x000000FFFFFFFFFF;
+		}
+		else
+		{
+			std::memcpy(&word, packed, GROUP_BYTES);
+		}
+
+		word = (word & 0x00000000000FFFFF) | ((word & 0x000000FFFFF00000) << 12);
+		word = (word & 0x000003FF000003FF) | ((word & 0x000FFC00000FFC00) << 6);
+		word = (word & 0x001F001F001F001F) | ((word & 0x03E003E003E003E0) << 3);
+		word += EVERY_BYTE * ASCII_VAL_LOWER_A;
+
+		std::memcpy(letters + i, &word, sizeof(word));
+	}
+#endif
+
+	uint64_t bits = 0;
+	int available = 0;
+	for (; i < count; i++)
+	{
+		//every letter starts a new byte at most once, so topping up a byte at a time is enough
+		while (available < LETTER_BITS)
+		{
+			bits |= (uint64_t)*packed++ << available;
+			available += 8;
+		}
+
+		letters[i] = (char)((bits & LETTER_MASK) + ASCII_VAL_LOWER_A);
+		bits >>= LETTER_BITS;
+		available -= LETTER_BITS;
+	}
+}
@@ -0,0 +1,42 @@
+/*
+Author:			My Tran
+Filename:		LetterPacking.h
+Description:	This file provides the declarations of the LetterPacking class. The cipher only ever reads and writes the
+26 lower case letters, which fit in 5 bits, so text can be stored packed at 5 bits a letter instead of one byte, taking
+37.5% less space. Every 8 letters are packed into 5 bytes, letter i of the group in bits 5i to 5i + 4 counting from the
+lowest bit of the first byte, and a last group of fewer letters takes only the bytes its bits reach. On 64 bit x86 a
+whole group is packed or unpacked with a few shifts and masks of one 64 bit word, so converting costs far less than the
+cipher itself, and the cipher runs on the unpacked letters.
+*/
+#pragma once
+#include<cstddef>
+
+class LetterPacking
+{
+	public:
+		/*
+		Purpose:		Gives the number of bytes a number of letters takes once packed.
+		Pre-condition:	Takes the number of letters.
+		Post-condition:	Returns ceil(letters * 5 / 8).
+		*/
+		static size_t calcPackedSize(size_t);
+
+		/*
+		Purpose:		Packs lower case letters at 5 bits a letter.
+		Pre-condition:	Takes the letters, which must all be lower case, their number and a buffer of calcPackedSize bytes.
+		Post-condition:	The packed letters are stored in the buffer. Bits past the last letter are 0.
+		*/
+		static void pack(const char*, size_t, unsigned char*);
+
+		/*
+		Purpose:		Unpacks letters packed by pack.
+		Pre-condition:	Takes the packed bytes, the number of letters they hold and a buffer of that many letters.
+		Post-condition:	The letters are stored in the buffer. A damaged 5 bit value of 26 or more comes out as a character
+						after 'z', which the cipher rejects as an invalid character.
+		*/
+		static void unpack(const unsigned char*, size_t, char*);
+
+		static constexpr size_t GROUP_LETTERS = 8;	//letters packed together
+		static constexpr size_t GROUP_BYTES = 5;	//bytes a full group of letters is packed into
+		static constexpr int LETTER_BITS = 5;	//bits each letter takes
+};
@@ -0,0 +1,277 @@
+/*
+Author:			My Tran
+Filename:		MappedFile.cpp
+Description:	This file implements the header file MappedFile.h providing the definitions for the methods of the
+MappedFile class using memory mapping on Windows and on POSIX systems.
+*/
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include<windows.h>
+#else
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	data = nullptr;
+	size = 0;
+	writable = false;
+#ifdef _WIN32
+	file = INVALID_HANDLE_VALUE;
+	mapping = nullptr;
+#else
+	descriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+bool MappedFile::openRead(const std::string& path)
+{
+	close();
+
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	LARGE_INTEGER fileSize;
+	if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize))
+	{
+		close();
+		return false;
+	}
+
+	size = (size_t)fileSize.QuadPart;
+
+	//a mapping cannot be made of an empty file, and there is nothing to read anyway
+	if (size == 0)
+	{
+		return true;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	data = (mapping != nullptr) ? (char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+	if (data == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool MappedFile::create(const std::string& path, size_t size, bool& opened)
+{
+	close();
+
+	file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	opened = (file != INVALID_HANDLE_VALUE);
+	if (!opened)
+	{
+		return false;
+	}
+
+	this->size = size;
+	writable = true;
+
+	if (size == 0)
+	{
+		return true;
+	}
+
+	//mapping a larger size than the file has grows the file to that size
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)((unsigned long long)size >> 32), (DWORD)size, nullptr);
+	data = (mapping != nullptr) ? (char*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0) : nullptr;
+
+	if (data == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool MappedFile::close()
+{
+	bool written = true;
+
+	if (data != nullptr)
+	{
+		written = !writable || FlushViewOfFile(data, 0);
+		UnmapViewOfFile(data);
+	}
+
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+	}
+
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+	}
+
+	data = nullptr;
+	size = 0;
+	writable = false;
+	mapping = nullptr;
+	file = INVALID_HANDLE_VALUE;
+
+	return written;
+}
+
+bool MappedFile::isSameFile(const std::string& first, const std::string& second)
+{
+	BY_HANDLE_FILE_INFORMATION info[2];
+	const std::string* paths[2] = { &first, &second };
+
+	for (int i = 0; i < 2; i++)
+	{
+		//no access is asked for, only the identity of the file, so a file open elsewhere is still found
+		HANDLE handle = CreateFileA(paths[i]->c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		bool found = GetFileInformationByHandle(handle, &info[i]);
+		CloseHandle(handle);
+		if (!found)
+		{
+			return false;
+		}
+	}
+
+	return info[0].dwVolumeSerialNumber == info[1].dwVolumeSerialNumber &&
+		info[0].nFileIndexHigh == info[1].nFileIndexHigh && info[0].nFileIndexLow == info[1].nFileIndexLow;
+}
+#else
+bool MappedFile::openRead(const std::string& path)
+{
+	close();
+
+	descriptor = open(path.c_str(), O_RDONLY);
+	struct stat status;
+	if (descriptor < 0 || fstat(descriptor, &status) != 0)
+	{
+		close();
+		return false;
+	}
+
+	size = (size_t)status.st_size;
+
+	//a mapping cannot be made of an empty file, and there is nothing to read anyway
+	if (size == 0)
+	{
+		return true;
+	}
+
+	void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (address == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	data = (char*)address;
+
+	//the cipher reads the rows of the message front to back
+	madvise(address, size, MADV_SEQUENTIAL);
+
+	return true;
+}
+
+bool MappedFile::create(const std::string& path, size_t size, bool& opened)
+{
+	close();
+
+	descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	opened = (descriptor >= 0);
+	if (!opened)
+	{
+		return false;
+	}
+
+	this->size = size;
+	writable = true;
+
+	if (size == 0)
+	{
+		return true;
+	}
+
+	//the file is grown to its final size up front so every page of the mapping is backed by it
+	if (ftruncate(descriptor, (off_t)size) != 0)
+	{
+		close();
+		return false;
+	}
+
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	if (address == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	data = (char*)address;
+
+	return true;
+}
+
+bool MappedFile::close()
+{
+	bool written = true;
+
+	if (data != nullptr)
+	{
+		written = !writable || msync(data, size, MS_SYNC) == 0;
+		munmap(data, size);
+	}
+
+	if (descriptor >= 0)
+	{
+		written = (::close(descriptor) == 0) && written;
+	}
+
+	data = nullptr;
+	size = 0;
+	writable = false;
+	descriptor = -1;
+
+	return written;
+}
+
+bool MappedFile::isSameFile(const std::string& first, const std::string& second)
+{
+	struct stat firstInfo;
+	struct stat secondInfo;
+
+	return stat(first.c_str(), &firstInfo) == 0 && stat(second.c_str(), &secondInfo) == 0 &&
+		firstInfo.st_dev == secondInfo.st_dev && firstInfo.st_ino == secondInfo.st_ino;
+}
+#endif
+
+char* MappedFile::getData()
+{
+	return data;
+}
+
+const char* MappedFile::getData() const
+{
+	return data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,75 @@
+/*
+Author:			My Tran
+Filename:		MappedFile.h
+Description:	This file provides the declarations of the MappedFile class. MappedFile maps a file into memory, either an
+existing file for reading or a new file of a fixed size for writing, so the cipher can read and write the pages of the
+files directly instead of copying them through streams and strings.
+*/
+#pragma once
+#include<cstddef>
+#include<string>
+
+class MappedFile
+{
+	public:
+		/*
+		Purpose:		Creates a MappedFile with no file mapped.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		MappedFile();
+
+		/*
+		Purpose:		Unmaps and closes the file.
+		Pre-condition:	None
+		Post-condition:	Changes to a file opened with create are written back to it.
+		*/
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/*
+		Purpose:		Maps an existing file for reading.
+		Pre-condition:	Takes the path of the file.
+		Post-condition:	Returns true if the file is mapped. An empty file is mapped with no data.
+		*/
+		bool openRead(const std::string&);
+
+		/*
+		Purpose:		Creates or truncates a file, sets its size and maps it for writing.
+		Pre-condition:	Takes the path of the file, its size and the flag telling whether the file was opened.
+		Post-condition:	Returns true if the file is mapped. The flag is set if the file was created or truncated, even
+						when mapping it failed afterwards, and cleared if the path was left as it was.
+		*/
+		bool create(const std::string&, size_t, bool&);
+
+		/*
+		Purpose:		Unmaps and closes the file if one is mapped.
+		Pre-condition:	None
+		Post-condition:	Returns true if every change was written back to the file.
+		*/
+		bool close();
+
+		/*
+		Purpose:		Determines if two paths name the same existing file, through links or different spellings.
+		Pre-condition:	Takes the two paths.
+		Post-condition:	Returns true if both exist and are the same file.
+		*/
+		static bool isSameFile(const std::string&, const std::string&);
+
+		char* getData();	//returns the first byte of the mapping, or nullptr for an empty file
+		const char* getData() const;	//returns the first byte of the mapping, or nullptr for an empty file
+		size_t getSize() const;	//returns the number of bytes mapped
+	private:
+		//private data members
+		char* data;	//first byte of the mapping
+		size_t size;	//number of bytes mapped
+		bool writable;	//true if the mapping was made by create
+#ifdef _WIN32
+		void* file;	//handle of the open file
+		void* mapping;	//handle of the file mapping
+#else
+		int descriptor;	//descriptor of the open file
+#endif
+};
@@ -0,0 +1,293 @@
+/*
+Author:			My Tran
+Filename:		MessageArchive.cpp
+Description:	This file implements the header file MessageArchive.h providing the definitions for the methods of the
+ArchiveWriter and ArchiveReader classes.
+*/
+#include "MessageArchive.h"
+#include "ByteOrder.h"
+#include "CipherEngine.h"
+#include "LetterPacking.h"
+#include "Transposition.h"
+#include<algorithm>
+
+const char ARCHIVE_MAGIC[] = "ENCA";	//first four bytes of every archive
+const char INDEX_MAGIC[] = "ENCI";	//last four bytes of every complete archive
+const uint16_t ARCHIVE_VERSION = 1;	//version of the archive format written by ArchiveWriter
+const uint16_t PACKED_FLAG = 1;	//flag of the header set when the ciphertext is packed
+const uint16_t ALIGNED_FLAG = 2;	//flag of the header set when the rows of the matrices are widened to an alignment
+const size_t MAGIC_SIZE = 4;	//bytes in each magic word
+const size_t HEADER_SIZE = 8;	//bytes in the header of the file
+const size_t RECORD_HEADER_SIZE = 28;	//bytes in front of the ciphertext of a record
+const size_t RECORD_FIELDS_SIZE = 20;	//bytes of the record header counted in the size of the rest of the record
+const size_t INDEX_ENTRY_SIZE = 8;	//bytes in each entry of the index
+const size_t FOOTER_SIZE = 20;	//bytes in the footer of the file
+const size_t ARCHIVE_BUFFER_SIZE = 1 << 20;	//bytes the writer buffers before writing to the file
+
+ArchiveWriter::ArchiveWriter()
+{
+	position = 0;
+	packed = false;
+	rowAlignment = 0;
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+	if (file.is_open())
+	{
+		close();
+	}
+}
+
+CipherStatus ArchiveWriter::open(const std::string& path, bool packing, size_t alignment)
+{
+	if (file.is_open())
+	{
+		close();
+	}
+
+	//the buffer is set before the file is opened so the stream uses it
+	fileBuffer.resize(ARCHIVE_BUFFER_SIZE);
+	file.clear();
+	file.rdbuf()->pubsetbuf(fileBuffer.data(), fileBuffer.size());
+	file.open(path, std::ios::binary | std::ios::trunc);
+
+	char header[HEADER_SIZE] = {};
+	std::copy(ARCHIVE_MAGIC, ARCHIVE_MAGIC + MAGIC_SIZE, header);
+	ByteOrder::storeNumber(header + MAGIC_SIZE, ARCHIVE_VERSION, 2);
+	ByteOrder::storeNumber(header + MAGIC_SIZE + 2, (packing ? PACKED_FLAG : 0) | ((alignment > 1) ? ALIGNED_FLAG : 0), 2);
+	file.write(header, HEADER_SIZE);
+
+	offsets.clear();
+	position = HEADER_SIZE;
+	packed = packing;
+	rowAlignment = alignment;
+
+	return file ? CipherStatus::OK : CipherStatus::STREAM_ERROR;
+}
+
+CipherStatus ArchiveWriter::append(uint32_t keyId, std::string_view plaintext, const KeySchedule& schedule)
+{
+	std::string_view ciphertext;
+	CipherStatus status = context.encrypt(plaintext, schedule, ciphertext, Transposition::calcRowWidth(plaintext.length(), rowAlignment));
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	return appendCiphertext(keyId, ciphertext);
+}
+
+CipherStatus ArchiveWriter::appendCiphertext(uint32_t keyId, std::string_view ciphertext)
+{
+	if (ciphertext.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	if (!CipherEngine::isLowerCase(ciphertext))
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	if (!file.is_open() || !file)
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	const char* stored = ciphertext.data();
+	size_t storedSize = ciphertext.length();
+
+	if (packed)
+	{
+		storedSize = LetterPacking::calcPackedSize(ciphertext.length());
+		packedBuffer.resize(storedSize);
+		LetterPacking::pack(ciphertext.data(), ciphertext.length(), packedBuffer.data());
+		stored = (const char*)packedBuffer.data();
+	}
+
+	char header[RECORD_HEADER_SIZE];
+	ByteOrder::storeNumber(header, RECORD_FIELDS_SIZE + storedSize, 8);
+	ByteOrder::storeNumber(header + 8, keyId, 4);
+	ByteOrder::storeNumber(header + 12, ciphertext.length(), 8);
+	size_t rowWidth = Transposition::calcRowWidth(ciphertext.length(), rowAlignment);
+	ByteOrder::storeNumber(header + 20, rowWidth, 4);
+	ByteOrder::storeNumber(header + 24, Transposition::calcOccupiedRows(ciphertext.length(), rowWidth), 4);
+
+	file.write(header, RECORD_HEADER_SIZE);
+	file.write(stored, storedSize);
+	if (!file)
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	offsets.push_back(position);
+	position += RECORD_HEADER_SIZE + storedSize;
+
+	return CipherStatus::OK;
+}
+
+CipherStatus ArchiveWriter::close()
+{
+	if (!file.is_open())
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	char entry[INDEX_ENTRY_SIZE];
+	for (uint64_t offset : offsets)
+	{
+		ByteOrder::storeNumber(entry, offset, INDEX_ENTRY_SIZE);
+		file.write(entry, INDEX_ENTRY_SIZE);
+	}
+
+	char footer[FOOTER_SIZE];
+	ByteOrder::storeNumber(footer, position, 8);
+	ByteOrder::storeNumber(footer + 8, offsets.size(), 8);
+	std::copy(INDEX_MAGIC, INDEX_MAGIC + MAGIC_SIZE, footer + 16);
+	file.write(footer, FOOTER_SIZE);
+
+	file.close();
+
+	return file ? CipherStatus::OK : CipherStatus::STREAM_ERROR;
+}
+
+size_t ArchiveWriter::getRecordCount() const
+{
+	return offsets.size();
+}
+
+ArchiveReader::ArchiveReader()
+{
+	index = nullptr;
+	indexOffset = 0;
+	recordCount = 0;
+	packed = false;
+	aligned = false;
+}
+
+CipherStatus ArchiveReader::open(const std::string& path)
+{
+	index = nullptr;
+	indexOffset = 0;
+	recordCount = 0;
+	packed = false;
+	aligned = false;
+
+	if (!file.openRead(path))
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	const char* data = file.getData();
+	size_t size = file.getSize();
+
+	if (size < HEADER_SIZE + FOOTER_SIZE || !std::equal(ARCHIVE_MAGIC, ARCHIVE_MAGIC + MAGIC_SIZE, data) ||
+		ByteOrder::loadNumber(data + MAGIC_SIZE, 2) != ARCHIVE_VERSION ||
+		(ByteOrder::loadNumber(data + MAGIC_SIZE + 2, 2) & ~(PACKED_FLAG | ALIGNED_FLAG)) != 0)
+	{
+		return CipherStatus::INVALID_ARCHIVE;
+	}
+
+	//the footer must point at an index that fills the space between the records and itself exactly
+	const char* footer = data + size - FOOTER_SIZE;
+	uint64_t offset = ByteOrder::loadNumber(footer, 8);
+	uint64_t count = ByteOrder::loadNumber(footer + 8, 8);
+	uint64_t indexSpace = size - FOOTER_SIZE - HEADER_SIZE;
+
+	if (!std::equal(INDEX_MAGIC, INDEX_MAGIC + MAGIC_SIZE, footer + 16) || offset < HEADER_SIZE ||
+		count > indexSpace / INDEX_ENTRY_SIZE || offset + count * INDEX_ENTRY_SIZE != size - FOOTER_SIZE)
+	{
+		return CipherStatus::INVALID_ARCHIVE;
+	}
+
+	index = data + offset;
+	indexOffset = offset;
+	recordCount = (size_t)count;
+	packed = (ByteOrder::loadNumber(data + MAGIC_SIZE + 2, 2) & PACKED_FLAG) != 0;
+	aligned = (ByteOrder::loadNumber(data + MAGIC_SIZE + 2, 2) & ALIGNED_FLAG) != 0;
+
+	return CipherStatus::OK;
+}
+
+CipherStatus ArchiveReader::read(size_t number, ArchiveRecord& record, std::string_view& ciphertext)
+{
+	ciphertext = std::string_view();
+
+	if (number >= recordCount)
+	{
+		return CipherStatus::NO_SUCH_RECORD;
+	}
+
+	uint64_t offset = ByteOrder::loadNumber(index + number * INDEX_ENTRY_SIZE, INDEX_ENTRY_SIZE);
+	if (offset < HEADER_SIZE || offset > indexOffset || indexOffset - offset < RECORD_HEADER_SIZE)
+	{
+		return CipherStatus::INVALID_ARCHIVE;
+	}
+
+	const char* header = file.getData() + offset;
+	uint64_t recordSize = ByteOrder::loadNumber(header, 8);
+	record.keyId = (uint32_t)ByteOrder::loadNumber(header + 8, 4);
+	record.length = ByteOrder::loadNumber(header + 12, 8);
+	record.matrixSize = (uint32_t)ByteOrder::loadNumber(header + 20, 4);
+	record.occupiedRows = (uint32_t)ByteOrder::loadNumber(header + 24, 4);
+
+	//the shape is stored so readers need not work it out, but a record whose shape disagrees with its length is damaged;
+	//only an archive with aligned rows may have a row width other than the least square
+	uint64_t space = indexOffset - offset - RECORD_HEADER_SIZE;
+	uint64_t storedSize = packed ? LetterPacking::calcPackedSize((size_t)record.length) : record.length;
+	if (record.length == 0 || storedSize > space || recordSize != RECORD_FIELDS_SIZE + storedSize ||
+		record.matrixSize == 0 || (!aligned && record.matrixSize != (uint32_t)Transposition::calcMatrixSize((size_t)record.length)) ||
+		record.occupiedRows != Transposition::calcOccupiedRows((size_t)record.length, record.matrixSize))
+	{
+		return CipherStatus::INVALID_ARCHIVE;
+	}
+
+	if (packed)
+	{
+		letters.resize((size_t)record.length);
+		LetterPacking::unpack((const unsigned char*)header + RECORD_HEADER_SIZE, letters.length(), &letters[0]);
+		ciphertext = letters;
+	}
+	else
+	{
+		ciphertext = std::string_view(header + RECORD_HEADER_SIZE, (size_t)record.length);
+	}
+
+	return CipherStatus::OK;
+}
+
+CipherStatus ArchiveReader::decrypt(size_t number, const KeySchedule& schedule, std::string& plaintext)
+{
+	ArchiveRecord record;
+	std::string_view ciphertext;
+	CipherStatus status = read(number, record, ciphertext);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	plaintext.resize(ciphertext.length());
+	status = CipherEngine::decrypt(ciphertext, schedule, &plaintext[0], record.matrixSize);
+	if (status != CipherStatus::OK)
+	{
+		plaintext.clear();
+	}
+
+	return status;
+}
+
+size_t ArchiveReader::getRecordCount() const
+{
+	return recordCount;
+}
+
+bool ArchiveReader::isPacked() const
+{
+	return packed;
+}
+
+bool ArchiveReader::isAligned() const
+{
+	return aligned;
+}
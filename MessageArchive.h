@@ -0,0 +1,156 @@
+/*
+Author:			My Tran
+Filename:		MessageArchive.h
+Description:	This file provides the declarations of the ArchiveWriter and ArchiveReader classes. An archive packs many
+encrypted messages into one binary file. Every record carries the length and matrix shape of its message along with a
+number identifying its key, so a reader never has to guess the shape from the length, and an index at the end of the
+file lets a reader go straight to any record without scanning the ones before it. The reader maps the file into memory
+and hands back each ciphertext as a view into the mapping. An archive may instead store its ciphertext packed at 5 bits
+a letter with LetterPacking, taking 37.5% less space, in which case the reader unpacks each record it is asked for, and
+may widen the rows of each matrix to a multiple of an alignment with Transposition::calcRowWidth, in which case the row
+width stored in each record is the one its ciphertext was encrypted with.
+
+Archive format:	Every number is stored little endian.
+
+	header	"ENCA", version (2 bytes), flags (2 bytes, 1 if the ciphertext is packed, 2 if the rows are aligned)
+	record	size of the rest of the record (8 bytes), key id (4 bytes), message length (8 bytes), row width (4 bytes),
+			occupied rows (4 bytes), followed by the ciphertext, or LetterPacking::calcPackedSize(length) bytes of it
+			packed
+	index	position in the file of each record (8 bytes each), in the order they were added
+	footer	position of the index (8 bytes), number of records (8 bytes), "ENCI"
+*/
+#pragma once
+#include<cstddef>
+#include<cstdint>
+#include<fstream>
+#include<string>
+#include<string_view>
+#include<vector>
+#include "CipherContext.h"
+#include "MappedFile.h"
+
+//what a record says about its message
+struct ArchiveRecord
+{
+	uint32_t keyId = 0;	//number the writer gave the key the message was encrypted with
+	uint64_t length = 0;	//number of letters in the message
+	uint32_t matrixSize = 0;	//row width of the matrix of the transposition, the least square unless the rows are aligned
+	uint32_t occupiedRows = 0;	//number of rows of the matrix that hold letters
+};
+
+class ArchiveWriter
+{
+	public:
+		/*
+		Purpose:		Creates a writer with no archive open.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		ArchiveWriter();
+
+		/*
+		Purpose:		Finishes the archive if one is still open.
+		Pre-condition:	None
+		Post-condition:	The index and footer are written.
+		*/
+		~ArchiveWriter();
+
+		ArchiveWriter(const ArchiveWriter&) = delete;
+		ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+		/*
+		Purpose:		Creates or truncates an archive and writes its header.
+		Pre-condition:	Takes the path of the file, whether to store the ciphertext packed at 5 bits a letter, and the
+						alignment the rows of every matrix are widened to, 0 for the least square.
+		Post-condition:	Returns OK if the file is ready for records, STREAM_ERROR otherwise.
+		*/
+		CipherStatus open(const std::string&, bool = false, size_t = 0);
+
+		/*
+		Purpose:		Encrypts a message and adds it to the archive.
+		Pre-condition:	Takes the number identifying the key, lower case plaintext and the schedule of the key, which must
+						order the full rows of the matrix of Transposition::calcRowWidth(length, alignment).
+		Post-condition:	Returns OK if the record was written. Otherwise returns the status of CipherEngine::encrypt or
+						STREAM_ERROR, and no record is added.
+		*/
+		CipherStatus append(uint32_t, std::string_view, const KeySchedule&);
+
+		/*
+		Purpose:		Adds a message that was encrypted already.
+		Pre-condition:	Takes the number identifying the key and lower case ciphertext, encrypted with the row width of
+						Transposition::calcRowWidth(length, alignment).
+		Post-condition:	Returns OK if the record was written. Otherwise returns EMPTY_INPUT, INVALID_CHARACTER or
+						STREAM_ERROR, and no record is added.
+		*/
+		CipherStatus appendCiphertext(uint32_t, std::string_view);
+
+		/*
+		Purpose:		Writes the index and footer and closes the archive.
+		Pre-condition:	None
+		Post-condition:	Returns OK if the archive is complete, STREAM_ERROR if it could not be written or none is open.
+		*/
+		CipherStatus close();
+
+		size_t getRecordCount() const;	//returns the number of records added since the archive was opened
+	private:
+		//private data members
+		std::ofstream file;	//archive being written
+		std::vector<char> fileBuffer;	//buffer of the file stream, so records are written in large pieces
+		std::vector<uint64_t> offsets;	//position in the file of each record, written out as the index
+		std::vector<unsigned char> packedBuffer;	//ciphertext of the record being written, once packed
+		uint64_t position;	//position in the file the next record starts at
+		bool packed;	//true if the ciphertext is stored packed
+		size_t rowAlignment;	//alignment the rows of every matrix are widened to, 0 for the least square
+		CipherContext context;	//scratch space messages are encrypted in
+};
+
+class ArchiveReader
+{
+	public:
+		/*
+		Purpose:		Creates a reader with no archive open.
+		Pre-condition:	None
+		Post-condition:	None
+		*/
+		ArchiveReader();
+
+		/*
+		Purpose:		Maps an archive and checks its header, footer and index.
+		Pre-condition:	Takes the path of the file.
+		Post-condition:	Returns OK if the archive can be read, STREAM_ERROR if the file could not be mapped, or
+						INVALID_ARCHIVE if it is not a complete archive of a version this reader understands.
+		*/
+		CipherStatus open(const std::string&);
+
+		/*
+		Purpose:		Finds a record through the index.
+		Pre-condition:	Takes the number of the record, counting from 0 in the order they were added, where to store
+						what the record says about its message, and the view the ciphertext is returned in.
+		Post-condition:	Returns OK and stores the record and a view of its ciphertext. The view is into the mapping and stays
+						valid until the reader is opened again or destroyed, or for a packed archive is into the reader's
+						own buffer and stays valid until the next read. Returns NO_SUCH_RECORD if the number is past the
+						last record, or INVALID_ARCHIVE if the record is damaged.
+		*/
+		CipherStatus read(size_t, ArchiveRecord&, std::string_view&);
+
+		/*
+		Purpose:		Finds a record through the index and decrypts it.
+		Pre-condition:	Takes the number of the record, the schedule of its key, which must order the full rows of the
+						record's matrix, and the string the plaintext is stored in.
+		Post-condition:	Returns OK and stores the plaintext. Otherwise returns the status of read or CipherEngine::decrypt.
+		*/
+		CipherStatus decrypt(size_t, const KeySchedule&, std::string&);
+
+		size_t getRecordCount() const;	//returns the number of records in the archive
+		bool isPacked() const;	//returns true if the archive stores its ciphertext packed
+		bool isAligned() const;	//returns true if the rows of the archive's matrices are widened to an alignment
+	private:
+		//private data members
+		MappedFile file;	//archive being read
+		const char* index;	//first entry of the index, inside the mapping
+		uint64_t indexOffset;	//position of the index, where the records end
+		size_t recordCount;	//number of entries in the index
+		bool packed;	//true if the archive stores its ciphertext packed
+		bool aligned;	//true if the rows of the archive's matrices are widened to an alignment
+		std::string letters;	//ciphertext of the last record read from a packed archive, once unpacked
+};
@@ -0,0 +1,79 @@
+/*
+Author:			My Tran
+Filename:		Normalizer.cpp
+Description:	This file implements the header file Normalizer.h providing the definitions for the methods of the
+Normalizer class.
+*/
+#include "Normalizer.h"
+#include "Instrumentation.h"
+#include<array>
+
+const int UPPER_TO_LOWER_CASE_GAP = 32;	//distance between upper to lower in ascii table
+const char INVALID = 0;	//table entry of a byte that may not appear in the text
+const char DROPPED = 1;	//table entry of a byte that is removed from the text
+
+typedef std::array<char, 256> CharacterTable;
+
+/*
+Purpose:		Builds the table giving what each byte becomes.
+Pre-condition:	Takes whether tabs, carriage returns and new lines are dropped along with spaces.
+Post-condition:	Returns the table. Letters map to lower case letters, whitespace to DROPPED and the rest to INVALID.
+*/
+static constexpr CharacterTable makeTable(bool allWhitespace)
+{
+	CharacterTable table = {};
+
+	for (int letter = 'a'; letter <= 'z'; letter++)
+	{
+		table[letter] = (char)letter;
+		table[letter - UPPER_TO_LOWER_CASE_GAP] = (char)letter;
+	}
+
+	table[' '] = DROPPED;
+
+	if (allWhitespace)
+	{
+		table['\t'] = DROPPED;
+		table['\r'] = DROPPED;
+		table['\n'] = DROPPED;
+	}
+
+	return table;
+}
+
+static constexpr CharacterTable SPACES_TABLE = makeTable(false);	//table for text typed at the console
+static constexpr CharacterTable ALL_WHITESPACE_TABLE = makeTable(true);	//table for text read from files
+
+size_t Normalizer::normalize(const char* input, size_t length, char* output, Whitespace whitespace, size_t& invalidOffset)
+{
+	INSTRUMENT_STAGE(CipherStage::NORMALIZE, length);
+
+	const CharacterTable& table = (whitespace == Whitespace::ALL) ? ALL_WHITESPACE_TABLE : SPACES_TABLE;
+	size_t count = 0;
+
+	//every byte is stored, but the count only moves past letters, so dropped bytes are overwritten by the next one
+	for (size_t i = 0; i < length; i++)
+	{
+		char letter = table[(unsigned char)input[i]];
+		output[count] = letter;
+		count += (letter > DROPPED);
+
+		if (letter == INVALID)
+		{
+			invalidOffset = i;
+			return count;
+		}
+	}
+
+	invalidOffset = NO_INVALID;
+	return count;
+}
+
+CipherStatus Normalizer::normalize(std::string_view input, std::string& output, Whitespace whitespace, size_t& invalidOffset)
+{
+	//one allocation large enough for every letter, trimmed to the letters kept
+	output.resize(input.length());
+	output.resize(normalize(input.data(), input.length(), &output[0], whitespace, invalidOffset));
+
+	return (invalidOffset == NO_INVALID) ? CipherStatus::OK : CipherStatus::INVALID_CHARACTER;
+}
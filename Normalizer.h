@@ -0,0 +1,45 @@
+/*
+Author:			My Tran
+Filename:		Normalizer.h
+Description:	This file provides the declarations of the Normalizer class. Normalizer turns typed or read text into the
+lower case letters the cipher works on in a single pass: each byte is looked up in a 256 entry table that gives its lower
+case letter, marks it as whitespace to drop, or marks it as invalid. Letters are compacted into a buffer the caller sized
+beforehand, and the offset of the first invalid byte is reported instead of being handled by the caller character by
+character.
+*/
+#pragma once
+#include<cstddef>
+#include<string>
+#include<string_view>
+#include "CipherKey.h"
+
+class Normalizer
+{
+	public:
+		//which whitespace characters are dropped, anything else other than letters is invalid
+		enum class Whitespace
+		{
+			SPACES,	//only spaces, as in a line typed at the console
+			ALL	//spaces, tabs, carriage returns and new lines, as in a file
+		};
+
+		/*
+		Purpose:		Makes letters lower case and drops whitespace, stopping at the first invalid byte.
+		Pre-condition:	Takes the input, its length, a buffer of at least that length, which may be the input itself, the
+						whitespace to drop, and where to store the offset of the first invalid byte.
+		Post-condition:	Returns the number of letters stored in output. invalidOffset holds the offset of the first invalid
+						byte, and only the letters before it are stored, or NO_INVALID if every byte was a letter or dropped.
+		*/
+		static size_t normalize(const char*, size_t, char*, Whitespace, size_t&);
+
+		/*
+		Purpose:		Normalizes text into a string.
+		Pre-condition:	Takes the input, the string the letters are stored in, the whitespace to drop and where to store the
+						offset of the first invalid byte.
+		Post-condition:	Returns OK and output holds the letters, or INVALID_CHARACTER with invalidOffset set and output
+						holding the letters before it.
+		*/
+		static CipherStatus normalize(std::string_view, std::string&, Whitespace, size_t&);
+
+		static constexpr size_t NO_INVALID = (size_t)-1;	//invalidOffset when every byte was accepted
+};
@@ -0,0 +1,251 @@
+/*
+Author:			My Tran
+Filename:		OnlineDecryptor.cpp
+Description:	This file implements the header file OnlineDecryptor.h providing the definitions for the methods of the
+OnlineDecryptor class.
+*/
+#include "OnlineDecryptor.h"
+#include "CipherEngine.h"
+#include "Instrumentation.h"
+#include "Normalizer.h"
+#include "Transposition.h"
+#include<string>
+
+const size_t CHUNK_SIZE = 65536;	//most raw bytes taken from the input stream at a time
+
+OnlineDecryptor::OnlineDecryptor(const KeySchedule& schedule)
+	: schedule(schedule)
+{
+	length = 0;
+	matrixSize = 0;
+	lastRowLength = 0;
+	received = 0;
+	ready = 0;
+	row = 0;
+	column = 0;
+}
+
+CipherStatus OnlineDecryptor::begin(size_t messageLength)
+{
+	length = 0;
+	received = 0;
+	ready = 0;
+	row = 0;
+	column = 0;
+
+	if (messageLength == 0)
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	CipherStatus status = schedule.validateLength(messageLength);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	const std::vector<int>& permutation = schedule.getKey().permutation;
+	Transposition transposition(messageLength, permutation);
+	size_t rows = transposition.getOccupiedRows();
+
+	matrixSize = transposition.getMatrixSize();
+	lastRowLength = transposition.getRowLength(rows - 1);
+
+	columnStarts.resize(matrixSize);
+	for (size_t c = 0; c < matrixSize; c++)
+	{
+		columnStarts[c] = transposition.getColumnStart(c);
+	}
+
+	//the bottom row is never reordered, so only the full rows are looked up in the permutation
+	rowPlaces.resize(rows);
+	rowPlaces[rows - 1] = rows - 1;
+	for (size_t r = 0; r + 1 < rows; r++)
+	{
+		rowPlaces[permutation[r]] = r;
+	}
+
+	ciphertext.resize(messageLength);
+	plaintext.resize(messageLength);
+	length = messageLength;
+
+	return CipherStatus::OK;
+}
+
+CipherStatus OnlineDecryptor::feed(std::string_view piece, std::string_view& result)
+{
+	result = std::string_view();
+
+	if (piece.length() > length - received)
+	{
+		return CipherStatus::LENGTH_MISMATCH;
+	}
+
+	if (!CipherEngine::isLowerCase(piece))
+	{
+		return CipherStatus::INVALID_CHARACTER;
+	}
+
+	piece.copy(ciphertext.data() + received, piece.length());
+	received += piece.length();
+
+	size_t start = ready;
+
+	//when the last piece completes most of the message at once, the tiled pass of the engine is faster than gathering
+	//letter by letter, and the letters already handed back are only rewritten with the same values
+	if (received == length && ready < length / 2)
+	{
+		Transposition transposition(length, schedule.getKey().permutation);
+		CipherEngine::decryptBlock(ciphertext.data(), 0, schedule.getSubstitution(), transposition, plaintext.data());
+
+		ready = length;
+		row = rowPlaces.size();
+		column = 0;
+		result = std::string_view(plaintext.data() + start, ready - start);
+
+		return CipherStatus::OK;
+	}
+
+	{
+		INSTRUMENT_STAGE(CipherStage::UNTRANSPOSE, piece.length());
+
+		//letters are taken in plaintext order until one is reached that has not arrived yet, since the position of a
+		//letter in the ciphertext only grows along a row
+		size_t bottomRow = rowPlaces.size() - 1;
+		while (ready < length)
+		{
+			size_t position = columnStarts[column] + rowPlaces[row];
+			if (position >= received)
+			{
+				break;
+			}
+
+			plaintext[ready++] = ciphertext[position];
+
+			size_t rowLength = (row < bottomRow) ? matrixSize : lastRowLength;
+			if (++column == rowLength)
+			{
+				row++;
+				column = 0;
+			}
+		}
+	}
+
+	{
+		INSTRUMENT_STAGE(CipherStage::INVERT_SUBSTITUTE, ready - start);
+		schedule.getSubstitution().invert(plaintext.data() + start, start, ready - start, plaintext.data() + start);
+	}
+
+	result = std::string_view(plaintext.data() + start, ready - start);
+
+	return CipherStatus::OK;
+}
+
+CipherStatus OnlineDecryptor::decrypt(std::istream& input, std::ostream& output)
+{
+	std::string magic;
+	int version = 0;
+	size_t messageLength = 0;
+
+	//header is a single line: magic word, version and message length
+	input >> magic >> version >> messageLength;
+	if (!input || input.get() != '\n' || magic != MAGIC || version != VERSION || messageLength > MAX_LENGTH)
+	{
+		return CipherStatus::INVALID_HEADER;
+	}
+
+	CipherStatus status = begin(messageLength);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	return run(input, output);
+}
+
+CipherStatus OnlineDecryptor::writeHeader(std::ostream& output, size_t messageLength)
+{
+	output << MAGIC << " " << VERSION << " " << messageLength << "\n";
+
+	return output ? CipherStatus::OK : CipherStatus::STREAM_ERROR;
+}
+
+size_t OnlineDecryptor::getLength() const
+{
+	return length;
+}
+
+size_t OnlineDecryptor::getReceived() const
+{
+	return received;
+}
+
+size_t OnlineDecryptor::getReady() const
+{
+	return ready;
+}
+
+bool OnlineDecryptor::isComplete() const
+{
+	return length > 0 && ready == length;
+}
+
+CipherStatus OnlineDecryptor::run(std::istream& input, std::ostream& output)
+{
+	chunk.resize(CHUNK_SIZE);
+	letters.resize(CHUNK_SIZE);
+
+	while (true)
+	{
+		size_t count = 0;
+		{
+			INSTRUMENT_STAGE(CipherStage::INPUT, 0);
+
+			//waits for one byte and then takes only what has already arrived behind it, so a slow sender never holds
+			//back plaintext that is ready
+			int first = input.get();
+			if (first == std::char_traits<char>::eof())
+			{
+				break;
+			}
+
+			chunk[0] = (char)first;
+			count = 1 + (size_t)input.readsome(&chunk[1], chunk.size() - 1);
+		}
+
+		size_t invalidOffset = 0;
+		size_t letterCount = Normalizer::normalize(chunk.data(), count, letters.data(), Normalizer::Whitespace::ALL, invalidOffset);
+		if (invalidOffset != Normalizer::NO_INVALID)
+		{
+			return CipherStatus::INVALID_CHARACTER;
+		}
+
+		std::string_view result;
+		CipherStatus status = feed(std::string_view(letters.data(), letterCount), result);
+		if (status != CipherStatus::OK)
+		{
+			return status;
+		}
+
+		if (!result.empty())
+		{
+			INSTRUMENT_STAGE(CipherStage::OUTPUT, result.length());
+			output.write(result.data(), result.length());
+			output.flush();
+
+			if (!output)
+			{
+				return CipherStatus::STREAM_ERROR;
+			}
+		}
+	}
+
+	if (input.bad())
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	INSTRUMENT_MESSAGE(length);
+
+	return isComplete() ? CipherStatus::OK : CipherStatus::LENGTH_MISMATCH;
+}
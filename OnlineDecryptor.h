@@ -0,0 +1,101 @@
+/*
+Author:			My Tran
+Filename:		OnlineDecryptor.h
+Description:	This file provides the declarations of the OnlineDecryptor class. An OnlineDecryptor decrypts a message
+whose length is known before its ciphertext arrives, handing back plaintext as soon as it can be worked out instead of
+waiting for the whole message. The length fixes the shape of the matrix, so the position in the ciphertext of every
+plaintext letter is known up front: letter c of a row lands in column c, one place further along the ciphertext for
+every row stacked above it. Whenever a piece of ciphertext arrives, the longest prefix of the plaintext whose letters
+have all landed is gathered and the substitution is undone on just the letters new to it.
+
+Since the ciphertext is read out column by column, the first letter of the plaintext is ready after only a few letters
+and the prefix then grows by about one letter for every column that lands. The last rows of the plaintext complete
+together as the last columns arrive.
+
+Frame format:	"FRAMED-MESSAGE <version> <length>\n" followed by the ciphertext of the whole message, which may be
+followed by whitespace.
+*/
+#pragma once
+#include<cstddef>
+#include<iostream>
+#include<string_view>
+#include<vector>
+#include "KeySchedule.h"
+
+class OnlineDecryptor
+{
+	public:
+		/*
+		Purpose:		Creates an online decryptor for a key.
+		Pre-condition:	Takes the schedule of the key. The schedule must outlive the OnlineDecryptor.
+		Post-condition:	None
+		*/
+		OnlineDecryptor(const KeySchedule&);
+
+		/*
+		Purpose:		Starts a new message, dropping whatever was left of the last one.
+		Pre-condition:	Takes the length of the message.
+		Post-condition:	Returns OK if the key can decrypt a message that long, otherwise EMPTY_INPUT or the status of
+						KeySchedule::validateLength. The decryptor is ready for the ciphertext only if it is OK.
+		*/
+		CipherStatus begin(size_t);
+
+		/*
+		Purpose:		Takes the next piece of the ciphertext and decrypts every plaintext letter it completes.
+		Pre-condition:	Takes lower case ciphertext following the pieces given before it, and the view the new plaintext
+						is returned in.
+		Post-condition:	Returns OK and the view holds the plaintext letters that became ready, following the ones handed
+						back before them, which may be none. The view stays valid until the next call to begin. Returns
+						INVALID_CHARACTER if the piece is not lower case or LENGTH_MISMATCH if it runs past the length,
+						with the view empty and nothing taken.
+		*/
+		CipherStatus feed(std::string_view, std::string_view&);
+
+		/*
+		Purpose:		Decrypts a framed message from a stream, writing plaintext as soon as it is ready.
+		Pre-condition:	Takes input starting with a frame header and the output stream. Whitespace in the ciphertext
+						is skipped and letters are made lower case.
+		Post-condition:	Returns OK and output holds the plaintext. Otherwise returns the problem found, and output holds
+						every plaintext letter that was ready before it.
+		*/
+		CipherStatus decrypt(std::istream&, std::ostream&);
+
+		/*
+		Purpose:		Writes the header of a framed message.
+		Pre-condition:	Takes the output stream and the length of the message that follows it.
+		Post-condition:	Returns OK if the header was written, STREAM_ERROR otherwise.
+		*/
+		static CipherStatus writeHeader(std::ostream&, size_t);
+
+		size_t getLength() const;	//returns the length of the message
+		size_t getReceived() const;	//returns the number of ciphertext letters taken so far
+		size_t getReady() const;	//returns the number of plaintext letters handed back so far
+		bool isComplete() const;	//returns true once every plaintext letter has been handed back
+
+		static constexpr size_t MAX_LENGTH = (size_t)1 << 40;	//longest message a header may announce
+		static constexpr int VERSION = 1;	//version of the frame format written by writeHeader
+		static constexpr const char* MAGIC = "FRAMED-MESSAGE";	//first word of every frame header
+	private:
+		//private data members
+		const KeySchedule& schedule;	//key material of the message
+		std::vector<char> ciphertext;	//ciphertext taken so far, in the order it arrived
+		std::vector<char> plaintext;	//plaintext letters decrypted so far
+		std::vector<size_t> columnStarts;	//position in the ciphertext of the top of each column
+		std::vector<size_t> rowPlaces;	//row of the reordered matrix holding each row of the plaintext
+		std::vector<char> chunk;	//raw bytes read from the input stream
+		std::vector<char> letters;	//letters of chunk once whitespace is removed
+		size_t length;	//number of letters in the message
+		size_t matrixSize;	//number of letters in a full row
+		size_t lastRowLength;	//number of letters in the bottom row
+		size_t received;	//ciphertext letters taken so far
+		size_t ready;	//plaintext letters decrypted so far
+		size_t row;	//row of the plaintext the next letter is in
+		size_t column;	//column of the plaintext the next letter is in
+
+		/*
+		Purpose:		Decrypts the body of a framed message as it is read.
+		Pre-condition:	Takes the input positioned after the header and the output stream.
+		Post-condition:	Returns OK if the whole message was read and written, otherwise the problem found.
+		*/
+		CipherStatus run(std::istream&, std::ostream&);
+};
@@ -0,0 +1,140 @@
+/*
+Author:			My Tran
+Filename:		ParallelCipher.cpp
+Description:	This file implements the header file ParallelCipher.h providing the definitions for the methods of the
+ParallelCipher class.
+*/
+#include "ParallelCipher.h"
+#include "Instrumentation.h"
+#include<atomic>
+
+const size_t MIN_ROWS_BYTES = 1 << 16;	//fewest characters of rows handed to a worker at once
+const size_t CHECK_GRAIN = 1 << 18;	//characters checked by a worker at once
+const size_t BATCH_GRAIN = 4;	//messages handed to a worker at once
+
+ParallelCipher::ParallelCipher(size_t threads)
+	: pool(threads)
+{
+}
+
+CipherStatus ParallelCipher::encrypt(std::string_view plaintext, const KeySchedule& schedule, char* output)
+{
+	if (plaintext.length() < MIN_PARALLEL_LENGTH)
+	{
+		return CipherEngine::encrypt(plaintext, schedule, output);
+	}
+
+	INSTRUMENT_STAGE(CipherStage::ENCRYPT, plaintext.length());
+
+	CipherStatus status = validate(plaintext, schedule);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	Transposition transposition(plaintext.length(), schedule.getKey().permutation);
+	size_t grain = (MIN_ROWS_BYTES / transposition.getMatrixSize()) + 1;
+
+	pool.parallelFor(transposition.getOccupiedRows(), grain, [&](size_t firstRow, size_t endRow)
+	{
+		CipherEngine::encryptRows(plaintext.data(), 0, schedule.getSubstitution(), transposition, firstRow, endRow, output);
+	});
+	INSTRUMENT_MESSAGE(plaintext.length());
+
+	return CipherStatus::OK;
+}
+
+CipherStatus ParallelCipher::decrypt(std::string_view ciphertext, const KeySchedule& schedule, char* output)
+{
+	if (ciphertext.length() < MIN_PARALLEL_LENGTH)
+	{
+		return CipherEngine::decrypt(ciphertext, schedule, output);
+	}
+
+	INSTRUMENT_STAGE(CipherStage::DECRYPT, ciphertext.length());
+
+	CipherStatus status = validate(ciphertext, schedule);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	Transposition transposition(ciphertext.length(), schedule.getKey().permutation);
+	size_t grain = (MIN_ROWS_BYTES / transposition.getMatrixSize()) + 1;
+
+	pool.parallelFor(transposition.getOccupiedRows(), grain, [&](size_t firstRow, size_t endRow)
+	{
+		CipherEngine::decryptRows(ciphertext.data(), 0, schedule.getSubstitution(), transposition, firstRow, endRow, output);
+	});
+	INSTRUMENT_MESSAGE(ciphertext.length());
+
+	return CipherStatus::OK;
+}
+
+void ParallelCipher::encryptBatch(const std::vector<std::string_view>& plaintexts, const KeySchedule& schedule,
+	std::vector<std::string>& ciphertexts, std::vector<CipherStatus>& statuses)
+{
+	runBatch(plaintexts, schedule, ciphertexts, statuses, true);
+}
+
+void ParallelCipher::decryptBatch(const std::vector<std::string_view>& ciphertexts, const KeySchedule& schedule,
+	std::vector<std::string>& plaintexts, std::vector<CipherStatus>& statuses)
+{
+	runBatch(ciphertexts, schedule, plaintexts, statuses, false);
+}
+
+size_t ParallelCipher::getThreadCount() const
+{
+	return pool.getThreadCount();
+}
+
+CipherStatus ParallelCipher::validate(std::string_view text, const KeySchedule& schedule)
+{
+	if (text.empty())
+	{
+		return CipherStatus::EMPTY_INPUT;
+	}
+
+	CipherStatus status = schedule.validateLength(text.length());
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	//checking the characters is a pass over the whole message, so it is split as well
+	std::atomic<bool> valid(true);
+	pool.parallelFor(text.length(), CHECK_GRAIN, [&](size_t begin, size_t end)
+	{
+		if (!CipherEngine::isLowerCase(text.substr(begin, end - begin)))
+		{
+			valid.store(false, std::memory_order_relaxed);
+		}
+	});
+
+	return valid.load() ? CipherStatus::OK : CipherStatus::INVALID_CHARACTER;
+}
+
+void ParallelCipher::runBatch(const std::vector<std::string_view>& texts, const KeySchedule& schedule,
+	std::vector<std::string>& results, std::vector<CipherStatus>& statuses, bool encrypting)
+{
+	results.resize(texts.size());
+	statuses.resize(texts.size());
+
+	//messages are independent, so each index only touches its own result and status
+	pool.parallelFor(texts.size(), BATCH_GRAIN, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			results[i].resize(texts[i].length());
+
+			if (encrypting)
+			{
+				statuses[i] = CipherEngine::encrypt(texts[i], schedule, &results[i][0]);
+			}
+			else
+			{
+				statuses[i] = CipherEngine::decrypt(texts[i], schedule, &results[i][0]);
+			}
+		}
+	});
+}
@@ -0,0 +1,82 @@
+/*
+Author:			My Tran
+Filename:		ParallelCipher.h
+Description:	This file provides the declarations of the ParallelCipher class. ParallelCipher spreads the work of the
+product cipher over a ThreadPool in two ways. A single large message is split by rows of the reordered matrix, since
+once the permutation is known every row lands at positions no other row touches. A batch of messages is split by
+message, with idle workers stealing messages from busy ones. Either way the output is the same as CipherEngine's.
+*/
+#pragma once
+#include<cstddef>
+#include<string>
+#include<string_view>
+#include<vector>
+#include "CipherEngine.h"
+#include "ThreadPool.h"
+
+class ParallelCipher
+{
+	public:
+		/*
+		Purpose:		Creates a parallel cipher with its own worker threads.
+		Pre-condition:	Takes the number of threads, or 0 for one per hardware thread.
+		Post-condition:	None
+		*/
+		ParallelCipher(size_t = 0);
+
+		/*
+		Purpose:		Encrypts one message using every worker.
+		Pre-condition:	Same as CipherEngine::encrypt.
+		Post-condition:	Same as CipherEngine::encrypt.
+		*/
+		CipherStatus encrypt(std::string_view, const KeySchedule&, char*);
+
+		/*
+		Purpose:		Decrypts one message using every worker.
+		Pre-condition:	Same as CipherEngine::decrypt.
+		Post-condition:	Same as CipherEngine::decrypt.
+		*/
+		CipherStatus decrypt(std::string_view, const KeySchedule&, char*);
+
+		/*
+		Purpose:		Encrypts many messages with the same key, each on a single worker.
+		Pre-condition:	Takes the plaintexts, the schedule, and the vectors the ciphertexts and statuses are stored in. The
+						key's permutation only fits messages whose matrices have as many occupied rows as it was made for.
+		Post-condition:	For every message i, statuses[i] holds the result of encrypting it and ciphertexts[i] holds the
+						ciphertext if the status is OK.
+		*/
+		void encryptBatch(const std::vector<std::string_view>&, const KeySchedule&, std::vector<std::string>&,
+			std::vector<CipherStatus>&);
+
+		/*
+		Purpose:		Decrypts many messages with the same key, each on a single worker.
+		Pre-condition:	Takes the ciphertexts, the schedule, and the vectors the plaintexts and statuses are stored in. The
+						key's permutation only fits messages whose matrices have as many occupied rows as it was made for.
+		Post-condition:	For every message i, statuses[i] holds the result of decrypting it and plaintexts[i] holds the
+						plaintext if the status is OK.
+		*/
+		void decryptBatch(const std::vector<std::string_view>&, const KeySchedule&, std::vector<std::string>&,
+			std::vector<CipherStatus>&);
+
+		size_t getThreadCount() const;	//returns the number of worker threads
+
+		static constexpr size_t MIN_PARALLEL_LENGTH = 1 << 16;	//shorter messages are not worth splitting
+	private:
+		//private data members
+		ThreadPool pool;	//workers shared by every call
+
+		/*
+		Purpose:		Checks a single message and key the same way CipherEngine does, splitting the character check.
+		Pre-condition:	Takes the text and the schedule.
+		Post-condition:	Returns OK if the text can be encrypted or decrypted, otherwise the problem found.
+		*/
+		CipherStatus validate(std::string_view, const KeySchedule&);
+
+		/*
+		Purpose:		Runs encryption or decryption over a batch of messages.
+		Pre-condition:	Takes the texts, the schedule, the results, the statuses and whether to encrypt.
+		Post-condition:	results and statuses hold the outcome for every message.
+		*/
+		void runBatch(const std::vector<std::string_view>&, const KeySchedule&, std::vector<std::string>&,
+			std::vector<CipherStatus>&, bool);
+};
@@ -0,0 +1,235 @@
+/*
+Author:			My Tran
+Filename:		ReferenceCipher.cpp
+Description:	This file implements the header file ReferenceCipher.h providing the definitions for the methods of the
+ReferenceCipher class. Each stage is the matching method of the original Encryptor with the prompts replaced by the key.
+*/
+#include "ReferenceCipher.h"
+
+ReferenceCipher::ReferenceCipher(const CipherKey& key) : key(key)
+{
+}
+
+std::string ReferenceCipher::encrypt(const std::string& text)
+{
+	plaintext = text;
+
+	//first encypt plaintext with affine
+	affine();
+
+	//Populate matrix with encrypted string
+	fillMatrix();
+
+	//Form row swapped matrix
+	reOrderMatrix();
+
+	//create ciphertext with columns of matrix in transpose order
+	for (size_t c = 0, a = 0; c < cipherMatrix[0].size(); c++)
+	{
+		for (size_t r = 0; r < cipherMatrix.size() && a < ciphertext.length() && cipherMatrix[r][c] != '\0'; r++, a++)
+		{
+			ciphertext[a] = cipherMatrix[r][c];
+		}
+	}
+
+	cipherMatrix.clear();
+	transposeMatrix.clear();
+
+	return ciphertext;
+}
+
+std::string ReferenceCipher::decrypt(const std::string& text)
+{
+	ciphertext = text;
+
+	//Recreate the matrix from the row transposition algorithm before the reordering. Result is stored in transposeMatrix
+	reconstructMatrix();
+
+	//Concatenating the rows gives the ciphertext from the affine encryption
+	ciphertext = "";
+
+	//From each row, and each element in each row, concatenate the rows from top to bottom
+	for (std::vector<char> g : transposeMatrix)
+	{
+		for (char h : g)
+		{
+			if (h != '\0')
+			{
+				ciphertext += h;
+			}
+		}
+	}
+
+	//Undoing the affine results in the unencrypted plaintext.
+	invertAffine();
+
+	cipherMatrix.clear();
+	transposeMatrix.clear();
+
+	return plaintext;
+}
+
+void ReferenceCipher::affine()
+{
+	//substitution of plaintext to ciphertext uses affine method
+	ciphertext = std::string(plaintext.length(), ' ');
+
+	//key phrase acts as part of affine cipher to apply vigenere cipher method
+	for (size_t i = 0; i < plaintext.length(); i++)
+	{
+		//C = (a*P + b)mod 26 where a = keyNum and b = char at keyPhrase[i]
+		int cipher = key.keyNum * ((int)plaintext[i] - 97);
+		cipher += ((int)key.keyPhrase[i % key.keyPhrase.length()] - 97);
+		cipher %= 26;
+
+		//append encrypted character to cyphertext
+		ciphertext[i] = (char)(cipher + 97);
+	}
+}
+
+void ReferenceCipher::invertAffine()
+{
+	//calculate modular multiplicative inverse of key number
+	int keyNumInverse = calcModInverse(key.keyNum);
+
+	//using the ciphertext, inverse of keyNum, and given word or phrase, undo affine cipher
+	plaintext = std::string(ciphertext.length(), ' ');
+	for (size_t i = 0; i < ciphertext.length(); i++)
+	{
+		//P = (a^-1)(C - b)mod 26 where a^-1 = multiplicative inverse and b = char at pos i of key phrase
+		int decipher = (((int)ciphertext[i] - 97));
+		decipher -= (((int)key.keyPhrase[i % key.keyPhrase.length()]) - 97);
+		decipher *= keyNumInverse;
+
+		//account for negative number modulus
+		while (decipher < 0)
+		{
+			decipher += 26;
+		}
+
+		decipher = decipher % 26;
+
+		plaintext[i] = (char)(decipher + 97);
+	}
+}
+
+void ReferenceCipher::fillMatrix()
+{
+	int matrixSize = getMatrixSize((int)ciphertext.length());	//least square dimension of matrix given number of elements
+	int missingElements = ((matrixSize * matrixSize) - (int)ciphertext.length());	//num elements missing from full square
+	int occupiedRows = matrixSize - (missingElements / matrixSize);		//number of rows in matrix w/ elements
+
+	//size of matrix is n*n such that n^2~ ciphertext length
+	transposeMatrix.resize(occupiedRows, std::vector<char>(matrixSize, '\0'));
+
+	//populate the matrix with the encrypted text row by row from left to right
+	for (int r = 0, n = 0; r < matrixSize; r++)
+	{
+		for (int c = 0; n < (int)ciphertext.length() && c < matrixSize; c++, n++)
+		{
+			transposeMatrix[r][c] = ciphertext[n];
+		}
+	}
+}
+
+void ReferenceCipher::reOrderMatrix()
+{
+	int matrixSize = getMatrixSize((int)ciphertext.length());	//least square dimension of matrix given number of elements
+	int missingElements = ((matrixSize * matrixSize) - (int)ciphertext.length());	//num elements missing from full square
+	int occupiedRows = matrixSize - (missingElements / matrixSize);		//number of rows in matrix w/ elements
+
+	//new matrix is made with row order specified by the key
+	cipherMatrix.resize(occupiedRows, std::vector<char>(matrixSize, ' '));
+
+	for (int i = 0; i < occupiedRows - 1; i++)
+	{
+		//the next row of the cipher matrix gets the row of the original at row j
+		cipherMatrix[i] = transposeMatrix[key.permutation[i]];
+	}
+
+	//fill the last row which may or may not be full
+	cipherMatrix[occupiedRows - 1] = transposeMatrix[occupiedRows - 1];
+}
+
+void ReferenceCipher::reconstructMatrix()
+{
+	int matrixSize = getMatrixSize((int)ciphertext.length());	//least square dimension of matrix given length of cipher text
+	int missingElements = ((matrixSize * matrixSize) - (int)ciphertext.length());	//num elements missing from full square
+	int occupiedRows = matrixSize - (missingElements / matrixSize);	//Rows that have elements
+	int fullColumns = matrixSize - (missingElements % matrixSize);	//columns that aren't missing elements
+
+	//elements don't always fill matrix to bottom row so create matrix with rows that get filled
+	cipherMatrix.resize(occupiedRows, std::vector<char>(matrixSize, '\0'));
+
+	//fill matrix by column, accounting for the incomplete columns resulting from populating by row during encryption
+	for (int c = 0, i = 0, b = occupiedRows; c < matrixSize; c++)
+	{
+		if (c >= fullColumns)
+		{
+			b = occupiedRows - 1;
+		}
+
+		for (int r = 0; r < b && i < (int)ciphertext.length(); r++, i++)
+		{
+			cipherMatrix[r][c] = ciphertext[i];
+		}
+	}
+
+	//Put the rows back in order
+	transposeMatrix.resize(occupiedRows, std::vector<char>(matrixSize, '\0'));
+	for (int i = 0; i < occupiedRows - 1; i++)
+	{
+		//in the original matrix, the row at f, corresponds to the next row of the cipherMatrix from top to bottom
+		transposeMatrix[key.permutation[i]] = cipherMatrix[i];
+
+		//get bottom row which may or may not be incomplete
+		transposeMatrix[occupiedRows - 1] = cipherMatrix[occupiedRows - 1];
+	}
+}
+
+int ReferenceCipher::getMatrixSize(int elements)
+{
+	int dimension = 1;
+
+	//find the least square number at or above the number of elements
+	while (dimension * dimension < elements)
+	{
+		dimension++;
+	}
+
+	return dimension;
+}
+
+std::string ReferenceCipher::formatInput(std::string input)
+{
+	std::string output = "";
+
+	for (size_t i = 0; i < input.length(); i++)
+	{
+		//make all upper case letters lower case
+		if (input[i] >= 'A' && input[i] <= 'Z')
+		{
+			input[i] += 32;
+		}
+
+		//remove spaces
+		if (input[i] != ' ')
+		{
+			output += input[i];
+		}
+	}
+
+	return output;
+}
+
+int ReferenceCipher::calcModInverse(int keyNum)
+{
+	int inverse = 0;
+
+	while (((inverse * keyNum) % 26) != 1)
+	{
+		inverse++;
+	}
+
+	return inverse;
+}
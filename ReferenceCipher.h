@@ -0,0 +1,104 @@
+/*
+Author:			My Tran
+Filename:		ReferenceCipher.h
+Description:	This file provides the declarations of the ReferenceCipher class. ReferenceCipher is the original matrix
+based cipher of the Encryptor class with the console prompts taken out, kept stage for stage so the faster engines can be
+measured and checked against it. It fills and reorders vectors of rows and copies the text between strings exactly the
+way the first version of the program did, and is not meant for use outside of benchmarks and tests.
+*/
+#pragma once
+#include<string>
+#include<vector>
+#include "CipherKey.h"
+
+class ReferenceCipher
+{
+	public:
+		/*
+		Purpose:		Creates a reference cipher for a key.
+		Pre-condition:	Takes a key that CipherEngine accepts for the messages it will be used on.
+		Post-condition:	None
+		*/
+		ReferenceCipher(const CipherKey&);
+
+		/*
+		Purpose:		Encrypts plaintext the way the original Encryptor did.
+		Pre-condition:	Takes lower case plaintext that is not empty.
+		Post-condition:	Returns the ciphertext.
+		*/
+		std::string encrypt(const std::string&);
+
+		/*
+		Purpose:		Decrypts ciphertext the way the original Encryptor did.
+		Pre-condition:	Takes lower case ciphertext that is not empty.
+		Post-condition:	Returns the plaintext. Like the original, messages of one or two letters come back empty.
+		*/
+		std::string decrypt(const std::string&);
+
+		/*
+		Purpose:		Applies C = (aP + b) mod 26 to plaintext, storing the result in ciphertext.
+		Pre-condition:	plaintext is set.
+		Post-condition:	ciphertext holds the substituted plaintext.
+		*/
+		void affine();
+
+		/*
+		Purpose:		Applies P = (a^-1)(C - b) mod 26 to ciphertext, storing the result in plaintext.
+		Pre-condition:	ciphertext is set.
+		Post-condition:	plaintext holds the substituted ciphertext.
+		*/
+		void invertAffine();
+
+		/*
+		Purpose:		Fills transposeMatrix with ciphertext row by row.
+		Pre-condition:	ciphertext is set.
+		Post-condition:	transposeMatrix holds the ciphertext.
+		*/
+		void fillMatrix();
+
+		/*
+		Purpose:		Builds cipherMatrix from the rows of transposeMatrix in the order of the key.
+		Pre-condition:	fillMatrix has been called.
+		Post-condition:	cipherMatrix holds the reordered rows.
+		*/
+		void reOrderMatrix();
+
+		/*
+		Purpose:		Refills cipherMatrix from ciphertext by column and puts its rows back in their original order in
+						transposeMatrix.
+		Pre-condition:	ciphertext is set.
+		Post-condition:	transposeMatrix holds the rows of the matrix before they were reordered.
+		*/
+		void reconstructMatrix();
+
+		/*
+		Purpose:		Finds least dimension of square matrix to hold certain amount of elements.
+		Pre-condition:	Takes an integer argument that is the amount of elements the matrix needs to hold.
+		Post-condition:	Returns integer value for the dimensions of the square matrix.
+		*/
+		static int getMatrixSize(int);
+
+		/*
+		Purpose:		Given string, remove spaces and convert upper case to lower case, one character at a time
+						into a growing string, the way the original Encryptor did before Normalizer replaced it.
+		Pre-condition:	Takes string argument being the string we want to format
+		Post-condition:	Returns formatted string.
+		*/
+		static std::string formatInput(std::string);
+
+		//data members are public so each stage can be set up and run on its own
+		std::string plaintext;	//text before substitution or after inverting it
+		std::string ciphertext;	//text after substitution or before inverting it
+		std::vector<std::vector<char>> transposeMatrix;	//matrix of rows in their original order
+		std::vector<std::vector<char>> cipherMatrix;	//matrix of rows in the order of the key
+	private:
+		//private data members
+		CipherKey key;	//keyNum, keyPhrase and row combination
+
+		/*
+		Purpose:		Finds the multiplicative inverse of a number mod 26.
+		Pre-condition:	Takes a valid key number.
+		Post-condition:	Returns the inverse.
+		*/
+		static int calcModInverse(int);
+};
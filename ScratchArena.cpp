@@ -0,0 +1,65 @@
+/*
+Author:			My Tran
+Filename:		ScratchArena.cpp
+Description:	This file implements the header file ScratchArena.h providing the definitions for the methods of the
+ScratchArena class.
+*/
+#include "ScratchArena.h"
+#include<cstdint>
+
+ScratchArena::ScratchArena(size_t capacity)
+{
+	block = nullptr;
+	this->capacity = 0;
+	used = 0;
+	heapAllocations = 0;
+
+	reset(capacity);
+}
+
+void ScratchArena::reset(size_t bytes)
+{
+	used = 0;
+
+	if (bytes <= capacity)
+	{
+		return;
+	}
+
+	//the block grows to at least twice its size, so a run of growing messages goes to the heap only a few times
+	size_t grown = (bytes > 2 * capacity) ? bytes : 2 * capacity;
+	grown = getFootprint(grown);
+
+	storage.reset();
+	storage.reset(new char[grown + ALIGNMENT]);
+	heapAllocations++;
+
+	uintptr_t address = (uintptr_t)storage.get();
+	block = storage.get() + (getFootprint(address) - address);
+	capacity = grown;
+}
+
+char* ScratchArena::allocate(size_t bytes)
+{
+	size_t footprint = getFootprint(bytes);
+
+	if (footprint > capacity - used)
+	{
+		return nullptr;
+	}
+
+	char* piece = block + used;
+	used += footprint;
+
+	return piece;
+}
+
+size_t ScratchArena::getCapacity() const
+{
+	return capacity;
+}
+
+size_t ScratchArena::getHeapAllocations() const
+{
+	return heapAllocations;
+}
@@ -0,0 +1,64 @@
+/*
+Author:			My Tran
+Filename:		ScratchArena.h
+Description:	This file provides the declarations of the ScratchArena class. ScratchArena is a monotonic arena for the
+scratch buffers of one message at a time: reset() is told how many bytes the message needs and rewinds the arena, and
+allocate() hands out pieces of its block by moving a pointer. The block is only replaced when a message needs more than
+it holds, so once the largest message has been seen the arena never goes to the heap again. Every time it does is
+counted, which lets a caller confirm that its steady state allocates nothing.
+*/
+#pragma once
+#include<cstddef>
+#include<memory>
+
+class ScratchArena
+{
+	public:
+		/*
+		Purpose:		Creates an arena, allocating its block up front if a capacity is given.
+		Pre-condition:	Takes the number of bytes to reserve, which may be 0.
+		Post-condition:	None
+		*/
+		ScratchArena(size_t = 0);
+
+		ScratchArena(const ScratchArena&) = delete;
+		ScratchArena& operator=(const ScratchArena&) = delete;
+
+		/*
+		Purpose:		Releases everything allocated from the arena and makes room for the next message.
+		Pre-condition:	Takes the total number of bytes that will be allocated before the next reset, counting each
+						allocation rounded up to ALIGNMENT.
+		Post-condition:	The arena holds at least that many bytes. Pointers it handed out before are no longer valid.
+		*/
+		void reset(size_t);
+
+		/*
+		Purpose:		Takes the next piece of the block.
+		Pre-condition:	Takes the number of bytes, which together with the earlier allocations since reset must fit in the
+						size given to reset.
+		Post-condition:	Returns the piece, aligned to ALIGNMENT, or nullptr if it does not fit.
+		*/
+		char* allocate(size_t);
+
+		size_t getCapacity() const;	//returns the number of bytes the block holds
+		size_t getHeapAllocations() const;	//returns the number of blocks taken from the heap so far
+
+		/*
+		Purpose:		Gives the space an allocation takes up in the arena.
+		Pre-condition:	Takes the number of bytes asked for.
+		Post-condition:	Returns the number rounded up to ALIGNMENT.
+		*/
+		static constexpr size_t getFootprint(size_t bytes)
+		{
+			return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+		}
+
+		static constexpr size_t ALIGNMENT = 64;	//allocations start on their own cache line
+	private:
+		//private data members
+		std::unique_ptr<char[]> storage;	//memory of the block, with room to align its start
+		char* block;	//first aligned byte of the block
+		size_t capacity;	//bytes the block holds
+		size_t used;	//bytes allocated since the last reset
+		size_t heapAllocations;	//blocks taken from the heap so far
+};
@@ -0,0 +1,182 @@
+/*
+Author:			My Tran
+Filename:		StreamCipher.cpp
+Description:	This file implements the header file StreamCipher.h providing the definitions for the methods of the
+StreamCipher class.
+*/
+#include "StreamCipher.h"
+#include "CipherEngine.h"
+#include "Instrumentation.h"
+#include "Normalizer.h"
+#include<string>
+
+const size_t CHUNK_SIZE = 65536;	//number of raw bytes read from the input stream at a time
+
+StreamCipher::StreamCipher(const KeySchedule& schedule)
+	: schedule(schedule)
+{
+	pending = 0;
+	chunkStart = 0;
+}
+
+CipherStatus StreamCipher::encrypt(std::istream& input, std::ostream& output, size_t blockSize)
+{
+	//the header could not describe a block size outside of this range
+	if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE)
+	{
+		return CipherStatus::INVALID_HEADER;
+	}
+
+	CipherStatus status = schedule.validateLength(blockSize);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	output << MAGIC << " " << VERSION << " " << blockSize << "\n";
+
+	return run(input, output, blockSize, true);
+}
+
+CipherStatus StreamCipher::decrypt(std::istream& input, std::ostream& output)
+{
+	std::string magic;
+	int version = 0;
+	size_t blockSize = 0;
+
+	//header is a single line: magic word, version and block size
+	input >> magic >> version >> blockSize;
+	if (!input || input.get() != '\n' || magic != MAGIC || version != VERSION || blockSize == 0 || blockSize > MAX_BLOCK_SIZE)
+	{
+		return CipherStatus::INVALID_HEADER;
+	}
+
+	CipherStatus status = schedule.validateLength(blockSize);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	return run(input, output, blockSize, false);
+}
+
+size_t StreamCipher::getPermutationSize(size_t blockSize)
+{
+	return Transposition::calcOccupiedRows(blockSize) - 1;
+}
+
+CipherStatus StreamCipher::run(std::istream& input, std::ostream& output, size_t blockSize, bool encrypting)
+{
+	//buffers are sized once for the whole stream, so memory use does not grow with its length
+	block.resize(blockSize);
+	result.resize(blockSize);
+	chunk.resize(CHUNK_SIZE);
+	lastPermutation.reserve(getPermutationSize(blockSize));
+	pending = 0;
+	chunkStart = 0;
+
+	size_t position = 0;
+	for (size_t count = blockSize; count == blockSize; position += count)
+	{
+		CipherStatus status = readBlock(input, blockSize, count);
+		if (status != CipherStatus::OK)
+		{
+			return status;
+		}
+
+		//a stream that ends exactly on a block boundary has no last partial block
+		if (count == 0)
+		{
+			break;
+		}
+
+		status = processBlock(count, position, blockSize, encrypting, output);
+		if (status != CipherStatus::OK)
+		{
+			return status;
+		}
+	}
+
+	{
+		INSTRUMENT_STAGE(CipherStage::OUTPUT, 0);
+		output.flush();
+	}
+	INSTRUMENT_MESSAGE(position);
+
+	return output ? CipherStatus::OK : CipherStatus::STREAM_ERROR;
+}
+
+CipherStatus StreamCipher::processBlock(size_t count, size_t position, size_t blockSize, bool encrypting, std::ostream& output)
+{
+	const std::vector<int>* permutation = &schedule.getKey().permutation;
+
+	//the last block has fewer rows, so it keeps only the rows of the permutation it still has, in the same order
+	if (count < blockSize)
+	{
+		int rows = Transposition::calcOccupiedRows(count) - 1;
+
+		lastPermutation.clear();
+		for (int row : *permutation)
+		{
+			if (row < rows)
+			{
+				lastPermutation.push_back(row);
+			}
+		}
+
+		permutation = &lastPermutation;
+	}
+
+	Transposition transposition(count, *permutation);
+
+	if (encrypting)
+	{
+		CipherEngine::encryptBlock(block.data(), position, schedule.getSubstitution(), transposition, result.data());
+	}
+	else
+	{
+		CipherEngine::decryptBlock(block.data(), position, schedule.getSubstitution(), transposition, result.data());
+	}
+
+	INSTRUMENT_STAGE(CipherStage::OUTPUT, count);
+	output.write(result.data(), count);
+
+	return output ? CipherStatus::OK : CipherStatus::STREAM_ERROR;
+}
+
+CipherStatus StreamCipher::readBlock(std::istream& input, size_t blockSize, size_t& count)
+{
+	count = 0;
+
+	while (count < blockSize)
+	{
+		//refill the chunk once every byte in it has been used
+		if (pending == 0)
+		{
+			INSTRUMENT_STAGE(CipherStage::INPUT, 0);
+			input.read(chunk.data(), chunk.size());
+			pending = (size_t)input.gcount();
+			chunkStart = 0;
+
+			if (pending == 0)
+			{
+				return input.bad() ? CipherStatus::STREAM_ERROR : CipherStatus::OK;
+			}
+		}
+
+		//no more bytes are taken than the block has room for, since every one of them could be a letter
+		size_t used = (pending < blockSize - count) ? pending : blockSize - count;
+		size_t invalidOffset = 0;
+		count += Normalizer::normalize(&chunk[chunkStart], used, &block[count], Normalizer::Whitespace::ALL, invalidOffset);
+
+		if (invalidOffset != Normalizer::NO_INVALID)
+		{
+			return CipherStatus::INVALID_CHARACTER;
+		}
+
+		pending -= used;
+		chunkStart += used;
+	}
+
+	return CipherStatus::OK;
+}
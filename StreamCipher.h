@@ -0,0 +1,92 @@
+/*
+Author:			My Tran
+Filename:		StreamCipher.h
+Description:	This file provides the declarations of the StreamCipher class. StreamCipher encrypts and decrypts streams of
+any length in fixed size blocks, so only one block is held in memory at a time. The affine/vigenere substitution runs
+over the whole stream, continuing through the key phrase from one block to the next, while the row transposition is
+applied to each block on its own. The ciphertext starts with a short header recording the block size so decryption can
+stream the same way.
+
+Stream format:	"ENCRYPTOR-STREAM <version> <block size>\n" followed by the ciphertext of each block in order. Every block
+but the last holds block size letters. The last block is shorter and is transposed with the key's permutation restricted
+to the rows it has, keeping their order.
+*/
+#pragma once
+#include<cstddef>
+#include<iostream>
+#include<vector>
+#include "KeySchedule.h"
+
+class StreamCipher
+{
+	public:
+		/*
+		Purpose:		Creates a stream cipher for a key.
+		Pre-condition:	Takes the schedule of the key. Its permutation must order the full rows of a block. The schedule
+						must outlive the StreamCipher.
+		Post-condition:	None
+		*/
+		StreamCipher(const KeySchedule&);
+
+		/*
+		Purpose:		Encrypts a stream of text block by block.
+		Pre-condition:	Takes input made up of letters and whitespace, the output stream and the block size. Letters are
+						made lower case and whitespace is removed, the same as typed plaintext.
+		Post-condition:	Returns OK and output holds the header followed by the ciphertext. Otherwise returns the problem
+						found, and output holds every block written before it.
+		*/
+		CipherStatus encrypt(std::istream&, std::ostream&, size_t = DEFAULT_BLOCK_SIZE);
+
+		/*
+		Purpose:		Decrypts a stream written by encrypt block by block.
+		Pre-condition:	Takes input starting with a stream header and the output stream.
+		Post-condition:	Returns OK and output holds the plaintext. Otherwise returns the problem found, and output holds
+						every block written before it.
+		*/
+		CipherStatus decrypt(std::istream&, std::ostream&);
+
+		/*
+		Purpose:		Gives the number of rows a key's permutation must order for a given block size.
+		Pre-condition:	Takes block size.
+		Post-condition:	Returns the size the permutation must have.
+		*/
+		static size_t getPermutationSize(size_t);
+
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;	//letters per block unless another size is asked for
+		static constexpr size_t MAX_BLOCK_SIZE = 1 << 26;	//largest block size a header may ask for
+		static constexpr int VERSION = 1;	//version of the stream format written by encrypt
+		static constexpr const char* MAGIC = "ENCRYPTOR-STREAM";	//first word of every stream header
+	private:
+		//private data members
+		const KeySchedule& schedule;	//key material shared by every block
+		std::vector<char> block;	//letters of the block being gathered
+		std::vector<char> result;	//block after encryption or decryption
+		std::vector<char> chunk;	//raw bytes read from the input stream
+		std::vector<int> lastPermutation;	//key's permutation restricted to the rows of the last block
+		size_t pending;	//raw bytes of chunk not yet moved into a block
+		size_t chunkStart;	//position in chunk of the first pending byte
+
+		/*
+		Purpose:		Encrypts or decrypts the body of a stream block by block.
+		Pre-condition:	Takes the input positioned after the header, the output stream, the block size and whether to
+						encrypt.
+		Post-condition:	Returns OK if every block was written, otherwise the problem found.
+		*/
+		CipherStatus run(std::istream&, std::ostream&, size_t, bool);
+
+		/*
+		Purpose:		Encrypts or decrypts one block and writes it to the output stream.
+		Pre-condition:	Takes the number of letters in block, their position in the stream, the block size, whether to
+						encrypt, and the output stream.
+		Post-condition:	Returns OK if the result was written, STREAM_ERROR otherwise.
+		*/
+		CipherStatus processBlock(size_t, size_t, size_t, bool, std::ostream&);
+
+		/*
+		Purpose:		Reads letters into block until it is full or the input runs out.
+		Pre-condition:	Takes the input stream, the block size and where to store the number of letters read. Letters
+						are made lower case and whitespace is skipped.
+		Post-condition:	Returns OK and stores the number of letters read, or INVALID_CHARACTER or STREAM_ERROR.
+		*/
+		CipherStatus readBlock(std::istream&, size_t, size_t&);
+};
@@ -0,0 +1,342 @@
+/*
+Author:			My Tran
+Filename:		Substitution.cpp
+Description:	This file implements the header file Substitution.h providing the definitions for the methods of the
+Substitution class along with the scalar, SSE2 and AVX2 kernels it dispatches to.
+*/
+#include "Substitution.h"
+#include "CipherEngine.h"
+#include "Instrumentation.h"
+#include<cstring>
+#include<mutex>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SUBSTITUTION_SIMD
+#include<immintrin.h>
+#if defined(_MSC_VER)
+#include<intrin.h>
+#endif
+#endif
+
+//functions using avx2 instructions are compiled for avx2 on their own so the rest of the program runs anywhere
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+const int ALPHABET_SIZE = SUBSTITUTION_ALPHABET_SIZE;	//number of letters the cipher operates on
+const int ASCII_VAL_LOWER_A = 97;	//ascii value for lowercase a
+const int MOD_26_RECIPROCAL = 2521;	//(x * 2521) >> 16 equals x / 26 for every x the kernels produce (x < 6577)
+
+/*
+Purpose:		Substitutes one character at a time by looking it up in the table for its key letter.
+Pre-condition:	Takes lower case text, key letters, count, table for the direction and output.
+Post-condition:	output contains the substituted characters.
+*/
+static void substituteScalar(const char* text, const char* key, size_t count, const SubstitutionTable& table, char* output)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		output[i] = table.letters[key[i] - ASCII_VAL_LOWER_A][text[i] - ASCII_VAL_LOWER_A];
+	}
+}
+
+#ifdef SUBSTITUTION_SIMD
+/*
+Purpose:		Reduces eight 16 bit values mod 26 without dividing or branching.
+Pre-condition:	Takes values less than 6577.
+Post-condition:	Returns x - 26 * floor(x / 26) for each value.
+*/
+static inline __m128i mod26Sse2(__m128i x)
+{
+	__m128i quotient = _mm_mulhi_epu16(x, _mm_set1_epi16(MOD_26_RECIPROCAL));
+	return _mm_sub_epi16(x, _mm_mullo_epi16(quotient, _mm_set1_epi16(ALPHABET_SIZE)));
+}
+
+/*
+Purpose:		Applies C = (aP + b) mod 26 sixteen characters at a time.
+Pre-condition:	Takes text, key letters, count, table holding keyNum and output.
+Post-condition:	output contains the substituted characters.
+*/
+static void applySse2(const char* text, const char* key, size_t count, const SubstitutionTable& table, char* output)
+{
+	const __m128i letterA = _mm_set1_epi8(ASCII_VAL_LOWER_A);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i multiplier = _mm_set1_epi16((short)table.multiplier);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i plain = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(text + i)), letterA);
+		__m128i shift = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(key + i)), letterA);
+
+		//a*P + b is at most 650 so each half is widened to 16 bits before multiplying
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(plain, zero), multiplier), _mm_unpacklo_epi8(shift, zero));
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(plain, zero), multiplier), _mm_unpackhi_epi8(shift, zero));
+
+		__m128i cipher = _mm_packus_epi16(mod26Sse2(low), mod26Sse2(high));
+		_mm_storeu_si128((__m128i*)(output + i), _mm_add_epi8(cipher, letterA));
+	}
+
+	substituteScalar(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Applies P = (a^-1)(C - b) mod 26 sixteen characters at a time.
+Pre-condition:	Takes text, key letters, count, table holding the inverse of keyNum and output.
+Post-condition:	output contains the original characters.
+*/
+static void invertSse2(const char* text, const char* key, size_t count, const SubstitutionTable& table, char* output)
+{
+	const __m128i letterA = _mm_set1_epi8(ASCII_VAL_LOWER_A);
+	const __m128i alphabetSize = _mm_set1_epi8(ALPHABET_SIZE);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i multiplier = _mm_set1_epi16((short)table.multiplier);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		//C - b + 26 is between 1 and 51, and (a^-1)(C - b + 26) is at most 1275
+		__m128i difference = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(text + i)), _mm_loadu_si128((const __m128i*)(key + i)));
+		difference = _mm_add_epi8(difference, alphabetSize);
+
+		__m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(difference, zero), multiplier);
+		__m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(difference, zero), multiplier);
+
+		__m128i plain = _mm_packus_epi16(mod26Sse2(low), mod26Sse2(high));
+		_mm_storeu_si128((__m128i*)(output + i), _mm_add_epi8(plain, letterA));
+	}
+
+	substituteScalar(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Reduces sixteen 16 bit values mod 26 without dividing or branching.
+Pre-condition:	Takes values less than 6577.
+Post-condition:	Returns x - 26 * floor(x / 26) for each value.
+*/
+TARGET_AVX2 static inline __m256i mod26Avx2(__m256i x)
+{
+	__m256i quotient = _mm256_mulhi_epu16(x, _mm256_set1_epi16(MOD_26_RECIPROCAL));
+	return _mm256_sub_epi16(x, _mm256_mullo_epi16(quotient, _mm256_set1_epi16(ALPHABET_SIZE)));
+}
+
+/*
+Purpose:		Applies C = (aP + b) mod 26 thirty two characters at a time.
+Pre-condition:	Takes text, key letters, count, table holding keyNum and output.
+Post-condition:	output contains the substituted characters.
+*/
+TARGET_AVX2 static void applyAvx2(const char* text, const char* key, size_t count, const SubstitutionTable& table, char* output)
+{
+	const __m256i letterA = _mm256_set1_epi8(ASCII_VAL_LOWER_A);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i multiplier = _mm256_set1_epi16((short)table.multiplier);
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i plain = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(text + i)), letterA);
+		__m256i shift = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(key + i)), letterA);
+
+		//unpacking and packing both work within 128 bit lanes, so the characters come back out in order
+		__m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(plain, zero), multiplier), _mm256_unpacklo_epi8(shift, zero));
+		__m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(plain, zero), multiplier), _mm256_unpackhi_epi8(shift, zero));
+
+		__m256i cipher = _mm256_packus_epi16(mod26Avx2(low), mod26Avx2(high));
+		_mm256_storeu_si256((__m256i*)(output + i), _mm256_add_epi8(cipher, letterA));
+	}
+
+	//the tail runs sse2 code, which is slowed down while the upper halves of the ymm registers are dirty, and the
+	//compiler does not clear them when it turns this call into a jump
+	_mm256_zeroupper();
+	applySse2(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Applies P = (a^-1)(C - b) mod 26 thirty two characters at a time.
+Pre-condition:	Takes text, key letters, count, table holding the inverse of keyNum and output.
+Post-condition:	output contains the original characters.
+*/
+TARGET_AVX2 static void invertAvx2(const char* text, const char* key, size_t count, const SubstitutionTable& table, char* output)
+{
+	const __m256i letterA = _mm256_set1_epi8(ASCII_VAL_LOWER_A);
+	const __m256i alphabetSize = _mm256_set1_epi8(ALPHABET_SIZE);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i multiplier = _mm256_set1_epi16((short)table.multiplier);
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i difference = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(text + i)), _mm256_loadu_si256((const __m256i*)(key + i)));
+		difference = _mm256_add_epi8(difference, alphabetSize);
+
+		__m256i low = _mm256_mullo_epi16(_mm256_unpacklo_epi8(difference, zero), multiplier);
+		__m256i high = _mm256_mullo_epi16(_mm256_unpackhi_epi8(difference, zero), multiplier);
+
+		__m256i plain = _mm256_packus_epi16(mod26Avx2(low), mod26Avx2(high));
+		_mm256_storeu_si256((__m256i*)(output + i), _mm256_add_epi8(plain, letterA));
+	}
+
+	//the tail runs sse2 code, which is slowed down while the upper halves of the ymm registers are dirty, and the
+	//compiler does not clear them when it turns this call into a jump
+	_mm256_zeroupper();
+	invertSse2(text + i, key + i, count - i, table, output + i);
+}
+
+/*
+Purpose:		Determines if the processor and operating system support avx2 instructions.
+Pre-condition:	None
+Post-condition:	Returns true if avx2 kernels may be used.
+*/
+static bool cpuSupportsAvx2()
+{
+#if defined(__GNUC__)
+	return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+	int info[4];
+
+	//the processor must support avx and the operating system must save the ymm registers
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+#endif
+
+const Substitution* Substitution::installed[MAX_INSTALLED];
+std::atomic<size_t> Substitution::installedCount(0);
+static std::mutex installMutex;	//keeps two installs from writing the same entry
+
+Substitution::Substitution(int keyNum, std::string_view keyPhrase)
+{
+	INSTRUMENT_STAGE(CipherStage::KEY_SCHEDULE, keyPhrase.length());
+
+	//an invalid keyNum is never used to substitute, but still has to give tables that can be built safely
+	keyNum = CipherEngine::isValidKeyNum(keyNum) ? keyNum : 0;
+
+	this->keyPhrase = keyPhrase;
+	expanded = keyPhrase.length() <= MAX_EXPANDED_PHRASE;
+	fixed = nullptr;
+
+	//a key built when the program was compiled leaves nothing to build. Entries are written before the count that
+	//publishes them and never change afterwards, so reading up to the count needs no lock
+	size_t count = installedCount.load(std::memory_order_acquire);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (installed[i]->applyTable.multiplier == keyNum && installed[i]->keyPhrase == keyPhrase)
+		{
+			fixed = installed[i];
+			streamLength = 0;
+			return;
+		}
+	}
+
+	//the whole map for each key letter b, so the scalar kernel never multiplies or divides
+	applyTable = makeApplyTable(keyNum);
+	invertTable = makeInvertTable(CipherEngine::calcModInverse(keyNum), applyTable);
+
+	if (keyPhrase.empty())
+	{
+		//an invalid key leaves nothing to expand
+		streamLength = 0;
+	}
+	else if (expanded)
+	{
+		//the same stream expandKeyPhrase gives, made by copying the phrase once and then doubling what is there
+		std::memcpy(stream, keyPhrase.data(), keyPhrase.length());
+		for (size_t filled = keyPhrase.length(); filled < KEY_STREAM_SIZE; filled *= 2)
+		{
+			std::memcpy(stream + filled, stream, (filled < KEY_STREAM_SIZE - filled) ? filled : KEY_STREAM_SIZE - filled);
+		}
+
+		streamLength = KEY_STREAM_SIZE;
+	}
+	else
+	{
+		//long phrases already give long runs, so they are read in place
+		streamLength = keyPhrase.length();
+	}
+}
+
+void Substitution::apply(const char* text, size_t position, size_t count, char* output) const
+{
+	const Substitution& source = (fixed != nullptr) ? *fixed : *this;
+	source.run(getApplyKernel(), source.applyTable, text, position, count, output);
+}
+
+void Substitution::invert(const char* text, size_t position, size_t count, char* output) const
+{
+	const Substitution& source = (fixed != nullptr) ? *fixed : *this;
+	source.run(getInvertKernel(), source.invertTable, text, position, count, output);
+}
+
+void Substitution::run(Kernel kernel, const SubstitutionTable& table, const char* text, size_t position, size_t count, char* output) const
+{
+	const char* keyStream = expanded ? stream : keyPhrase.data();
+	size_t phase = position % keyPhrase.length();	//letter of the key phrase the first character is paired with
+
+	while (count > 0)
+	{
+		size_t length = (count < streamLength - phase) ? count : streamLength - phase;
+
+		kernel(text, keyStream + phase, length, table, output);
+
+		text += length;
+		output += length;
+		count -= length;
+		phase = (phase + length) % keyPhrase.length();
+	}
+}
+
+bool Substitution::install(const Substitution& substitution)
+{
+	std::lock_guard<std::mutex> lock(installMutex);
+
+	size_t count = installedCount.load(std::memory_order_relaxed);
+	if (count == MAX_INSTALLED)
+	{
+		return false;
+	}
+
+	//the entry is written before the count is raised, so a constructor that sees the count sees the entry
+	installed[count] = &substitution;
+	installedCount.store(count + 1, std::memory_order_release);
+	return true;
+}
+
+const char* Substitution::getKernelName()
+{
+#ifdef SUBSTITUTION_SIMD
+	return cpuSupportsAvx2() ? "avx2" : "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+Substitution::Kernel Substitution::getApplyKernel()
+{
+#ifdef SUBSTITUTION_SIMD
+	static const Kernel kernel = cpuSupportsAvx2() ? applyAvx2 : applySse2;
+#else
+	static const Kernel kernel = substituteScalar;
+#endif
+	return kernel;
+}
+
+Substitution::Kernel Substitution::getInvertKernel()
+{
+#ifdef SUBSTITUTION_SIMD
+	static const Kernel kernel = cpuSupportsAvx2() ? invertAvx2 : invertSse2;
+#else
+	static const Kernel kernel = substituteScalar;
+#endif
+	return kernel;
+}
@@ -0,0 +1,184 @@
+/*
+Author:			My Tran
+Filename:		Substitution.h
+Description:	This file provides the declarations of the Substitution class. Substitution applies and inverts the
+affine/vigenere substitution C = (aP + b) mod 26 on whole runs of text. The key phrase is expanded once into a stream long
+enough that any run can read its b values from contiguous memory, and the runs are handed to an SSE2 or AVX2 kernel
+chosen at runtime for the processor, falling back to a scalar kernel elsewhere. The scalar kernel and the ends of runs
+too short for a vector look each letter up in a 26 x 26 table built once for the key.
+
+The tables and key stream of a key known when the program is compiled can be built by the compiler instead, see
+FixedKey.h. Such a substitution can be installed, after which every Substitution made for the same key at runtime uses it
+rather than building its own.
+*/
+#pragma once
+#include<atomic>
+#include<cstddef>
+#include<string_view>
+
+const int SUBSTITUTION_ALPHABET_SIZE = 26;	//number of letters the substitution maps between
+
+//everything a kernel needs to substitute in one direction
+struct SubstitutionTable
+{
+	int multiplier;	//keyNum when substituting, inverse of keyNum when inverting
+	char letters[SUBSTITUTION_ALPHABET_SIZE][SUBSTITUTION_ALPHABET_SIZE];	//letters[b][x] is the result for key letter b and text letter x
+};
+
+class Substitution
+{
+	public:
+		//selects the constructor that the compiler can run
+		struct CompileTime
+		{
+		};
+
+		/*
+		Purpose:		Creates the substitution for a key.
+		Pre-condition:	Takes keyNum and key phrase, which must be valid before apply or invert are used. The key phrase is
+						not copied when it is longer than MAX_EXPANDED_PHRASE and must then outlive the Substitution.
+		Post-condition:	If a substitution for the same key was installed, it is used and nothing is built.
+		*/
+		Substitution(int, std::string_view);
+
+		/*
+		Purpose:		Creates the substitution for a key when the program is compiled.
+		Pre-condition:	Takes a valid keyNum, its inverse and a valid key phrase no longer than MAX_EXPANDED_PHRASE, which
+						must outlive the Substitution.
+		Post-condition:	None
+		*/
+		constexpr Substitution(CompileTime, int keyNum, int keyNumInverse, std::string_view keyPhrase)
+			: applyTable(makeApplyTable(keyNum)), invertTable(makeInvertTable(keyNumInverse, applyTable)),
+			keyPhrase(keyPhrase), expanded(true), streamLength(KEY_STREAM_SIZE), stream{}, fixed(nullptr)
+		{
+			expandKeyPhrase(keyPhrase, stream);
+		}
+
+		/*
+		Purpose:		Applies C = (aP + b) mod 26 to a run of lower case text.
+		Pre-condition:	Takes the text, the position of its first character in the message, the number of characters
+						and the output buffer. The output may be the text itself.
+		Post-condition:	output contains the substituted characters.
+		*/
+		void apply(const char*, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Applies P = (a^-1)(C - b) mod 26 to a run of lower case text.
+		Pre-condition:	Takes the text, the position of its first character in the message, the number of characters
+						and the output buffer. The output may be the text itself.
+		Post-condition:	output contains the original characters.
+		*/
+		void invert(const char*, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Gives the name of the kernel selected for this processor.
+		Pre-condition:	None
+		Post-condition:	Returns "avx2", "sse2" or "scalar".
+		*/
+		static const char* getKernelName();
+
+		/*
+		Purpose:		Makes a substitution built when the program was compiled stand in for every Substitution made for
+						the same key from then on.
+		Pre-condition:	Takes the substitution, which must live until the program ends. Substitutions may be made on
+						other threads while it is installed; they use it if they see it published, and build their own
+						tables otherwise.
+		Post-condition:	Returns false if MAX_INSTALLED substitutions are installed already.
+		*/
+		static bool install(const Substitution&);
+
+		static constexpr size_t MAX_EXPANDED_PHRASE = 1024;	//longest key phrase that is expanded into the key stream
+		static constexpr size_t KEY_STREAM_SIZE = 2 * MAX_EXPANDED_PHRASE;	//length of the expanded key stream
+		static constexpr size_t MAX_INSTALLED = 16;	//most substitutions that can be installed
+	private:
+		//signature shared by the scalar and vectorized kernels: text, key letters, count, table, output
+		typedef void (*Kernel)(const char*, const char*, size_t, const SubstitutionTable&, char*);
+
+		//private data members
+		SubstitutionTable applyTable;	//C = (aP + b) mod 26 for every key letter b and plaintext letter P
+		SubstitutionTable invertTable;	//P = (a^-1)(C - b) mod 26 for every key letter b and ciphertext letter C
+		std::string_view keyPhrase;	//key phrase the stream was built from
+		bool expanded;	//true if the key stream is held in stream, false if it is read from keyPhrase
+		size_t streamLength;	//number of usable letters of the key stream
+		char stream[KEY_STREAM_SIZE];	//key phrase repeated back to back
+		const Substitution* fixed;	//installed substitution of the same key used in place of this one, or nullptr
+
+		static const Substitution* installed[MAX_INSTALLED];	//substitutions that were installed, never changed once published
+		static std::atomic<size_t> installedCount;	//number of entries of installed published to every thread
+
+		/*
+		Purpose:		Runs a kernel over a run of text, splitting it where the key stream wraps around.
+		Pre-condition:	Takes the kernel, its table, the text, its position in the message, the count and the output.
+		Post-condition:	output contains the result of the kernel.
+		*/
+		void run(Kernel, const SubstitutionTable&, const char*, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Picks the fastest kernels supported by the processor the first time they are needed.
+		Pre-condition:	None
+		Post-condition:	Returns the kernel for the direction asked for.
+		*/
+		static Kernel getApplyKernel();
+		static Kernel getInvertKernel();
+
+		/*
+		Purpose:		Builds the table of C = (aP + b) mod 26, stepping each row by a instead of dividing.
+		Pre-condition:	Takes a valid keyNum, or 0 for a table that is never used.
+		Post-condition:	Returns the table.
+		*/
+		static constexpr SubstitutionTable makeApplyTable(int keyNum)
+		{
+			SubstitutionTable table = {};
+			table.multiplier = keyNum;
+
+			for (int b = 0; b < SUBSTITUTION_ALPHABET_SIZE; b++)
+			{
+				for (int x = 0, value = b; x < SUBSTITUTION_ALPHABET_SIZE; x++)
+				{
+					table.letters[b][x] = (char)('a' + value);
+
+					//keyNum is less than 26, so one subtraction keeps the value in range
+					value += keyNum;
+					value -= (value >= SUBSTITUTION_ALPHABET_SIZE) ? SUBSTITUTION_ALPHABET_SIZE : 0;
+				}
+			}
+
+			return table;
+		}
+
+		/*
+		Purpose:		Builds the table of P = (a^-1)(C - b) mod 26 by reversing each row of the apply table.
+		Pre-condition:	Takes the inverse of keyNum and the apply table, which must map each row one to one.
+		Post-condition:	Returns the table.
+		*/
+		static constexpr SubstitutionTable makeInvertTable(int keyNumInverse, const SubstitutionTable& applyTable)
+		{
+			SubstitutionTable table = {};
+			table.multiplier = keyNumInverse;
+
+			for (int b = 0; b < SUBSTITUTION_ALPHABET_SIZE; b++)
+			{
+				for (int x = 0; x < SUBSTITUTION_ALPHABET_SIZE; x++)
+				{
+					table.letters[b][applyTable.letters[b][x] - 'a'] = (char)('a' + x);
+				}
+			}
+
+			return table;
+		}
+
+		/*
+		Purpose:		Repeats the key phrase back to back so a run starting at any letter of it can read at least
+						KEY_STREAM_SIZE - MAX_EXPANDED_PHRASE key letters without wrapping around.
+		Pre-condition:	Takes a key phrase of 1 to MAX_EXPANDED_PHRASE letters and the stream to fill.
+		Post-condition:	The stream is filled.
+		*/
+		static constexpr void expandKeyPhrase(std::string_view keyPhrase, char* stream)
+		{
+			for (size_t i = 0, j = 0; i < KEY_STREAM_SIZE; i++)
+			{
+				stream[i] = keyPhrase[j];
+				j = (j + 1 < keyPhrase.length()) ? j + 1 : 0;
+			}
+		}
+};
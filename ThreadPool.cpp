@@ -0,0 +1,187 @@
+/*
+Author:			My Tran
+Filename:		ThreadPool.cpp
+Description:	This file implements the header file ThreadPool.h providing the definitions for the methods of the
+ThreadPool class.
+*/
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threads)
+{
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+
+	//hardware_concurrency may not know, in which case a single worker still makes progress
+	if (threads == 0)
+	{
+		threads = 1;
+	}
+
+	invoker = nullptr;
+	task = nullptr;
+	grain = 1;
+	generation = 0;
+	busyWorkers = 0;
+	stopping = false;
+	ranges.reset(new WorkRange[threads]);
+
+	for (size_t i = 0; i < threads; i++)
+	{
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(jobLock);
+		stopping = true;
+	}
+
+	jobReady.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::run(size_t count, size_t grain, Invoker invoker, const void* task)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> call(callLock);
+	size_t threads = workers.size();
+
+	//every worker starts with an even share of the indices
+	for (size_t i = 0; i < threads; i++)
+	{
+		std::lock_guard<std::mutex> guard(ranges[i].lock);
+		ranges[i].begin = (count * i) / threads;
+		ranges[i].end = (count * (i + 1)) / threads;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(jobLock);
+		this->invoker = invoker;
+		this->task = task;
+		this->grain = (grain > 0) ? grain : 1;
+		busyWorkers = threads;
+		generation++;
+	}
+
+	jobReady.notify_all();
+
+	std::unique_lock<std::mutex> guard(jobLock);
+	jobDone.wait(guard, [this] { return busyWorkers == 0; });
+	this->task = nullptr;
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+	return workers.size();
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+	size_t seen = 0;	//last task this worker ran
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> guard(jobLock);
+			jobReady.wait(guard, [this, seen] { return stopping || generation != seen; });
+
+			if (stopping)
+			{
+				return;
+			}
+
+			seen = generation;
+		}
+
+		size_t begin = 0;
+		size_t end = 0;
+		while (takeWork(index, begin, end))
+		{
+			invoker(task, begin, end);
+		}
+
+		//the last worker to finish wakes the caller of parallelFor
+		std::lock_guard<std::mutex> guard(jobLock);
+		if (--busyWorkers == 0)
+		{
+			jobDone.notify_all();
+		}
+	}
+}
+
+bool ThreadPool::takeWork(size_t index, size_t& begin, size_t& end)
+{
+	WorkRange& own = ranges[index];
+
+	{
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (own.begin < own.end)
+		{
+			begin = own.begin;
+			end = (own.end - own.begin > grain) ? own.begin + grain : own.end;
+			own.begin = end;
+			return true;
+		}
+	}
+
+	//own range is empty, so look for the worker with the most indices left
+	size_t threads = workers.size();
+	size_t victim = index;
+	size_t most = 0;
+	for (size_t i = 1; i < threads; i++)
+	{
+		WorkRange& other = ranges[(index + i) % threads];
+		std::lock_guard<std::mutex> guard(other.lock);
+
+		if (other.end - other.begin > most)
+		{
+			most = other.end - other.begin;
+			victim = (index + i) % threads;
+		}
+	}
+
+	if (most == 0)
+	{
+		return false;
+	}
+
+	size_t stolenBegin = 0;
+	size_t stolenEnd = 0;
+	{
+		//the victim may have moved on since it was picked, so take half of whatever it has now from the back
+		WorkRange& other = ranges[victim];
+		std::lock_guard<std::mutex> guard(other.lock);
+		size_t remaining = other.end - other.begin;
+
+		if (remaining == 0)
+		{
+			return takeWork(index, begin, end);
+		}
+
+		stolenEnd = other.end;
+		stolenBegin = other.end - ((remaining + 1) / 2);
+		other.end = stolenBegin;
+	}
+
+	//run the first piece of the stolen indices now and keep the rest where other workers can steal them back
+	begin = stolenBegin;
+	end = (stolenEnd - stolenBegin > grain) ? stolenBegin + grain : stolenEnd;
+
+	std::lock_guard<std::mutex> guard(own.lock);
+	own.begin = end;
+	own.end = stolenEnd;
+
+	return true;
+}
@@ -0,0 +1,97 @@
+/*
+Author:			My Tran
+Filename:		ThreadPool.h
+Description:	This file provides the declarations of the ThreadPool class. ThreadPool keeps a fixed set of worker threads
+and runs a task over a range of indices on all of them. Each worker starts with an even share of the range and takes it
+a few indices at a time. A worker that runs out steals half of what is left from the busiest worker, so uneven work
+such as a batch of messages of very different lengths still keeps every core busy.
+*/
+#pragma once
+#include<condition_variable>
+#include<cstddef>
+#include<memory>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+class ThreadPool
+{
+	public:
+		/*
+		Purpose:		Starts the worker threads.
+		Pre-condition:	Takes the number of workers, or 0 for one per hardware thread.
+		Post-condition:	None
+		*/
+		ThreadPool(size_t = 0);
+
+		/*
+		Purpose:		Stops and joins the worker threads.
+		Pre-condition:	No call to parallelFor is running.
+		Post-condition:	None
+		*/
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/*
+		Purpose:		Runs a task over every index from 0 to count - 1 on the worker threads.
+		Pre-condition:	Takes the count, the fewest indices handed to the task at once, and the task, which is called with
+						the first index and one past the last index of each piece. The task may not throw.
+		Post-condition:	Returns once the task has been called exactly once for every index.
+		*/
+		template<class Task>
+		void parallelFor(size_t count, size_t grain, const Task& task)
+		{
+			//the task is only referred to while it runs, so it is never copied into a std::function that could allocate
+			run(count, grain, [](const void* task, size_t begin, size_t end) { (*(const Task*)task)(begin, end); }, &task);
+		}
+
+		size_t getThreadCount() const;	//returns the number of worker threads
+	private:
+		//indices a worker has left to run, guarded so other workers can steal from the back
+		struct WorkRange
+		{
+			std::mutex lock;
+			size_t begin = 0;
+			size_t end = 0;
+		};
+
+		//calls the task the pool was given, which is passed along untyped
+		typedef void (*Invoker)(const void*, size_t, size_t);
+
+		//private data members
+		std::vector<std::thread> workers;	//worker threads
+		std::unique_ptr<WorkRange[]> ranges;	//one range of remaining indices per worker
+		std::mutex callLock;	//lets only one parallelFor run at a time
+		std::mutex jobLock;	//guards the members below
+		std::condition_variable jobReady;	//signalled when a task is posted or the pool stops
+		std::condition_variable jobDone;	//signalled when the last worker finishes a task
+		Invoker invoker;	//calls the task being run
+		const void* task;	//task being run
+		size_t grain;	//fewest indices handed to the task at once
+		size_t generation;	//number of tasks posted so far
+		size_t busyWorkers;	//workers still running the current task
+		bool stopping;	//true once the pool is being destroyed
+
+		/*
+		Purpose:		Waits for tasks and runs them until the pool is stopped.
+		Pre-condition:	Takes the index of the worker.
+		Post-condition:	None
+		*/
+		void workerLoop(size_t);
+
+		/*
+		Purpose:		Runs a task over every index from 0 to count - 1 on the worker threads.
+		Pre-condition:	Takes the count, the grain, the invoker of the task and the task.
+		Post-condition:	Returns once the task has been called exactly once for every index.
+		*/
+		void run(size_t, size_t, Invoker, const void*);
+
+		/*
+		Purpose:		Takes the next piece of work for a worker, stealing from another worker if its own range is empty.
+		Pre-condition:	Takes the index of the worker and where to store the piece.
+		Post-condition:	Returns true and stores the piece, or false if no work is left anywhere.
+		*/
+		bool takeWork(size_t, size_t&, size_t&);
+};
@@ -0,0 +1,286 @@
+/*
+Author:			My Tran
+Filename:		Transposition.cpp
+Description:	This file implements the header file Transposition.h providing the definitions for the methods of the
+Transposition class.
+*/
+#include "Transposition.h"
+#include<cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TRANSPOSITION_SIMD
+#include<emmintrin.h>
+#endif
+
+const size_t BLOCK_SIZE = 16;	//rows and columns of the blocks of a tile transposed in registers
+
+#ifdef TRANSPOSITION_SIMD
+//the unpack ladder leaves line i of a block in vector BIT_REVERSED[i], the 4 bit reversal of i
+const size_t BIT_REVERSED[BLOCK_SIZE] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+
+/*
+Purpose:		Transposes a 16 x 16 block of bytes held in sixteen vectors.
+Pre-condition:	Takes the vectors, each holding one line of the block.
+Post-condition:	Vector BIT_REVERSED[i] holds what was byte i of every vector, in order.
+*/
+static inline void transposeBlock(__m128i* lines)
+{
+	__m128i next[BLOCK_SIZE];
+
+	//every step interleaves neighbouring vectors in elements twice as wide as the step before
+	for (size_t i = 0; i < BLOCK_SIZE / 2; i++)
+	{
+		next[i] = _mm_unpacklo_epi8(lines[2 * i], lines[(2 * i) + 1]);
+		next[i + (BLOCK_SIZE / 2)] = _mm_unpackhi_epi8(lines[2 * i], lines[(2 * i) + 1]);
+	}
+
+	for (size_t i = 0; i < BLOCK_SIZE / 2; i++)
+	{
+		lines[i] = _mm_unpacklo_epi16(next[2 * i], next[(2 * i) + 1]);
+		lines[i + (BLOCK_SIZE / 2)] = _mm_unpackhi_epi16(next[2 * i], next[(2 * i) + 1]);
+	}
+
+	for (size_t i = 0; i < BLOCK_SIZE / 2; i++)
+	{
+		next[i] = _mm_unpacklo_epi32(lines[2 * i], lines[(2 * i) + 1]);
+		next[i + (BLOCK_SIZE / 2)] = _mm_unpackhi_epi32(lines[2 * i], lines[(2 * i) + 1]);
+	}
+
+	for (size_t i = 0; i < BLOCK_SIZE / 2; i++)
+	{
+		lines[i] = _mm_unpacklo_epi64(next[2 * i], next[(2 * i) + 1]);
+		lines[i + (BLOCK_SIZE / 2)] = _mm_unpackhi_epi64(next[2 * i], next[(2 * i) + 1]);
+	}
+}
+#endif
+
+Transposition::Transposition(size_t length, const std::vector<int>& permutation, size_t rowWidth)
+{
+	this->length = length;
+	matrixSize = (rowWidth > 0) ? rowWidth : calcMatrixSize(length);
+	occupiedRows = calcOccupiedRows(length, matrixSize);
+	lastRowLength = length - ((occupiedRows - 1) * matrixSize);
+	this->permutation = permutation.data();
+}
+
+void Transposition::transpose(const char* text, char* output) const
+{
+	//each row is read from contiguous memory and written straight to its transposed positions
+	for (size_t r = 0; r < occupiedRows; r++)
+	{
+		transposeRow(text + getRowStart(r), r, 0, getRowLength(r), output);
+	}
+}
+
+void Transposition::untranspose(const char* text, char* output) const
+{
+	//each row is collected from its transposed positions and written to contiguous memory
+	for (size_t r = 0; r < occupiedRows; r++)
+	{
+		untransposeRow(text, r, 0, getRowLength(r), output + getRowStart(r));
+	}
+}
+
+void Transposition::transposeRow(const char* row, size_t r, size_t firstColumn, size_t count, char* output) const
+{
+	size_t end = firstColumn + count;
+	size_t split = (end < lastRowLength) ? end : lastRowLength;
+	size_t c = firstColumn;
+
+	//columns the bottom row reaches hold occupiedRows elements, so row r of column c is at c * occupiedRows + r
+	for (; c < split; c++)
+	{
+		output[(c * occupiedRows) + r] = *row++;
+	}
+
+	//the remaining columns are one element shorter
+	for (; c < end; c++)
+	{
+		output[(lastRowLength * occupiedRows) + ((c - lastRowLength) * (occupiedRows - 1)) + r] = *row++;
+	}
+}
+
+void Transposition::untransposeRow(const char* text, size_t r, size_t firstColumn, size_t count, char* row) const
+{
+	size_t end = firstColumn + count;
+	size_t split = (end < lastRowLength) ? end : lastRowLength;
+	size_t c = firstColumn;
+
+	for (; c < split; c++)
+	{
+		*row++ = text[(c * occupiedRows) + r];
+	}
+
+	for (; c < end; c++)
+	{
+		*row++ = text[(lastRowLength * occupiedRows) + ((c - lastRowLength) * (occupiedRows - 1)) + r];
+	}
+}
+
+void Transposition::transposeTile(const char* tile, size_t firstRow, size_t rows, size_t firstColumn, size_t columns,
+	char* output) const
+{
+	size_t blockRows = 0;	//rows of the tile covered by whole blocks
+	size_t blockColumns = 0;	//columns of the tile covered by whole blocks
+
+#ifdef TRANSPOSITION_SIMD
+	blockRows = rows - (rows % BLOCK_SIZE);
+	blockColumns = columns - (columns % BLOCK_SIZE);
+
+	for (size_t t = 0; t < blockRows; t += BLOCK_SIZE)
+	{
+		for (size_t c = 0; c < blockColumns; c += BLOCK_SIZE)
+		{
+			__m128i lines[BLOCK_SIZE];
+			for (size_t i = 0; i < BLOCK_SIZE; i++)
+			{
+				lines[i] = _mm_loadu_si128((const __m128i*)(tile + ((t + i) * columns) + c));
+			}
+
+			transposeBlock(lines);
+
+			for (size_t i = 0; i < BLOCK_SIZE; i++)
+			{
+				char* column = output + getColumnStart(firstColumn + c + BIT_REVERSED[i]) + firstRow + t;
+				_mm_storeu_si128((__m128i*)column, lines[i]);
+			}
+		}
+	}
+#endif
+
+	//element (t, c) of the tile belongs to row firstRow + t, which sits right after row firstRow + t - 1 in every column
+	for (size_t c = 0; c < columns; c++)
+	{
+		char* column = output + getColumnStart(firstColumn + c) + firstRow;
+
+		for (size_t t = (c < blockColumns) ? blockRows : 0; t < rows; t++)
+		{
+			column[t] = tile[(t * columns) + c];
+		}
+	}
+}
+
+void Transposition::untransposeTile(const char* text, size_t firstRow, size_t rows, size_t firstColumn, size_t columns,
+	char* tile) const
+{
+	size_t blockRows = 0;	//rows of the tile covered by whole blocks
+	size_t blockColumns = 0;	//columns of the tile covered by whole blocks
+
+#ifdef TRANSPOSITION_SIMD
+	blockRows = rows - (rows % BLOCK_SIZE);
+	blockColumns = columns - (columns % BLOCK_SIZE);
+
+	for (size_t t = 0; t < blockRows; t += BLOCK_SIZE)
+	{
+		for (size_t c = 0; c < blockColumns; c += BLOCK_SIZE)
+		{
+			__m128i lines[BLOCK_SIZE];
+			for (size_t i = 0; i < BLOCK_SIZE; i++)
+			{
+				lines[i] = _mm_loadu_si128((const __m128i*)(text + getColumnStart(firstColumn + c + i) + firstRow + t));
+			}
+
+			transposeBlock(lines);
+
+			for (size_t i = 0; i < BLOCK_SIZE; i++)
+			{
+				_mm_storeu_si128((__m128i*)(tile + ((t + BIT_REVERSED[i]) * columns) + c), lines[i]);
+			}
+		}
+	}
+#endif
+
+	for (size_t c = 0; c < columns; c++)
+	{
+		const char* column = text + getColumnStart(firstColumn + c) + firstRow;
+
+		for (size_t t = (c < blockColumns) ? blockRows : 0; t < rows; t++)
+		{
+			tile[(t * columns) + c] = column[t];
+		}
+	}
+}
+
+size_t Transposition::getColumnStart(size_t c) const
+{
+	//columns the bottom row reaches hold occupiedRows elements, the remaining columns one element fewer
+	if (c < lastRowLength)
+	{
+		return c * occupiedRows;
+	}
+
+	return (lastRowLength * occupiedRows) + ((c - lastRowLength) * (occupiedRows - 1));
+}
+
+size_t Transposition::getRowStart(size_t r) const
+{
+	//the bottom row is never reordered
+	return ((r < occupiedRows - 1) ? (size_t)permutation[r] : r) * matrixSize;
+}
+
+size_t Transposition::getRowLength(size_t r) const
+{
+	return (r < occupiedRows - 1) ? matrixSize : lastRowLength;
+}
+
+size_t Transposition::getLength() const
+{
+	return length;
+}
+
+size_t Transposition::getMatrixSize() const
+{
+	return matrixSize;
+}
+
+size_t Transposition::getOccupiedRows() const
+{
+	return occupiedRows;
+}
+
+int Transposition::calcMatrixSize(size_t elements)
+{
+	//the square root in floating point is within a step of the least square dimension for any length that fits in
+	//memory, and the steps below correct it either way without searching up from 1
+	size_t dimension = (size_t)std::sqrt((double)elements);
+
+	while (dimension * dimension < elements)
+	{
+		dimension++;
+	}
+
+	while (dimension > 1 && (dimension - 1) * (dimension - 1) >= elements)
+	{
+		dimension--;
+	}
+
+	return (int)((dimension > 0) ? dimension : 1);
+}
+
+int Transposition::calcOccupiedRows(size_t elements)
+{
+	return (int)calcOccupiedRows(elements, calcMatrixSize(elements));
+}
+
+size_t Transposition::calcOccupiedRows(size_t elements, size_t rowWidth)
+{
+	if (rowWidth == 0)
+	{
+		rowWidth = calcMatrixSize(elements);
+	}
+
+	//in the least square at most one row is left empty, since (matrixSize - 1)^2 < elements
+	return (elements + rowWidth - 1) / rowWidth;
+}
+
+size_t Transposition::calcRowWidth(size_t elements, size_t alignment)
+{
+	size_t square = calcMatrixSize(elements);
+
+	if (alignment <= 1 || square < alignment)
+	{
+		return square;
+	}
+
+	return ((square + alignment - 1) / alignment) * alignment;
+}
@@ -0,0 +1,144 @@
+/*
+Author:			My Tran
+Filename:		Transposition.h
+Description:	This file provides the declarations of the Transposition class. Transposition performs the row transposition
+of the product cipher without building a matrix. The text is laid out row by row in the least square matrix that fits
+it, the full rows are stacked in the order given by the key's permutation and the result is read column by column. Since
+every column except the ones past the end of the bottom row holds the same number of elements, the position of each
+element in the output is worked out directly from its row and column.
+
+The matrix may instead be given a row width, making it a rectangle of as many rows of that width as the text needs.
+calcRowWidth gives the width of the least square rounded up to a multiple of an alignment, such as CACHE_LINE_WIDTH or
+PAGE_WIDTH, so every row starts at the same offset of a cache line or page. A different width gives a different
+ciphertext and a different number of rows for the permutation to order, so the width must be recorded with the
+ciphertext for it to be decrypted.
+*/
+#pragma once
+#include<cstddef>
+#include<vector>
+
+class Transposition
+{
+	public:
+		/*
+		Purpose:		Creates the transposition of a message of a given length.
+		Pre-condition:	Takes the message length, a permutation of 0 to (calcOccupiedRows(length, rowWidth) - 2) and the
+						row width, or 0 for the least square. The permutation is not copied and must outlive the
+						Transposition.
+		Post-condition:	None
+		*/
+		Transposition(size_t, const std::vector<int>&, size_t = 0);
+
+		/*
+		Purpose:		Moves text from row by row order to the column by column order of the reordered matrix.
+		Pre-condition:	Takes text and an output buffer, both of the message length. They may not overlap.
+		Post-condition:	output contains the transposed text.
+		*/
+		void transpose(const char*, char*) const;
+
+		/*
+		Purpose:		Moves text from the column by column order of the reordered matrix back to row by row order.
+		Pre-condition:	Takes transposed text and an output buffer, both of the message length. They may not overlap.
+		Post-condition:	output contains the text in its original order.
+		*/
+		void untranspose(const char*, char*) const;
+
+		/*
+		Purpose:		Writes part of one row of the reordered matrix to its transposed positions.
+		Pre-condition:	Takes the elements of the row, the row of the reordered matrix, the first column and the number
+						of elements being written, and the output buffer of the message length.
+		Post-condition:	The elements are stored at their positions in output.
+		*/
+		void transposeRow(const char*, size_t, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Reads part of one row of the reordered matrix from transposed text.
+		Pre-condition:	Takes transposed text of the message length, the row of the reordered matrix, the first column and
+						the number of elements being read, and the buffer the elements are copied to.
+		Post-condition:	The elements of the row are stored in order in the buffer.
+		*/
+		void untransposeRow(const char*, size_t, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Writes a tile of the reordered matrix to its transposed positions. The rows of the tile are adjacent
+						in every column, so each column of the tile is written as one run of memory.
+		Pre-condition:	Takes the elements of the tile stored row after row, the first row and number of rows, the first
+						column and number of columns, and the output buffer of the message length. The tile may not reach
+						the bottom row.
+		Post-condition:	The elements are stored at their positions in output.
+		*/
+		void transposeTile(const char*, size_t, size_t, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Reads a tile of the reordered matrix from transposed text, each column of the tile as one run of memory.
+		Pre-condition:	Takes transposed text of the message length, the first row and number of rows, the first column and
+						number of columns, and the buffer the tile is stored in row after row. The tile may not reach the
+						bottom row.
+		Post-condition:	The elements of the tile are stored in the buffer.
+		*/
+		void untransposeTile(const char*, size_t, size_t, size_t, size_t, char*) const;
+
+		/*
+		Purpose:		Gives the position in the untransposed text of the row placed at a row of the reordered matrix.
+		Pre-condition:	Takes a row of the reordered matrix.
+		Post-condition:	Returns offset of the first element of that row in the untransposed text.
+		*/
+		size_t getRowStart(size_t) const;
+
+		/*
+		Purpose:		Gives the number of elements in a row of the reordered matrix.
+		Pre-condition:	Takes a row of the reordered matrix.
+		Post-condition:	Returns matrix size for full rows, and the length of the bottom row for the bottom row.
+		*/
+		size_t getRowLength(size_t) const;
+
+		/*
+		Purpose:		Gives the position in the transposed text of a column of the reordered matrix.
+		Pre-condition:	Takes a column of the matrix.
+		Post-condition:	Returns offset of the element of the top row of that column in the transposed text.
+		*/
+		size_t getColumnStart(size_t) const;
+
+		size_t getLength() const;	//returns the message length
+		size_t getMatrixSize() const;	//returns the row width, the dimension of the square unless another width was given
+		size_t getOccupiedRows() const;	//returns the number of rows of the matrix that hold elements
+
+		/*
+		Purpose:		Calculates the least square dimension of a matrix to fit a given number of elements.
+		Pre-condition:	Takes argument representing a number of elements to fit in a square
+		Post-condition:	Returns integer representing least square dimension of matrix
+		*/
+		static int calcMatrixSize(size_t);
+
+		/*
+		Purpose:		Calculates the number of rows of the least square matrix that hold at least one element.
+		Pre-condition:	Takes argument representing a number of elements to fit in a square
+		Post-condition:	Returns number of occupied rows. A permutation must order all but the last of them.
+		*/
+		static int calcOccupiedRows(size_t);
+
+		/*
+		Purpose:		Calculates the number of rows of a given width that hold at least one element.
+		Pre-condition:	Takes the number of elements and the row width, or 0 for the least square.
+		Post-condition:	Returns number of occupied rows. A permutation must order all but the last of them.
+		*/
+		static size_t calcOccupiedRows(size_t, size_t);
+
+		/*
+		Purpose:		Calculates the row width of the least square rounded up to a multiple of an alignment.
+		Pre-condition:	Takes the number of elements and the alignment, 0 or 1 for the least square itself.
+		Post-condition:	Returns the row width. Text too short to fill a row of the alignment keeps the least square, so
+						it is still spread over several rows.
+		*/
+		static size_t calcRowWidth(size_t, size_t);
+
+		static constexpr size_t CACHE_LINE_WIDTH = 64;	//alignment that starts every row at the same offset of a cache line
+		static constexpr size_t PAGE_WIDTH = 4096;	//alignment that starts every row at the same offset of a page
+	private:
+		//private data members
+		size_t length;	//number of elements in the message
+		size_t matrixSize;	//row width, the least square dimension of matrix unless another width was given
+		size_t occupiedRows;	//number of rows in matrix w/ elements
+		size_t lastRowLength;	//number of elements in the bottom row, which may or may not be full
+		const int* permutation;	//order the full rows are stacked in, owned by the caller
+};
@@ -0,0 +1,760 @@
+/*
+Author:			My Tran
+Filename:		bench.cpp
+Description:	This file is a benchmark program for every stage of the cipher. Each stage of the engine runs next to the
+matching stage of the original matrix based cipher kept in ReferenceCipher, over message sizes from 16 bytes up to 1 GB
+and several key phrase lengths, so a regression or an engine that does not beat the original shows up in one table.
+Every benchmark repeats its operation until it has run for the minimum time and reports the time per operation, the
+bytes processed per second and the heap allocations made per operation.
+
+Usage:	bench [--filter text] [--max-size bytes] [--phrases lengths] [--min-time seconds] [--csv]
+
+	--filter		only run benchmarks whose name contains the text
+	--max-size		largest message size, 16M unless given, up to 1G (K, M and G suffixes are understood)
+	--phrases		key phrase lengths, separated by commas, 1,8,64,4096 unless given
+	--min-time		least time to run each benchmark for, 0.2 seconds unless given
+	--csv			print comma separated values instead of a table
+
+Benchmark names are stage/size or stage/size/phrase length. Stages starting with "engine." are the current engine and
+stages starting with "reference." are the original cipher. The reference stages only run up to 64M since the matrices
+they build take several times the size of the message. The "keyStore" stages take the schedule from a KeyStore's cache,
+next to "engine.encryptWithKey", which builds it for every message. The "PageRows" stages widen the rows of the matrix
+to a multiple of a page, next to the least square of "engine.encrypt" and "engine.decrypt". The "packing" stages convert
+letters to and from the 5 bit packed form. The "online" stages decrypt with the OnlineDecryptor, timing both the first
+plaintext letter and the whole message fed in pieces. The "crack" benchmarks recover the key of English ciphertext with
+the Cryptanalyzer and also report the candidate keys it scores per second, and the "crack.audit" benchmark tests a
+wordlist of random key phrases against one of them. The "pipeline" stages run a CipherPipeline of PIPELINE_ROUNDS rounds
+of a substitution, a row transposition and a columnar transposition, compiled and stage by stage, next to the same
+pipeline of one round.
+*/
+#include "CipherContext.h"
+#include "CipherEngine.h"
+#include "CipherPipeline.h"
+#include "Cryptanalyzer.h"
+#include "FixedKey.h"
+#include "Instrumentation.h"
+#include "KeyStore.h"
+#include "LanguageModel.h"
+#include "LetterPacking.h"
+#include "Normalizer.h"
+#include "OnlineDecryptor.h"
+#include "ReferenceCipher.h"
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstdio>
+#include<cstdlib>
+#include<functional>
+#include<iostream>
+#include<new>
+#include<random>
+#include<sstream>
+#include<string>
+#include<vector>
+
+const size_t MIN_SIZE = 16;	//smallest message size benchmarked
+const size_t SIZE_STEP = 16;	//each message size is this many times the one before
+const size_t DEFAULT_MAX_SIZE = 1 << 24;	//largest message size unless another is asked for
+const size_t MAX_SIZE = 1 << 30;	//largest message size that may be asked for
+const size_t REFERENCE_MAX_SIZE = 1 << 26;	//largest message size the reference cipher is run on
+const int BENCH_KEY_NUM = 7;	//keyNum of every benchmark key
+const unsigned BENCH_SEED = 26;	//seed of the random text and keys so every run measures the same data
+const size_t PIPELINE_MAX_SIZE = 1 << 26;	//largest message size pipelines are compiled for, their tables taking 8 bytes a letter
+const size_t PIPELINE_ROUNDS = 4;	//rounds of the pipeline benchmarked against one round
+const size_t ONLINE_PIECE_SIZE = 65536;	//letters of ciphertext handed to the online decryptor at a time
+const size_t CRACK_SIZES[] = { 256, 1024 };	//ciphertext lengths the cryptanalyzer is benchmarked on
+const size_t CRACK_PHRASE_LENGTH = 6;	//key phrase length of the ciphertexts the cryptanalyzer is benchmarked on
+const size_t AUDIT_PHRASES = 1 << 20;	//phrases in the wordlist an audit is benchmarked on
+
+static constexpr char FIXED_KEY_PHRASE[] = "benchmarkkey";	//key phrase of the key fixed when the program is compiled
+typedef FixedKey<BENCH_KEY_NUM, FIXED_KEY_PHRASE> BenchFixedKey;	//key fixed when the program is compiled
+
+#ifdef ENCRYPTOR_INSTRUMENTATION
+/*
+Purpose:		Gives the number of heap allocations made so far, counted by the instrumented build's operator new.
+Pre-condition:	None
+Post-condition:	Returns the count.
+*/
+static size_t countAllocations()
+{
+	return (size_t)Instrumentation::getStats().allocations;
+}
+#else
+static std::atomic<size_t> allocations(0);	//heap allocations made since the program started
+
+//every allocation of the program goes through these so it can be counted
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+/*
+Purpose:		Gives the number of heap allocations made so far.
+Pre-condition:	None
+Post-condition:	Returns the count.
+*/
+static size_t countAllocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+#endif
+
+//everything given on the command line
+struct Options
+{
+	std::string filter;	//only benchmarks whose name contains this are run
+	size_t maxSize = DEFAULT_MAX_SIZE;	//largest message size
+	std::vector<size_t> phraseLengths = { 1, 8, 64, 4096 };	//key phrase lengths
+	double minTime = 0.2;	//least seconds to run each benchmark for
+	bool csv = false;	//true to print comma separated values
+};
+
+//outcome of one benchmark
+struct Measurement
+{
+	size_t iterations = 0;	//times the operation ran while timed
+	double secondsPerOperation = 0;	//average time of one operation
+	double allocationsPerOperation = 0;	//average heap allocations of one operation
+};
+
+volatile size_t sink = 0;	//results that would otherwise be optimized away are stored here
+
+/*
+Purpose:		Runs an operation repeatedly, doubling the number of runs until they take at least the minimum time.
+Pre-condition:	Takes the operation and the minimum time in seconds.
+Post-condition:	Returns the number of runs of the last round and the time and allocations of each run.
+*/
+static Measurement measure(const std::function<void()>& operation, double minTime)
+{
+	//one untimed run brings the data into the cache and lets buffers reach their final size
+	operation();
+
+	Measurement result;
+	for (size_t iterations = 1;; iterations *= 2)
+	{
+		size_t allocationsBefore = countAllocations();
+		auto start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < iterations; i++)
+		{
+			operation();
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		size_t allocationsAfter = countAllocations();
+
+		if (seconds >= minTime || iterations >= ((size_t)1 << 40))
+		{
+			result.iterations = iterations;
+			result.secondsPerOperation = seconds / iterations;
+			result.allocationsPerOperation = (double)(allocationsAfter - allocationsBefore) / iterations;
+			return result;
+		}
+	}
+}
+
+/*
+Purpose:		Writes a size in bytes with the largest unit it is a whole number of.
+Pre-condition:	Takes the size.
+Post-condition:	Returns the size as text such as "64K".
+*/
+static std::string formatSize(size_t size)
+{
+	const char* const units[] = { "", "K", "M", "G" };
+	size_t unit = 0;
+
+	while (unit < 3 && size >= 1024 && size % 1024 == 0)
+	{
+		size /= 1024;
+		unit++;
+	}
+
+	return std::to_string(size) + units[unit];
+}
+
+/*
+Purpose:		Reads a size such as "4096", "64K" or "1G".
+Pre-condition:	Takes the text and where to store the size.
+Post-condition:	Returns true if the text is a size. False otherwise.
+*/
+static bool parseSize(const std::string& text, size_t& size)
+{
+	std::istringstream number(text);
+	char unit = '\0';
+
+	if (!(number >> size))
+	{
+		return false;
+	}
+
+	if (number >> unit)
+	{
+		size_t scale = (unit == 'K' || unit == 'k') ? 1 << 10 : (unit == 'M' || unit == 'm') ? 1 << 20
+			: (unit == 'G' || unit == 'g') ? 1 << 30 : 0;
+		if (scale == 0 || !(number >> std::ws).eof())
+		{
+			return false;
+		}
+
+		size *= scale;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Prints one result in the chosen format.
+Pre-condition:	Takes the options, the benchmark name, bytes processed by one operation and the measurement.
+Post-condition:	The result is printed.
+*/
+static void report(const Options& options, const std::string& name, size_t bytes, const Measurement& result)
+{
+	double bytesPerSecond = (bytes > 0) ? bytes / result.secondsPerOperation : 0;
+	char line[256];
+
+	if (options.csv)
+	{
+		std::snprintf(line, sizeof(line), "%s,%zu,%.3f,%.0f,%.2f\n", name.c_str(), result.iterations,
+			result.secondsPerOperation * 1e9, bytesPerSecond, result.allocationsPerOperation);
+		std::cout << line << std::flush;
+		return;
+	}
+
+	//bytes per second is left blank for stages that do not process text
+	char rate[32] = "";
+	if (bytes > 0)
+	{
+		const char* const units[] = { "B/s", "KB/s", "MB/s", "GB/s" };
+		size_t unit = 0;
+		for (; unit < 3 && bytesPerSecond >= 1000; unit++)
+		{
+			bytesPerSecond /= 1000;
+		}
+		std::snprintf(rate, sizeof(rate), "%.2f %s", bytesPerSecond, units[unit]);
+	}
+
+	std::snprintf(line, sizeof(line), "%-44s %12zu %16.1f %14s %12.2f\n", name.c_str(), result.iterations,
+		result.secondsPerOperation * 1e9, rate, result.allocationsPerOperation);
+	std::cout << line << std::flush;
+}
+
+/*
+Purpose:		Runs a benchmark if its name passes the filter.
+Pre-condition:	Takes the options, the name, bytes processed by one operation and the operation.
+Post-condition:	The benchmark is run and reported, or skipped.
+*/
+static void run(const Options& options, const std::string& name, size_t bytes, const std::function<void()>& operation)
+{
+	if (name.find(options.filter) == std::string::npos)
+	{
+		return;
+	}
+
+	report(options, name, bytes, measure(operation, options.minTime));
+}
+
+/*
+Purpose:		Makes random lower case text.
+Pre-condition:	Takes the length and the random generator.
+Post-condition:	Returns the text.
+*/
+static std::string makeLetters(size_t length, std::mt19937& random)
+{
+	std::string text(length, ' ');
+	for (char& letter : text)
+	{
+		letter = (char)('a' + random() % 26);
+	}
+
+	return text;
+}
+
+/*
+Purpose:		Makes a key for a message length with a random phrase and row combination.
+Pre-condition:	Takes the message length, the key phrase length and the random generator.
+Post-condition:	Returns a key CipherEngine accepts for messages of that length.
+*/
+static CipherKey makeKey(size_t length, size_t phraseLength, std::mt19937& random)
+{
+	CipherKey key;
+	key.keyNum = BENCH_KEY_NUM;
+	key.keyPhrase = makeLetters(phraseLength, random);
+	key.permutation.resize(Transposition::calcOccupiedRows(length) - 1);
+
+	for (size_t i = 0; i < key.permutation.size(); i++)
+	{
+		key.permutation[i] = (int)i;
+	}
+	std::shuffle(key.permutation.begin(), key.permutation.end(), random);
+
+	return key;
+}
+
+/*
+Purpose:		Makes text as a user would type it from plaintext.
+Pre-condition:	Takes lower case plaintext.
+Post-condition:	Returns the plaintext with capitals and spaces for the normalizer to take out.
+*/
+static std::string makeTyped(const std::string& plaintext)
+{
+	std::string typed = plaintext;
+	for (size_t i = 0; i < typed.length(); i += 6)
+	{
+		typed[i] = (i % 12 == 0) ? ' ' : (char)(typed[i] - 32);
+	}
+
+	return typed;
+}
+
+/*
+Purpose:		Runs the benchmarks of one message size that do not depend on the key phrase.
+Pre-condition:	Takes the options, the plaintext and a key for its length.
+Post-condition:	The benchmarks are run and reported.
+*/
+static void runSizeBenchmarks(const Options& options, const std::string& plaintext, const CipherKey& key)
+{
+	size_t length = plaintext.length();
+	std::string suffix = "/" + formatSize(length);
+	std::string output(length, ' ');
+	Transposition transposition(length, key.permutation);
+
+	run(options, "engine.transpose" + suffix, length, [&] { transposition.transpose(plaintext.data(), &output[0]); });
+	run(options, "engine.untranspose" + suffix, length, [&] { transposition.untranspose(plaintext.data(), &output[0]); });
+	run(options, "engine.matrixSize" + suffix, 0, [&] { sink = sink + Transposition::calcMatrixSize(length); });
+
+	//the first letter of the plaintext is ready once the top of every row of the first column has arrived, while the
+	//whole message needs every piece; any letters stand in for ciphertext since only the time is measured
+	KeySchedule schedule(key);
+	OnlineDecryptor online(schedule);
+	std::string_view ready;
+	std::string_view firstColumn(plaintext.data(), transposition.getOccupiedRows());
+
+	run(options, "online.firstLetter" + suffix, 0, [&]
+	{
+		online.begin(length);
+		online.feed(firstColumn, ready);
+		sink = sink + ready.length();
+	});
+
+	run(options, "online.decrypt" + suffix, length, [&]
+	{
+		online.begin(length);
+		for (size_t start = 0; start < length; start += ONLINE_PIECE_SIZE)
+		{
+			online.feed(std::string_view(plaintext).substr(start, ONLINE_PIECE_SIZE), ready);
+			sink = sink + ready.length();
+		}
+	});
+
+	std::string typed = makeTyped(plaintext);
+	size_t invalidOffset = 0;
+	run(options, "normalize" + suffix, length, [&]
+	{
+		sink = sink + Normalizer::normalize(typed.data(), length, &output[0], Normalizer::Whitespace::SPACES, invalidOffset);
+	});
+	if (length <= REFERENCE_MAX_SIZE)
+	{
+		run(options, "reference.formatInput" + suffix, length, [&]
+		{
+			sink = sink + ReferenceCipher::formatInput(typed).length();
+		});
+	}
+
+	std::vector<unsigned char> packed(LetterPacking::calcPackedSize(length));
+	run(options, "packing.pack" + suffix, length, [&] { LetterPacking::pack(plaintext.data(), length, packed.data()); });
+	run(options, "packing.unpack" + suffix, length, [&] { LetterPacking::unpack(packed.data(), length, &output[0]); });
+
+	//the fixed key's tables were built by the compiler, and it is installed so encrypting with the key alone uses them too
+	CipherKey fixedKey = key;
+	fixedKey.keyPhrase = FIXED_KEY_PHRASE;
+	std::string ciphertext(length, ' ');
+	BenchFixedKey::encrypt(plaintext, key.permutation, &ciphertext[0]);
+
+	run(options, "fixed.encrypt" + suffix, length, [&] { BenchFixedKey::encrypt(plaintext, key.permutation, &output[0]); });
+	run(options, "fixed.decrypt" + suffix, length, [&] { BenchFixedKey::decrypt(ciphertext, key.permutation, &output[0]); });
+	run(options, "fixed.encryptWithKey" + suffix, length, [&] { CipherEngine::encrypt(plaintext, fixedKey, &output[0]); });
+
+	if (length > REFERENCE_MAX_SIZE)
+	{
+		return;
+	}
+
+	ReferenceCipher reference(key);
+	reference.ciphertext = plaintext;
+
+	run(options, "reference.fillMatrix" + suffix, length, [&]
+	{
+		reference.transposeMatrix.clear();
+		reference.fillMatrix();
+	});
+
+	run(options, "reference.reOrderMatrix" + suffix, length, [&]
+	{
+		reference.cipherMatrix.clear();
+		reference.reOrderMatrix();
+	});
+
+	run(options, "reference.reconstructMatrix" + suffix, length, [&]
+	{
+		reference.cipherMatrix.clear();
+		reference.transposeMatrix.clear();
+		reference.reconstructMatrix();
+	});
+
+	run(options, "reference.matrixSize" + suffix, 0, [&] { sink = sink + ReferenceCipher::getMatrixSize((int)length); });
+}
+
+/*
+Purpose:		Runs the pipeline benchmarks of one message size.
+Pre-condition:	Takes the options, the plaintext and a key for its length.
+Post-condition:	The benchmarks are run and reported.
+*/
+static void runPipelineBenchmarks(const Options& options, const std::string& plaintext, const CipherKey& key)
+{
+	size_t length = plaintext.length();
+	if (length > PIPELINE_MAX_SIZE)
+	{
+		return;
+	}
+
+	std::string suffix = "/" + formatSize(length);
+	std::string output(length, ' ');
+	std::string ciphertext(length, ' ');
+	const std::vector<int> columns = { 3, 0, 4, 1, 2 };
+
+	for (size_t rounds : { (size_t)1, PIPELINE_ROUNDS })
+	{
+		CipherPipeline pipeline;
+		pipeline.addSubstitution(key.keyNum, key.keyPhrase);
+		pipeline.addRows(key.permutation);
+		pipeline.addColumns(columns);
+		pipeline.setRounds(rounds);
+		pipeline.compile(length);
+		pipeline.encrypt(plaintext, &ciphertext[0]);
+
+		std::string name = "pipeline." + std::to_string(rounds) + "Round";
+		run(options, name + ".encrypt" + suffix, length, [&] { pipeline.encrypt(plaintext, &output[0]); });
+		run(options, name + ".decrypt" + suffix, length, [&] { pipeline.decrypt(ciphertext, &output[0]); });
+		run(options, name + ".encryptByStage" + suffix, length, [&] { pipeline.encryptByStage(plaintext, &output[0]); });
+		run(options, name + ".compile" + suffix, length, [&] { pipeline.compile(length); });
+	}
+}
+
+/*
+Purpose:		Runs the benchmarks of one message size and key phrase length.
+Pre-condition:	Takes the options, the plaintext and a key for its length.
+Post-condition:	The benchmarks are run and reported.
+*/
+static void runPhraseBenchmarks(const Options& options, const std::string& plaintext, const CipherKey& key)
+{
+	size_t length = plaintext.length();
+	std::string suffix = "/" + formatSize(length) + "/" + std::to_string(key.keyPhrase.length());
+	std::string output(length, ' ');
+	std::string ciphertext(length, ' ');
+	KeySchedule schedule(key);
+
+	//decryption benchmarks need real ciphertext even when the encryption ones are filtered out
+	CipherEngine::encrypt(plaintext, schedule, &ciphertext[0]);
+
+	run(options, "engine.substitute" + suffix, length, [&]
+	{
+		schedule.getSubstitution().apply(plaintext.data(), 0, length, &output[0]);
+	});
+
+	run(options, "engine.invertSubstitute" + suffix, length, [&]
+	{
+		schedule.getSubstitution().invert(plaintext.data(), 0, length, &output[0]);
+	});
+
+	run(options, "engine.encrypt" + suffix, length, [&] { CipherEngine::encrypt(plaintext, schedule, &ciphertext[0]); });
+	run(options, "engine.decrypt" + suffix, length, [&] { CipherEngine::decrypt(ciphertext, schedule, &output[0]); });
+
+	//the schedule is built on every call when only the key is given
+	run(options, "engine.encryptWithKey" + suffix, length, [&] { CipherEngine::encrypt(plaintext, key, &output[0]); });
+
+	//a key store validates the key once and hands every later message of the same shape the schedule it cached
+	KeyStore store;
+	store.add(0, "bench", key);
+	std::shared_ptr<const KeySchedule> stored;
+	run(options, "keyStore.schedule" + suffix, 0, [&] { store.getSchedule(0, length, stored); });
+	run(options, "keyStore.encrypt" + suffix, length, [&]
+	{
+		store.getSchedule(0, length, stored);
+		CipherEngine::encrypt(plaintext, *stored, &output[0]);
+	});
+
+	//the same message with every row of its matrix widened to a multiple of a page, and the key shaped to the fewer rows
+	size_t pageWidth = Transposition::calcRowWidth(length, Transposition::PAGE_WIDTH);
+	std::shared_ptr<const KeySchedule> paged;
+	std::string pagedCiphertext(length, ' ');
+	store.getSchedule(0, length, paged, pageWidth);
+	CipherEngine::encrypt(plaintext, *paged, &pagedCiphertext[0], pageWidth);
+
+	run(options, "engine.encryptPageRows" + suffix, length, [&]
+	{
+		CipherEngine::encrypt(plaintext, *paged, &output[0], pageWidth);
+	});
+
+	run(options, "engine.decryptPageRows" + suffix, length, [&]
+	{
+		CipherEngine::decrypt(pagedCiphertext, *paged, &output[0], pageWidth);
+	});
+
+	//a context keeps its buffers between calls, so once the first run has sized them no call allocates
+	CipherContext context;
+	std::string typed = makeTyped(plaintext);
+	std::string_view result;
+	run(options, "context.encrypt" + suffix, length, [&] { context.encrypt(plaintext, schedule, result); });
+	run(options, "context.decrypt" + suffix, length, [&] { context.decrypt(ciphertext, schedule, result); });
+	run(options, "context.encryptText" + suffix, length, [&] { context.encryptText(typed, schedule, result); });
+
+	if (length > REFERENCE_MAX_SIZE)
+	{
+		return;
+	}
+
+	ReferenceCipher reference(key);
+	reference.plaintext = plaintext;
+	reference.ciphertext = plaintext;
+
+	run(options, "reference.affine" + suffix, length, [&] { reference.affine(); });
+	run(options, "reference.invertAffine" + suffix, length, [&] { reference.invertAffine(); });
+	run(options, "reference.encrypt" + suffix, length, [&] { sink = sink + reference.encrypt(plaintext).length(); });
+	run(options, "reference.decrypt" + suffix, length, [&] { sink = sink + reference.decrypt(ciphertext).length(); });
+}
+
+/*
+Purpose:		Runs the benchmarks of the cryptanalyzer on English text encrypted with random keys.
+Pre-condition:	Takes the options and the random generator.
+Post-condition:	The benchmarks are run and reported with the candidate keys scored per second.
+*/
+static void runCrackBenchmarks(const Options& options, std::mt19937& random)
+{
+	std::string english;
+	size_t invalidOffset = 0;
+	Normalizer::normalize(LanguageModel::getSampleText(), english, Normalizer::Whitespace::ALL, invalidOffset);
+
+	LanguageModel model;
+	Cryptanalyzer analyzer(model);
+	CrackSettings settings;
+	std::vector<CrackResult> results;
+
+	for (size_t length : CRACK_SIZES)
+	{
+		std::string name = "crack/" + formatSize(length) + "/" + std::to_string(CRACK_PHRASE_LENGTH);
+		if (name.find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		std::string plaintext = english.substr(0, length);
+		std::string ciphertext(length, ' ');
+		CipherEngine::encrypt(plaintext, makeKey(length, CRACK_PHRASE_LENGTH, random), &ciphertext[0]);
+
+		Measurement result = measure([&] { analyzer.crack(ciphertext, settings, results); }, options.minTime);
+		report(options, name, length, result);
+
+		//the search is seeded, so each run scores about as many candidates as the last one
+		if (!options.csv)
+		{
+			char line[256];
+			std::snprintf(line, sizeof(line), "    %zu candidate keys per crack, %.0f candidates/s on %zu threads\n",
+				analyzer.getCandidates(), analyzer.getCandidates() / result.secondsPerOperation, analyzer.getThreadCount());
+			std::cout << line << std::flush;
+		}
+	}
+
+	//an audit of the longest ciphertext against a wordlist of random phrases of 3 to 14 letters holding its key phrase
+	size_t length = CRACK_SIZES[sizeof(CRACK_SIZES) / sizeof(CRACK_SIZES[0]) - 1];
+	std::string name = "crack.audit/" + formatSize(length) + "/" + std::to_string(AUDIT_PHRASES);
+	if (name.find(options.filter) == std::string::npos)
+	{
+		return;
+	}
+
+	CipherKey key = makeKey(length, CRACK_PHRASE_LENGTH, random);
+	std::string ciphertext(length, ' ');
+	CipherEngine::encrypt(english.substr(0, length), key, &ciphertext[0]);
+
+	PhraseList phrases;
+	for (size_t i = 0; i < AUDIT_PHRASES; i++)
+	{
+		phrases.letters += (i == AUDIT_PHRASES / 2) ? key.keyPhrase : makeLetters(3 + random() % 12, random);
+		phrases.ends.push_back(phrases.letters.length());
+	}
+
+	AuditSettings audit;
+	audit.permutation = key.permutation;
+
+	Measurement result = measure([&] { analyzer.audit(ciphertext, phrases, audit, results); }, options.minTime);
+	report(options, name, length, result);
+
+	if (!options.csv)
+	{
+		char line[256];
+		std::snprintf(line, sizeof(line), "    %zu candidate keys per audit, %.0f candidates/s on %zu threads\n",
+			analyzer.getCandidates(), analyzer.getCandidates() / result.secondsPerOperation, analyzer.getThreadCount());
+		std::cout << line << std::flush;
+	}
+}
+
+/*
+Purpose:		Reads the command line into the options.
+Pre-condition:	Takes the arguments of main and the options to fill.
+Post-condition:	Returns true if the command line is usable. False otherwise, after printing why.
+*/
+static bool parseArguments(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+
+		if (flag == "--csv")
+		{
+			options.csv = true;
+			continue;
+		}
+
+		if (flag != "--filter" && flag != "--max-size" && flag != "--phrases" && flag != "--min-time")
+		{
+			std::cerr << "Error: unknown option " << flag << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Error: " << flag << " needs a value\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+
+		if (flag == "--filter")
+		{
+			options.filter = value;
+		}
+		else if (flag == "--max-size")
+		{
+			if (!parseSize(value, options.maxSize) || options.maxSize < MIN_SIZE || options.maxSize > MAX_SIZE)
+			{
+				std::cerr << "Error: size must be from 16 to 1G\n";
+				return false;
+			}
+		}
+		else if (flag == "--phrases")
+		{
+			std::istringstream lengths(value);
+			options.phraseLengths.clear();
+
+			for (std::string length; std::getline(lengths, length, ',');)
+			{
+				size_t phraseLength = 0;
+				if (!parseSize(length, phraseLength) || phraseLength == 0)
+				{
+					std::cerr << "Error: phrase lengths must be positive integers\n";
+					return false;
+				}
+				options.phraseLengths.push_back(phraseLength);
+			}
+		}
+		else
+		{
+			std::istringstream seconds(value);
+			if (!(seconds >> options.minTime) || !seconds.eof() || options.minTime < 0)
+			{
+				std::cerr << "Error: minimum time must be a number of seconds\n";
+				return false;
+			}
+		}
+	}
+
+	return !options.phraseLengths.empty();
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseArguments(argc, argv, options))
+	{
+		std::cerr << "Usage: bench [--filter text] [--max-size bytes] [--phrases lengths] [--min-time seconds] [--csv]\n";
+		return 2;
+	}
+
+	if (options.csv)
+	{
+		std::cout << "name,iterations,ns_per_op,bytes_per_second,allocs_per_op\n";
+	}
+	else
+	{
+		char line[256];
+		std::snprintf(line, sizeof(line), "%-44s %12s %16s %14s %12s\n", "Benchmark", "Iterations", "Time/op (ns)",
+			"Bytes/s", "Allocs/op");
+		std::cout << "Substitution kernel: " << Substitution::getKernelName() << "\n" << line;
+		std::cout << std::string(102, '-') << "\n";
+	}
+
+	std::mt19937 random(BENCH_SEED);
+	BenchFixedKey::install();
+
+	//sizes grow by SIZE_STEP up to the largest asked for, which is measured even when it is not on a step
+	std::vector<size_t> lengths;
+	for (size_t length = MIN_SIZE; length <= options.maxSize; length *= SIZE_STEP)
+	{
+		lengths.push_back(length);
+	}
+	if (lengths.back() != options.maxSize)
+	{
+		lengths.push_back(options.maxSize);
+	}
+
+	for (size_t length : lengths)
+	{
+		std::string plaintext = makeLetters(length, random);
+
+		runSizeBenchmarks(options, plaintext, makeKey(length, options.phraseLengths[0], random));
+		runPipelineBenchmarks(options, plaintext, makeKey(length, options.phraseLengths[0], random));
+
+		for (size_t phraseLength : options.phraseLengths)
+		{
+			runPhraseBenchmarks(options, plaintext, makeKey(length, phraseLength, random));
+		}
+	}
+
+	runCrackBenchmarks(options, random);
+
+	return 0;
+}
@@ -0,0 +1,933 @@
+/*
+Author:			My Tran
+Filename:		cli.cpp
+Description:	This file is a command line tool for the cipher, for use in scripts and pipelines in place of the menu of
+the Encryptor class. Text is read from a file or standard input in large blocks and written to a file or standard output
+in one go, and no console screens are drawn.
+
+Usage:	cli (-e | -d) [-n keyNum] [-p keyPhrase] [-r rowCombination] [-k keyFile] [-b blockSize] [-f] [-m]
+			[-a archive] [-z] [-g alignment] [-x record] [-u keyId] [-t keyStore] [-l pipeline] [-y alphabet] [-i input]
+			[-o output] [-s format]
+
+	-e, --encrypt		encrypt the input
+	-d, --decrypt		decrypt the input
+	-n, --key-num		numerical key of the affine cipher
+	-p, --key-phrase	key word or phrase, spaces are removed and letters made lower case
+	-r, --rows			row combination, numbers separated by commas or spaces
+	-k, --key-file		file holding "keyNum", "keyPhrase" and "permutation" lines, each followed by its value(s)
+	-b, --block-size	encrypt in blocks of this many letters using the stream format (decryption reads it back from
+						the stream header)
+	-f, --framed		encrypt into the frame format, a header giving the message length followed by the ciphertext
+						(decryption recognizes the header and writes the plaintext as soon as each part of it is ready)
+	-m, --mmap			map the input and output files into memory and run the cipher over them without copying,
+						using every core for large files (the input must hold only lower case letters and may end
+						in a new line)
+	-a, --archive		encrypt each line of the input into its own record of this archive file, or decrypt every record
+						of it into one line of output each
+	-z, --pack			store the ciphertext of the archive packed at 5 bits a letter (decryption recognizes a packed
+						archive from its header)
+	-g, --align			widen the rows of each record's matrix to a multiple of this many letters, such as 64 for cache
+						lines or 4096 for pages (decryption uses the row width stored in each record)
+	-x, --record		decrypt only this record of the archive, counting from 0
+	-u, --key-id		number stored with each record to identify the key, 0 unless given
+	-t, --key-store		with -a, take the keys from this key store file instead: lines are encrypted with the key
+						numbered by -u, and each record is decrypted with the key numbered in it
+	-l, --pipeline		run the stages of this pipeline file, as read by CipherPipeline, over the whole input in place of
+						a key
+	-y, --alphabet		"letters" (the default), "printable" for the printable characters of ASCII from space to tilde,
+						or "bytes" for every byte value, encrypted with AlphabetCipher: the input is taken and the
+						result written byte for byte, and the key phrase is used as given. A new line is not printable,
+						so one ending printable text is left off and written back after the result, and text of
+						several lines needs "bytes" (cannot be used with -b, -f, -m, -a or -l)
+	-i, --input			input file, standard input if left out or "-"
+	-o, --output		output file, standard output if left out or "-"
+	-s, --stats			write the time spent in each stage of the cipher to standard error once done, as "json" or
+						"prometheus" (needs a build with ENCRYPTOR_INSTRUMENTATION defined, otherwise every count is zero)
+
+Values given on the command line override the ones in the key file. Unless -y is given, whitespace in the input is
+removed and letters are made lower case, and any other character is an error. Exit status is 0 on success, 1 if the cipher fails and 2 on bad usage.
+*/
+#include "AlphabetCipher.h"
+#include "CipherEngine.h"
+#include "CipherPipeline.h"
+#include "FileCipher.h"
+#include "Instrumentation.h"
+#include "KeyStore.h"
+#include "MappedFile.h"
+#include "MessageArchive.h"
+#include "Normalizer.h"
+#include "OnlineDecryptor.h"
+#include "StreamCipher.h"
+#include "Transposition.h"
+#include<fstream>
+#include<iostream>
+#include<sstream>
+#include<streambuf>
+#include<string>
+#include<vector>
+
+const size_t IO_BUFFER_SIZE = 1 << 20;	//bytes read from or written to a file at a time
+const int EXIT_CIPHER_ERROR = 1;	//exit status when the cipher rejects the input or key
+const int EXIT_USAGE_ERROR = 2;	//exit status when the command line is wrong
+
+//everything given on the command line
+struct Options
+{
+	int mode = 0;	//'e' to encrypt, 'd' to decrypt
+	CipherKey key;	//key assembled from the key file and the flags
+	bool hasKeyNum = false;	//true if a key number was given
+	bool hasKeyPhrase = false;	//true if a key phrase was given
+	std::string keyPhraseText;	//key phrase as given, before spaces are removed from one of letters
+	bool hasPermutation = false;	//true if a row combination was given
+	size_t blockSize = 0;	//letters per block for the stream format, 0 to encrypt the whole input at once
+	bool framed = false;	//true to write the frame header before the ciphertext
+	bool mapped = false;	//true to run over memory mapped files
+	std::string archivePath;	//archive the records are written to or read from, empty for none
+	bool packed = false;	//true to store the ciphertext of the archive packed
+	size_t alignment = 0;	//alignment the rows of the archive's matrices are widened to, 0 for the least square
+	size_t record = 0;	//record of the archive to decrypt
+	bool hasRecord = false;	//true to decrypt only one record of the archive
+	uint32_t keyId = 0;	//number stored with each record to identify the key
+	std::string keyStorePath;	//key store file the archive's keys come from, empty to use the key given
+	std::string pipelinePath;	//pipeline file to run in place of the key, empty for none
+	std::string alphabet;	//"printable" or "bytes" to encrypt the input as it is, empty for lower case letters
+	std::string inputPath = "-";	//file to read, "-" for standard input
+	std::string outputPath = "-";	//file to write, "-" for standard output
+	std::string statsFormat;	//"json" or "prometheus" to write the stats once done, empty to leave them out
+};
+
+//hands back the bytes read to recognize the format of the input, then the rest of the input
+class RewoundInput : public std::streambuf
+{
+	public:
+		/*
+		Purpose:		Creates the buffer over an input some bytes were already read from.
+		Pre-condition:	Takes the bytes already read and the buffer of the input, which must outlive this one.
+		Post-condition:	None
+		*/
+		RewoundInput(const std::string& head, std::streambuf* source)
+			: head(head), source(source), buffer(IO_BUFFER_SIZE)
+		{
+			setg(&this->head[0], &this->head[0], &this->head[0] + this->head.length());
+		}
+	protected:
+		/*
+		Purpose:		Refills the buffer from the input once the bytes read first are used up.
+		Pre-condition:	None
+		Post-condition:	Returns the next byte, or eof at the end of the input.
+		*/
+		int_type underflow() override
+		{
+			if (source->sgetc() == traits_type::eof())
+			{
+				return traits_type::eof();
+			}
+
+			//only what the input has ready is taken, so a decoder writing plaintext as ciphertext arrives is not held up
+			std::streamsize ready = source->in_avail();
+			std::streamsize wanted = (ready <= 0) ? 1 : ((size_t)ready < buffer.size()) ? ready : (std::streamsize)buffer.size();
+			std::streamsize count = source->sgetn(buffer.data(), wanted);
+			setg(buffer.data(), buffer.data(), buffer.data() + count);
+
+			return traits_type::to_int_type(buffer[0]);
+		}
+	private:
+		//private data members
+		std::string head;	//bytes read to recognize the format
+		std::streambuf* source;	//buffer of the input the rest is read from
+		std::vector<char> buffer;	//bytes taken from the input
+};
+
+/*
+Purpose:		Prints how to use the tool.
+Pre-condition:	Takes the stream to print to.
+Post-condition:	Usage is printed.
+*/
+static void printUsage(std::ostream& output)
+{
+	output << "Usage: cli (-e | -d) [-n keyNum] [-p keyPhrase] [-r rowCombination] [-k keyFile] [-b blockSize] [-f]\n";
+	output << "           [-m] [-a archive] [-z] [-g alignment] [-x record] [-u keyId] [-t keyStore] [-l pipeline]\n";
+	output << "           [-y alphabet] [-i input] [-o output] [-s format]\n";
+}
+
+/*
+Purpose:		Removes spaces from a key phrase and makes its letters lower case.
+Pre-condition:	Takes the phrase as given and the string the letters are stored in.
+Post-condition:	Returns true if the phrase held only letters and spaces. Otherwise the offending character is reported.
+*/
+static bool parseKeyPhrase(const std::string& value, std::string& keyPhrase)
+{
+	size_t invalidOffset = 0;
+	if (Normalizer::normalize(value, keyPhrase, Normalizer::Whitespace::SPACES, invalidOffset) == CipherStatus::OK)
+	{
+		return true;
+	}
+
+	std::cerr << "Error: invalid character '" << value[invalidOffset] << "' at position " << invalidOffset + 1;
+	std::cerr << " of the key phrase\n";
+	return false;
+}
+
+/*
+Purpose:		Reads the key values of a key file into the options, leaving out the ones given as flags.
+Pre-condition:	Takes the path of the key file and the options.
+Post-condition:	Returns true if the file was read. False if it could not be opened or has a line it does not understand.
+*/
+static bool loadKeyFile(const std::string& path, Options& options)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cerr << "Error: could not open key file " << path << "\n";
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream fields(line);
+		std::string name;
+		fields >> name;
+
+		std::string value;
+		std::getline(fields >> std::ws, value);
+
+		//blank lines and lines starting with # are skipped
+		if (name.empty() || name[0] == '#')
+		{
+			continue;
+		}
+
+		if (name == "keyNum" && !options.hasKeyNum)
+		{
+			std::istringstream number(value);
+			number >> options.key.keyNum;
+		}
+		else if (name == "keyPhrase" && !options.hasKeyPhrase)
+		{
+			options.keyPhraseText = value;
+		}
+		else if (name == "permutation" && !options.hasPermutation)
+		{
+			if (!KeySchedule::parsePermutation(value, options.key.permutation))
+			{
+				std::cerr << "Error: invalid permutation in key file " << path << "\n";
+				return false;
+			}
+		}
+		else if (name != "keyNum" && name != "keyPhrase" && name != "permutation")
+		{
+			std::cerr << "Error: unknown entry " << name << " in key file " << path << "\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Reads the command line into the options.
+Pre-condition:	Takes the arguments of main and the options to fill.
+Post-condition:	Returns true if the command line is usable. False otherwise, after printing why.
+*/
+static bool parseArguments(int argc, char* argv[], Options& options)
+{
+	std::string keyFile;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+
+		if (flag == "-e" || flag == "--encrypt" || flag == "-d" || flag == "--decrypt")
+		{
+			options.mode = (flag == "-e" || flag == "--encrypt") ? 'e' : 'd';
+			continue;
+		}
+
+		if (flag == "-m" || flag == "--mmap")
+		{
+			options.mapped = true;
+			continue;
+		}
+
+		if (flag == "-f" || flag == "--framed")
+		{
+			options.framed = true;
+			continue;
+		}
+
+		if (flag == "-z" || flag == "--pack")
+		{
+			options.packed = true;
+			continue;
+		}
+
+		//every other flag takes a value
+		const char* const valueFlags[] = { "-n", "--key-num", "-p", "--key-phrase", "-r", "--rows", "-k", "--key-file",
+			"-b", "--block-size", "-a", "--archive", "-g", "--align", "-x", "--record", "-u", "--key-id", "-t", "--key-store", "-l",
+			"--pipeline", "-y", "--alphabet", "-i", "--input", "-o", "--output", "-s", "--stats" };
+		bool known = false;
+		for (const char* valueFlag : valueFlags)
+		{
+			known = known || (flag == valueFlag);
+		}
+
+		if (!known)
+		{
+			std::cerr << "Error: unknown option " << flag << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Error: " << flag << " needs a value\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+
+		if (flag == "-n" || flag == "--key-num")
+		{
+			std::istringstream number(value);
+			if (!(number >> options.key.keyNum) || !number.eof())
+			{
+				std::cerr << "Error: key number must be an integer\n";
+				return false;
+			}
+			options.hasKeyNum = true;
+		}
+		else if (flag == "-p" || flag == "--key-phrase")
+		{
+			options.keyPhraseText = value;
+			options.hasKeyPhrase = true;
+		}
+		else if (flag == "-r" || flag == "--rows")
+		{
+			if (!KeySchedule::parsePermutation(value, options.key.permutation))
+			{
+				std::cerr << "Error: row combination must be a list of numbers\n";
+				return false;
+			}
+			options.hasPermutation = true;
+		}
+		else if (flag == "-k" || flag == "--key-file")
+		{
+			keyFile = value;
+		}
+		else if (flag == "-b" || flag == "--block-size")
+		{
+			std::istringstream number(value);
+			if (!(number >> options.blockSize) || !number.eof() || options.blockSize == 0 || value[0] == '-')
+			{
+				std::cerr << "Error: block size must be a positive integer\n";
+				return false;
+			}
+		}
+		else if (flag == "-a" || flag == "--archive")
+		{
+			options.archivePath = value;
+		}
+		else if (flag == "-g" || flag == "--align")
+		{
+			std::istringstream number(value);
+			if (!(number >> options.alignment) || !number.eof() || options.alignment == 0 || value[0] == '-')
+			{
+				std::cerr << "Error: alignment must be a positive integer\n";
+				return false;
+			}
+		}
+		else if (flag == "-x" || flag == "--record")
+		{
+			std::istringstream number(value);
+			if (!(number >> options.record) || !number.eof() || value[0] == '-')
+			{
+				std::cerr << "Error: record must be a whole number\n";
+				return false;
+			}
+			options.hasRecord = true;
+		}
+		else if (flag == "-u" || flag == "--key-id")
+		{
+			std::istringstream number(value);
+			if (!(number >> options.keyId) || !number.eof() || value[0] == '-')
+			{
+				std::cerr << "Error: key id must be a whole number\n";
+				return false;
+			}
+		}
+		else if (flag == "-t" || flag == "--key-store")
+		{
+			options.keyStorePath = value;
+		}
+		else if (flag == "-l" || flag == "--pipeline")
+		{
+			options.pipelinePath = value;
+		}
+		else if (flag == "-y" || flag == "--alphabet")
+		{
+			if (value != "letters" && value != "printable" && value != "bytes")
+			{
+				std::cerr << "Error: alphabet must be letters, printable or bytes\n";
+				return false;
+			}
+			options.alphabet = (value == "letters") ? "" : value;
+		}
+		else if (flag == "-i" || flag == "--input")
+		{
+			options.inputPath = value;
+		}
+		else if (flag == "-s" || flag == "--stats")
+		{
+			if (value != "json" && value != "prometheus")
+			{
+				std::cerr << "Error: stats format must be json or prometheus\n";
+				return false;
+			}
+			options.statsFormat = value;
+		}
+		else
+		{
+			options.outputPath = value;
+		}
+	}
+
+	if (options.mode == 0)
+	{
+		std::cerr << "Error: choose -e to encrypt or -d to decrypt\n";
+		return false;
+	}
+
+	if (options.mapped && (options.inputPath == "-" || options.outputPath == "-" || options.blockSize > 0))
+	{
+		std::cerr << "Error: -m needs an input file and an output file and cannot be used with -b\n";
+		return false;
+	}
+
+	if (options.framed && (options.mapped || options.blockSize > 0))
+	{
+		std::cerr << "Error: -f cannot be used with -b or -m\n";
+		return false;
+	}
+
+	if (!options.archivePath.empty() && (options.mapped || options.blockSize > 0 || options.framed))
+	{
+		std::cerr << "Error: -a cannot be used with -b, -f or -m\n";
+		return false;
+	}
+
+	if (options.hasRecord && (options.archivePath.empty() || options.mode != 'd'))
+	{
+		std::cerr << "Error: -x only picks a record to decrypt from the archive given with -a\n";
+		return false;
+	}
+
+	if (options.packed && (options.archivePath.empty() || options.mode != 'e'))
+	{
+		std::cerr << "Error: -z only packs the archive given with -a when encrypting\n";
+		return false;
+	}
+
+	if (options.alignment > 0 && (options.archivePath.empty() || options.mode != 'e'))
+	{
+		std::cerr << "Error: -g only aligns the archive given with -a when encrypting\n";
+		return false;
+	}
+
+	if (!options.keyStorePath.empty() && options.archivePath.empty())
+	{
+		std::cerr << "Error: -t only gives the keys of the archive given with -a\n";
+		return false;
+	}
+
+	bool keyGiven = options.hasKeyNum || options.hasKeyPhrase || options.hasPermutation || !keyFile.empty();
+	if (!options.pipelinePath.empty() && (keyGiven || options.mapped || options.blockSize > 0 || options.framed ||
+		!options.archivePath.empty()))
+	{
+		std::cerr << "Error: -l takes the place of the key and cannot be used with -n, -p, -r, -k, -b, -f, -m or -a\n";
+		return false;
+	}
+
+	if (!options.alphabet.empty() && (options.mapped || options.blockSize > 0 || options.framed ||
+		!options.archivePath.empty() || !options.pipelinePath.empty()))
+	{
+		std::cerr << "Error: -y cannot be used with -b, -f, -m, -a or -l\n";
+		return false;
+	}
+
+	if (!keyFile.empty() && !loadKeyFile(keyFile, options))
+	{
+		return false;
+	}
+
+	//a key phrase of another alphabet is used as it was given
+	if (!options.alphabet.empty())
+	{
+		options.key.keyPhrase = options.keyPhraseText;
+		return true;
+	}
+
+	return parseKeyPhrase(options.keyPhraseText, options.key.keyPhrase);
+}
+
+/*
+Purpose:		Reads the whole input, removing whitespace and making letters lower case.
+Pre-condition:	Takes the input stream and the string the letters are stored in.
+Post-condition:	Returns OK, INVALID_CHARACTER if the input has a character other than letters and whitespace, or
+				STREAM_ERROR if it could not be read.
+*/
+static CipherStatus readLetters(std::istream& input, std::string& letters)
+{
+	std::vector<char> buffer(IO_BUFFER_SIZE);
+	size_t offset = 0;	//bytes of the input before the buffer
+
+	while (input)
+	{
+		{
+			INSTRUMENT_STAGE(CipherStage::INPUT, 0);
+			input.read(buffer.data(), buffer.size());
+		}
+
+		//the letters are compacted straight into the end of the string, which is trimmed to the ones kept
+		size_t count = (size_t)input.gcount();
+		size_t length = letters.length();
+		size_t invalidOffset = 0;
+		letters.resize(length + count);
+		letters.resize(length + Normalizer::normalize(buffer.data(), count, &letters[length], Normalizer::Whitespace::ALL, invalidOffset));
+
+		if (invalidOffset != Normalizer::NO_INVALID)
+		{
+			std::cerr << "Invalid character '" << buffer[invalidOffset] << "' at byte " << offset + invalidOffset << " of the input\n";
+			return CipherStatus::INVALID_CHARACTER;
+		}
+
+		offset += count;
+	}
+
+	return input.bad() ? CipherStatus::STREAM_ERROR : CipherStatus::OK;
+}
+
+/*
+Purpose:		Reads the start of the input for as long as it matches the first word of a stream or frame header.
+Pre-condition:	Takes the input and the string the bytes read are stored in.
+Post-condition:	head holds the bytes read, which equal StreamCipher::MAGIC or OnlineDecryptor::MAGIC if the input starts
+				with one. The first byte that did not match is left in the input.
+*/
+static void readHead(std::istream& input, std::string& head)
+{
+	const std::string streamMagic = StreamCipher::MAGIC;
+	const std::string frameMagic = OnlineDecryptor::MAGIC;
+
+	//ciphertext may start with the same letters, so the whole word has to match before it is taken for a header
+	for (int next = input.peek(); next != EOF && head != streamMagic && head != frameMagic; next = input.peek())
+	{
+		head.push_back((char)next);
+		if (streamMagic.compare(0, head.length(), head) != 0 && frameMagic.compare(0, head.length(), head) != 0)
+		{
+			head.pop_back();
+			return;
+		}
+
+		input.get();
+	}
+}
+
+/*
+Purpose:		Encrypts or decrypts the whole input at once.
+Pre-condition:	Takes the options, the schedule of the key, and the input and output streams.
+Post-condition:	Returns the status of the cipher. The result followed by a new line is written if it is OK.
+*/
+static CipherStatus runWhole(const Options& options, const KeySchedule& schedule, std::istream& input, std::ostream& output)
+{
+	std::string text;
+	CipherStatus status = readLetters(input, text);
+	if (status != CipherStatus::OK)
+	{
+		return status;
+	}
+
+	std::string result(text.length(), ' ');
+	if (options.mode == 'e')
+	{
+		status = CipherEngine::encrypt(text, schedule, &result[0]);
+	}
+	else
+	{
+		status = CipherEngine::decrypt(text, schedule, &result[0]);
+	}
+
+	if (status == CipherStatus::OK && options.framed && options.mode == 'e')
+	{
+		status = OnlineDecryptor::writeHeader(output, result.length());
+	}
+
+	if (status == CipherStatus::OK)
+	{
+		INSTRUMENT_STAGE(CipherStage::OUTPUT, result.length());
+		output.write(result.data(), result.length());
+		output << "\n";
+		output.flush();
+	}
+
+	return (status == CipherStatus::OK && !output) ? CipherStatus::STREAM_ERROR : status;
+}
+
+/*
+Purpose:		Encrypts or decrypts the whole input as it is over another alphabet.
+Pre-condition:	Takes the options, the cipher of the key over the alphabet, and the input and output streams.
+Post-condition:	Returns the status of the cipher. Exactly the bytes of the result are written if it is OK, followed by
+				the new line ending printable input if it had one. Otherwise the first character outside the alphabet
+				is reported.
+*/
+template<typename Alphabet>
+static CipherStatus runAlphabet(const Options& options, const AlphabetCipher<Alphabet>& cipher, std::istream& input,
+	std::ostream& output)
+{
+	std::string text;
+	std::vector<char> buffer(IO_BUFFER_SIZE);
+
+	while (input)
+	{
+		INSTRUMENT_STAGE(CipherStage::INPUT, 0);
+		input.read(buffer.data(), buffer.size());
+		text.append(buffer.data(), (size_t)input.gcount());
+	}
+
+	if (input.bad())
+	{
+		return CipherStatus::STREAM_ERROR;
+	}
+
+	//a new line is not printable, so one ending the text is left off and written back only if it was there
+	bool newLine = (options.alphabet == "printable" && !text.empty() && text.back() == '\n');
+	if (newLine)
+	{
+		text.pop_back();
+	}
+
+	std::string result(text.length(), ' ');
+	CipherStatus status = (options.mode == 'e') ? cipher.encrypt(text, &result[0]) : cipher.decrypt(text, &result[0]);
+
+	if (status == CipherStatus::INVALID_CHARACTER)
+	{
+		//only looked for once the cipher has failed, so valid input is checked in one pass
+		size_t invalidOffset = 0;
+		while (AlphabetCipher<Alphabet>::isInAlphabet(std::string_view(&text[invalidOffset], 1)))
+		{
+			invalidOffset++;
+		}
+		std::cerr << "Invalid character with code " << (int)(unsigned char)text[invalidOffset] << " at byte "
+			<< invalidOffset << " of the input\n";
+	}
+
+	if (status == CipherStatus::OK)
+	{
+		INSTRUMENT_STAGE(CipherStage::OUTPUT, result.length());
+		output.write(result.data(), result.length());
+		if (newLine)
+		{
+			output << "\n";
+		}
+		output.flush();
+	}
+
+	return (status == CipherStatus::OK && !output) ? CipherStatus::STREAM_ERROR : status;
+}
+
+/*
+Purpose:		Encrypts or decrypts the whole input with the stages of a pipeline.
+Pre-condition:	Takes the options, the pipeline, and the input and output streams.
+Post-condition:	Returns the status of the pipeline. The result followed by a new line is written if it is OK.
+*/
+static CipherStatus runPipeline(const Options& options, CipherPipeline& pipeline, std::istream& input, std::ostream& output)
+{
+	std::string text;
+	CipherStatus status = readLetters(input, text);
+
+	//the stages are folded for the length of this input
+	if (status == CipherStatus::OK)
+	{
+		status = pipeline.compile(text.length());
+	}
+
+	std::string result(text.length(), ' ');
+	if (status == CipherStatus::OK)
+	{
+		status = (options.mode == 'e') ? pipeline.encrypt(text, &result[0]) : pipeline.decrypt(text, &result[0]);
+	}
+
+	if (status == CipherStatus::OK)
+	{
+		INSTRUMENT_STAGE(CipherStage::OUTPUT, result.length());
+		output.write(result.data(), result.length());
+		output << "\n";
+		output.flush();
+	}
+
+	return (status == CipherStatus::OK && !output) ? CipherStatus::STREAM_ERROR : status;
+}
+
+/*
+Purpose:		Encrypts each line of the input into its own record of the archive, skipping blank lines.
+Pre-condition:	Takes the options, the schedule of the key given, the key store or nullptr to use the key given, and the
+				input stream.
+Post-condition:	Returns OK if every line was added and the archive finished, otherwise the problem found.
+*/
+static CipherStatus writeArchive(const Options& options, const KeySchedule& schedule, KeyStore* store, std::istream& input)
+{
+	std::shared_ptr<const KeySchedule> stored;
+
+	ArchiveWriter writer;
+	CipherStatus status = writer.open(options.archivePath, options.packed, options.alignment);
+
+	std::string letters;
+	for (std::string line; status == CipherStatus::OK && std::getline(input, line);)
+	{
+		size_t invalidOffset = 0;
+		status = Normalizer::normalize(line, letters, Normalizer::Whitespace::ALL, invalidOffset);
+
+		if (status != CipherStatus::OK || letters.empty())
+		{
+			continue;
+		}
+
+		//each line gets the store's schedule for its own length and row width
+		const KeySchedule* lineSchedule = &schedule;
+		if (store != nullptr)
+		{
+			size_t rowWidth = Transposition::calcRowWidth(letters.length(), options.alignment);
+			status = store->getSchedule(options.keyId, letters.length(), stored, rowWidth);
+			lineSchedule = stored.get();
+		}
+
+		if (status == CipherStatus::OK)
+		{
+			status = writer.append(options.keyId, letters, *lineSchedule);
+		}
+	}
+
+	if (status == CipherStatus::OK && input.bad())
+	{
+		status = CipherStatus::STREAM_ERROR;
+	}
+
+	CipherStatus closed = writer.close();
+
+	return (status == CipherStatus::OK) ? closed : status;
+}
+
+/*
+Purpose:		Decrypts the records of the archive, or only the one asked for, each into a line of output.
+Pre-condition:	Takes the options, the schedule of the key given, the key store or nullptr to use the key given, and the
+				output stream.
+Post-condition:	Returns OK if every record was written, otherwise the problem found.
+*/
+static CipherStatus readArchive(const Options& options, const KeySchedule& schedule, KeyStore* store, std::ostream& output)
+{
+	std::shared_ptr<const KeySchedule> stored;
+
+	ArchiveReader reader;
+	CipherStatus status = reader.open(options.archivePath);
+
+	size_t first = options.hasRecord ? options.record : 0;
+	size_t end = options.hasRecord ? first + 1 : reader.getRecordCount();
+	std::string plaintext;
+
+	for (size_t r = first; status == CipherStatus::OK && r < end; r++)
+	{
+		ArchiveRecord record;
+		std::string_view ciphertext;
+		status = reader.read(r, record, ciphertext);
+
+		//the key number stored in the record picks its key from the store
+		const KeySchedule* recordSchedule = &schedule;
+		if (status == CipherStatus::OK && store != nullptr)
+		{
+			status = store->getSchedule(record.keyId, ciphertext.length(), stored, record.matrixSize);
+			recordSchedule = stored.get();
+		}
+
+		if (status == CipherStatus::OK)
+		{
+			plaintext.resize(ciphertext.length());
+			status = CipherEngine::decrypt(ciphertext, *recordSchedule, &plaintext[0], record.matrixSize);
+		}
+
+		if (status == CipherStatus::OK)
+		{
+			INSTRUMENT_STAGE(CipherStage::OUTPUT, plaintext.length());
+			output.write(plaintext.data(), plaintext.length());
+			output << "\n";
+		}
+	}
+
+	output.flush();
+
+	return (status == CipherStatus::OK && !output) ? CipherStatus::STREAM_ERROR : status;
+}
+
+/*
+Purpose:		Reports how the run went and writes the stats if they were asked for.
+Pre-condition:	Takes the options and the status of the cipher.
+Post-condition:	Returns the exit status of the tool.
+*/
+static int finish(const Options& options, CipherStatus status)
+{
+	if (options.statsFormat == "json")
+	{
+		Instrumentation::writeJson(std::cerr);
+	}
+	else if (options.statsFormat == "prometheus")
+	{
+		Instrumentation::writePrometheus(std::cerr);
+	}
+
+	if (status != CipherStatus::OK)
+	{
+		std::cerr << "Error: " << CipherEngine::describeStatus(status) << "\n";
+		return EXIT_CIPHER_ERROR;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseArguments(argc, argv, options))
+	{
+		printUsage(std::cerr);
+		return EXIT_USAGE_ERROR;
+	}
+
+	//the clock for the rates in the stats starts here rather than at the first message
+	Instrumentation::reset();
+
+	KeySchedule schedule(options.key);
+	CipherStatus status;
+
+	KeyStore store;
+	KeyStore* storePointer = nullptr;
+	if (!options.keyStorePath.empty())
+	{
+		status = store.load(options.keyStorePath);
+		if (status != CipherStatus::OK)
+		{
+			std::cerr << "Error: " << CipherEngine::describeStatus(status) << " (line " << store.getErrorLine() << " of ";
+			std::cerr << options.keyStorePath << ")\n";
+			return EXIT_USAGE_ERROR;
+		}
+		storePointer = &store;
+	}
+
+	CipherPipeline pipeline;
+	if (!options.pipelinePath.empty())
+	{
+		status = pipeline.load(options.pipelinePath);
+		if (status != CipherStatus::OK)
+		{
+			std::cerr << "Error: " << CipherEngine::describeStatus(status) << " (line " << pipeline.getErrorLine() << " of ";
+			std::cerr << options.pipelinePath << ")\n";
+			return EXIT_USAGE_ERROR;
+		}
+	}
+
+	//mapped files are read and written by the cipher itself, so no streams are opened
+	if (options.mapped)
+	{
+		ParallelCipher parallel;
+		FileCipher files(schedule, &parallel);
+		status = (options.mode == 'e') ? files.encrypt(options.inputPath, options.outputPath)
+			: files.decrypt(options.inputPath, options.outputPath);
+
+		return finish(options, status);
+	}
+
+	//opening the output truncates it before a byte of the input is read
+	if (options.inputPath != "-" && options.outputPath != "-" &&
+		MappedFile::isSameFile(options.inputPath, options.outputPath))
+	{
+		std::cerr << "Error: " << CipherEngine::describeStatus(CipherStatus::SAME_FILE) << "\n";
+		return EXIT_USAGE_ERROR;
+	}
+
+	std::ios::sync_with_stdio(false);
+
+	//large buffers keep reads and writes few, and are set before the files are opened so the streams use them
+	std::vector<char> inputBuffer(IO_BUFFER_SIZE);
+	std::vector<char> outputBuffer(IO_BUFFER_SIZE);
+	std::ifstream inputFile;
+	std::ofstream outputFile;
+
+	if (options.inputPath != "-")
+	{
+		inputFile.rdbuf()->pubsetbuf(inputBuffer.data(), inputBuffer.size());
+		inputFile.open(options.inputPath, std::ios::binary);
+		if (!inputFile)
+		{
+			std::cerr << "Error: could not open " << options.inputPath << "\n";
+			return EXIT_USAGE_ERROR;
+		}
+	}
+
+	if (options.outputPath != "-")
+	{
+		outputFile.rdbuf()->pubsetbuf(outputBuffer.data(), outputBuffer.size());
+		outputFile.open(options.outputPath, std::ios::binary);
+		if (!outputFile)
+		{
+			std::cerr << "Error: could not open " << options.outputPath << "\n";
+			return EXIT_USAGE_ERROR;
+		}
+	}
+
+	std::istream& input = (options.inputPath != "-") ? (std::istream&)inputFile : std::cin;
+	std::ostream& output = (options.outputPath != "-") ? (std::ostream&)outputFile : std::cout;
+
+	//the stream and frame formats are recognized from the flags when encrypting and from the header when decrypting,
+	//and whatever was read to recognize them is read again by the decoder picked
+	std::string head;
+	if (options.mode == 'd' && options.archivePath.empty() && options.pipelinePath.empty() && options.alphabet.empty())
+	{
+		readHead(input, head);
+	}
+	RewoundInput rewoundBuffer(head, input.rdbuf());
+	std::istream rewound(&rewoundBuffer);
+	std::istream& remaining = head.empty() ? input : rewound;
+
+	if (!options.pipelinePath.empty())
+	{
+		status = runPipeline(options, pipeline, input, output);
+	}
+	else if (options.alphabet == "printable")
+	{
+		status = runAlphabet(options, PrintableCipher(options.key), input, output);
+	}
+	else if (options.alphabet == "bytes")
+	{
+		status = runAlphabet(options, ByteCipher(options.key), input, output);
+	}
+	else if (!options.archivePath.empty())
+	{
+		status = (options.mode == 'e') ? writeArchive(options, schedule, storePointer, input)
+			: readArchive(options, schedule, storePointer, output);
+	}
+	else if (options.mode == 'e' && options.blockSize > 0)
+	{
+		status = StreamCipher(schedule).encrypt(input, output, options.blockSize);
+	}
+	else if (head == StreamCipher::MAGIC)
+	{
+		status = StreamCipher(schedule).decrypt(rewound, output);
+	}
+	else if (head == OnlineDecryptor::MAGIC)
+	{
+		status = OnlineDecryptor(schedule).decrypt(rewound, output);
+	}
+	else
+	{
+		status = runWhole(options, schedule, remaining, output);
+	}
+
+	return finish(options, status);
+}
@@ -0,0 +1,427 @@
+/*
+Author:			My Tran
+Filename:		crack.cpp
+Description:	This file is a command line tool that recovers keys of the cipher from ciphertext alone using the
+Cryptanalyzer class, for training and red team exercises. The ciphertext is read from a file or standard input, and the
+most likely keys are written best first with the plaintext each one gives. With -d it audits the ciphertext against a
+wordlist instead, testing every phrase of the list as the key phrase and writing the ones that decrypt to English.
+
+Usage:	crack [-i input] [-t corpus] [-w phraseFile] [-l maxPeriod] [-c count] [-j threads] [-x limit] [-a restarts]
+		crack -d wordlist [-n keyNum] [-r rowCombination] [-s threshold] [-i input] [-t corpus] [-c count] [-j threads]
+			  [-x limit]
+
+	-i, --input			ciphertext file, standard input if left out or "-"
+	-t, --train			text to count the letter statistics from in place of the built in sample of English
+	-w, --words			file of candidate key phrases, one per line, tried in place of solving the key letters
+	-l, --max-period	longest key phrase tried when no candidate phrases are given (16 unless given)
+	-c, --count			number of results written (10 unless given)
+	-j, --threads		number of worker threads, one per hardware thread unless given
+	-x, --exhaustive	most row orders tried in full before searching by swapping rows (40320 unless given)
+	-a, --restarts		random starts of each search by swapping rows (8 unless given)
+	-d, --dictionary	wordlist to audit the ciphertext against, one key phrase per line
+	-n, --key-num		keyNum of the ciphertext when auditing, every keyNum is tried unless given
+	-r, --rows			row combination of the ciphertext when auditing, such as "2,0,1", every order of the rows is tried
+						unless given, up to the limit of -x
+	-s, --threshold		share of the way from random letters to English a plaintext must score to be reported when
+						auditing (0.5 unless given)
+
+Each result is written as its rank, score, keyNum, key phrase and row combination on one line, followed by the plaintext.
+The number of candidate keys scored and the rate they were scored at are written to standard error. Exit status is 0 on
+success, 1 if the ciphertext or a phrase is rejected and 2 on bad usage. Lines of the wordlist are normalized like the
+key phrases of -w, but a line with a character other than letters and whitespace is skipped and counted instead of
+stopping the audit, since wordlists often hold such entries.
+*/
+#include "Cryptanalyzer.h"
+#include "LanguageModel.h"
+#include "Normalizer.h"
+#include<fstream>
+#include<iostream>
+#include<sstream>
+#include<string>
+#include<vector>
+
+const int EXIT_CIPHER_ERROR = 1;	//exit status when the ciphertext or a phrase is rejected
+const int EXIT_USAGE_ERROR = 2;	//exit status when the command line is wrong
+
+//everything given on the command line
+struct Options
+{
+	CrackSettings settings;	//limits of the search
+	size_t threads = 0;	//worker threads, 0 for one per hardware thread
+	std::string inputPath = "-";	//file to read, "-" for standard input
+	std::string corpusPath;	//file to train the language model on, empty for the built in sample
+	std::string phrasePath;	//file of candidate key phrases, empty to solve the key letters
+	std::string dictionaryPath;	//wordlist to audit against, empty to search for the key
+	std::string auditFlag;	//last flag given that only applies to an audit, empty if none
+	AuditSettings audit;	//what an audit tries and reports
+	PhraseList dictionary;	//phrases of the wordlist
+	size_t skippedLines = 0;	//lines of the wordlist holding a character other than letters and whitespace
+};
+
+/*
+Purpose:		Prints how to use the tool.
+Pre-condition:	Takes the stream to print to.
+Post-condition:	Usage is printed.
+*/
+static void printUsage(std::ostream& output)
+{
+	output << "Usage: crack [-i input] [-t corpus] [-w phraseFile] [-l maxPeriod] [-c count] [-j threads] [-x limit]\n";
+	output << "             [-a restarts]\n";
+	output << "       crack -d wordlist [-n keyNum] [-r rowCombination] [-s threshold] [-i input] [-t corpus] [-c count]\n";
+	output << "             [-j threads] [-x limit]\n";
+}
+
+/*
+Purpose:		Reads a whole file.
+Pre-condition:	Takes the path, "-" for standard input, and the string the contents are stored in.
+Post-condition:	Returns true if the file was read. False otherwise, after printing why.
+*/
+static bool readFile(const std::string& path, std::string& contents)
+{
+	std::ifstream file;
+	if (path != "-")
+	{
+		file.open(path, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "Error: could not open " << path << "\n";
+			return false;
+		}
+	}
+
+	std::istream& input = (path != "-") ? (std::istream&)file : std::cin;
+	std::ostringstream buffer;
+	buffer << input.rdbuf();
+	contents = buffer.str();
+
+	return !input.bad();
+}
+
+/*
+Purpose:		Reads the candidate key phrases, one per line, removing spaces and making letters lower case.
+Pre-condition:	Takes the path of the file and the vector the phrases are stored in.
+Post-condition:	Returns true if every line was a phrase or blank. False otherwise, after printing why.
+*/
+static bool loadPhrases(const std::string& path, std::vector<std::string>& phrases)
+{
+	std::string contents;
+	if (!readFile(path, contents))
+	{
+		return false;
+	}
+
+	std::istringstream lines(contents);
+	size_t number = 0;
+
+	for (std::string line; std::getline(lines, line);)
+	{
+		number++;
+
+		std::string phrase;
+		size_t invalidOffset = 0;
+		if (Normalizer::normalize(line, phrase, Normalizer::Whitespace::ALL, invalidOffset) != CipherStatus::OK)
+		{
+			std::cerr << "Error: invalid character '" << line[invalidOffset] << "' on line " << number << " of " << path << "\n";
+			return false;
+		}
+
+		if (!phrase.empty())
+		{
+			phrases.push_back(phrase);
+		}
+	}
+
+	if (phrases.empty())
+	{
+		std::cerr << "Error: " << path << " holds no key phrases\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Reads the wordlist of an audit, one key phrase per line, removing spaces and making letters lower case.
+Pre-condition:	Takes the path of the file and the options the phrases are stored in.
+Post-condition:	Returns true if the file was read and holds a phrase. False otherwise, after printing why. Lines with a
+				character other than letters and whitespace are counted in skippedLines.
+*/
+static bool loadDictionary(const std::string& path, Options& options)
+{
+	std::string contents;
+	if (!readFile(path, contents))
+	{
+		return false;
+	}
+
+	//a phrase is never longer than its line, so every line is normalized straight into its place in the list
+	PhraseList& phrases = options.dictionary;
+	phrases.letters.resize(contents.length());
+	size_t used = 0;
+
+	for (size_t start = 0; start < contents.length();)
+	{
+		size_t end = contents.find('\n', start);
+		end = (end != std::string::npos) ? end : contents.length();
+
+		size_t invalidOffset = 0;
+		size_t length = Normalizer::normalize(&contents[start], end - start, &phrases.letters[used], Normalizer::Whitespace::ALL,
+			invalidOffset);
+
+		if (invalidOffset != Normalizer::NO_INVALID)
+		{
+			options.skippedLines++;
+		}
+		else if (length > 0)
+		{
+			used += length;
+			phrases.ends.push_back(used);
+		}
+
+		start = end + 1;
+	}
+	phrases.letters.resize(used);
+
+	if (phrases.ends.empty())
+	{
+		std::cerr << "Error: " << path << " holds no key phrases\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Reads a positive whole number given as the value of a flag.
+Pre-condition:	Takes the flag, its value and where to store the number.
+Post-condition:	Returns true if the value is a positive integer. False otherwise, after printing why.
+*/
+static bool parseCount(const std::string& flag, const std::string& value, size_t& count)
+{
+	std::istringstream number(value);
+	if (!(number >> count) || !number.eof() || count == 0 || value[0] == '-')
+	{
+		std::cerr << "Error: " << flag << " must be a positive integer\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Reads the command line into the options.
+Pre-condition:	Takes the arguments of main and the options to fill.
+Post-condition:	Returns true if the command line is usable. False otherwise, after printing why.
+*/
+static bool parseArguments(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+
+		//every flag takes a value
+		const char* const valueFlags[] = { "-i", "--input", "-t", "--train", "-w", "--words", "-l", "--max-period", "-c",
+			"--count", "-j", "--threads", "-x", "--exhaustive", "-a", "--restarts", "-d", "--dictionary", "-n", "--key-num",
+			"-r", "--rows", "-s", "--threshold" };
+		bool known = false;
+		for (const char* valueFlag : valueFlags)
+		{
+			known = known || (flag == valueFlag);
+		}
+
+		if (!known)
+		{
+			std::cerr << "Error: unknown option " << flag << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Error: " << flag << " needs a value\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+		bool parsed = true;
+
+		if (flag == "-i" || flag == "--input")
+		{
+			options.inputPath = value;
+		}
+		else if (flag == "-t" || flag == "--train")
+		{
+			options.corpusPath = value;
+		}
+		else if (flag == "-w" || flag == "--words")
+		{
+			options.phrasePath = value;
+		}
+		else if (flag == "-l" || flag == "--max-period")
+		{
+			parsed = parseCount(flag, value, options.settings.maxPeriod);
+		}
+		else if (flag == "-c" || flag == "--count")
+		{
+			parsed = parseCount(flag, value, options.settings.resultCount);
+		}
+		else if (flag == "-j" || flag == "--threads")
+		{
+			parsed = parseCount(flag, value, options.threads);
+		}
+		else if (flag == "-x" || flag == "--exhaustive")
+		{
+			parsed = parseCount(flag, value, options.settings.exhaustiveLimit);
+			options.audit.exhaustiveLimit = options.settings.exhaustiveLimit;
+		}
+		else if (flag == "-a" || flag == "--restarts")
+		{
+			parsed = parseCount(flag, value, options.settings.restarts);
+		}
+		else if (flag == "-d" || flag == "--dictionary")
+		{
+			options.dictionaryPath = value;
+		}
+		else if (flag == "-n" || flag == "--key-num")
+		{
+			size_t keyNum = 0;
+			parsed = parseCount(flag, value, keyNum);
+			options.audit.keyNum = (keyNum < 26) ? (int)keyNum : -1;
+			options.auditFlag = flag;
+		}
+		else if (flag == "-r" || flag == "--rows")
+		{
+			parsed = KeySchedule::parsePermutation(value, options.audit.permutation) &&
+				!options.audit.permutation.empty();
+			if (!parsed)
+			{
+				std::cerr << "Error: " << flag << " must be a list of row numbers\n";
+			}
+			options.auditFlag = flag;
+		}
+		else
+		{
+			std::istringstream number(value);
+			parsed = (number >> options.audit.threshold) && number.eof();
+			if (!parsed)
+			{
+				std::cerr << "Error: " << flag << " must be a number\n";
+			}
+			options.auditFlag = flag;
+		}
+
+		if (!parsed)
+		{
+			return false;
+		}
+	}
+
+	if (options.dictionaryPath.empty() && !options.auditFlag.empty())
+	{
+		std::cerr << "Error: " << options.auditFlag << " only applies to an audit with -d\n";
+		return false;
+	}
+
+	if (!options.dictionaryPath.empty() && !options.phrasePath.empty())
+	{
+		std::cerr << "Error: -w and -d cannot be used together\n";
+		return false;
+	}
+
+	if (!options.dictionaryPath.empty())
+	{
+		return loadDictionary(options.dictionaryPath, options);
+	}
+
+	return options.phrasePath.empty() || loadPhrases(options.phrasePath, options.settings.keyPhrases);
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseArguments(argc, argv, options))
+	{
+		printUsage(std::cerr);
+		return EXIT_USAGE_ERROR;
+	}
+
+	LanguageModel model;
+	if (!options.corpusPath.empty())
+	{
+		std::string corpus;
+		if (!readFile(options.corpusPath, corpus))
+		{
+			return EXIT_USAGE_ERROR;
+		}
+
+		CipherStatus status = model.train(corpus);
+		if (status != CipherStatus::OK)
+		{
+			std::cerr << "Error: could not train on " << options.corpusPath << ": " << CipherEngine::describeStatus(status) << "\n";
+			return EXIT_USAGE_ERROR;
+		}
+	}
+
+	std::string input;
+	if (!readFile(options.inputPath, input))
+	{
+		return EXIT_USAGE_ERROR;
+	}
+
+	//the ciphertext may be wrapped or end in a new line like the output of the command line tool
+	std::string ciphertext;
+	size_t invalidOffset = 0;
+	CipherStatus status = Normalizer::normalize(input, ciphertext, Normalizer::Whitespace::ALL, invalidOffset);
+
+	Cryptanalyzer analyzer(model, options.threads);
+	std::vector<CrackResult> results;
+
+	if (status == CipherStatus::OK && !options.dictionaryPath.empty())
+	{
+		options.audit.resultCount = options.settings.resultCount;
+		status = analyzer.audit(ciphertext, options.dictionary, options.audit, results);
+	}
+	else if (status == CipherStatus::OK)
+	{
+		status = analyzer.crack(ciphertext, options.settings, results);
+	}
+
+	if (status == CipherStatus::INVALID_PERMUTATION && options.audit.permutation.empty())
+	{
+		std::cerr << "Error: the rows have more orders than the limit of -x, give the row combination with -r\n";
+		return EXIT_CIPHER_ERROR;
+	}
+
+	if (status != CipherStatus::OK)
+	{
+		std::cerr << "Error: " << CipherEngine::describeStatus(status) << "\n";
+		return EXIT_CIPHER_ERROR;
+	}
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const CipherKey& key = results[i].key;
+		std::cout << "#" << i + 1 << " score " << results[i].score << " keyNum " << key.keyNum << " keyPhrase " << key.keyPhrase;
+		std::cout << " rows ";
+
+		for (size_t r = 0; r < key.permutation.size(); r++)
+		{
+			std::cout << ((r > 0) ? "," : "") << key.permutation[r];
+		}
+
+		std::cout << "\n" << results[i].plaintext << "\n";
+	}
+
+	double seconds = analyzer.getSeconds();
+	std::cerr << "Scored " << analyzer.getCandidates() << " candidate keys in " << seconds << " s on ";
+	std::cerr << analyzer.getThreadCount() << " threads (" << ((seconds > 0) ? analyzer.getCandidates() / seconds : 0);
+	std::cerr << " candidates/s)\n";
+
+	if (!options.dictionaryPath.empty())
+	{
+		std::cerr << analyzer.getMatches() << " candidate keys reached the threshold, " << options.dictionary.ends.size();
+		std::cerr << " phrases read and " << options.skippedLines << " lines skipped\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,761 @@
+/*
+Author:			My Tran
+Filename:		fuzz.cpp
+Description:	This file is a differential fuzzing program that checks every fast path of the cipher against the original
+matrix based cipher kept in ReferenceCipher. Each case is a random message and key, made from the seed and the number of
+the case alone, so any failure can be run again on its own with --first and --cases 1. A case is checked stage by stage
+and as a whole message:
+
+	1. Substitution::apply and invert against affine() and invertAffine().
+	2. Transposition::transpose against fillMatrix() and reOrderMatrix() read column by column, and untranspose against
+	   reconstructMatrix() read row by row, which covers the missingElements, occupiedRows and fullColumns arithmetic of
+	   a partial bottom row.
+	3. Whole messages through CipherEngine with a CipherKey, a KeySchedule and an explicit square row width, through
+	   CipherContext, and through encryptRows and decryptRows split at random rows the way ParallelCipher splits them,
+	   against ReferenceCipher::encrypt. Every ciphertext must decrypt back to the plaintext on each of these paths, with
+	   ReferenceCipher::decrypt and with the OnlineDecryptor fed in random pieces.
+	4. For some cases, a round trip with the rows widened by Transposition::calcRowWidth, which the reference cannot do.
+	5. The key as a CipherPipeline of affine, vigenere and rows stages against the reference, then with a columnar
+	   transposition and a second key phrase added over several rounds, compiled against running it stage by stage.
+	6. The key through AlphabetCipher over the lower case letters against the reference, and the message and key
+	   spread over the printable characters and over every byte value against C = (aP + b) mod m worked out one
+	   symbol at a time and moved by Transposition.
+
+Lengths are drawn up to the maximum with extra weight on lengths just around a square or a rectangle of the matrix, where
+the bottom row is full, empty or one letter long, and key phrases from one letter to past the length of the message. The
+cases are spread across every core. --exhaustive also checks every length from 1 up to a bound with one key each.
+
+Usage:	fuzz [--seed number] [--cases count] [--first number] [--max-length letters] [--exhaustive letters]
+			 [--threads count]
+
+	--seed			seed every case is made from, 1 unless given
+	--cases			number of random cases, 100000 unless given
+	--first			number of the first random case, 0 unless given
+	--max-length	longest random message, 10000 unless given
+	--exhaustive	also check every length from 1 up to this one, none unless given
+	--threads		number of worker threads, one per hardware thread unless given
+
+The number of cases and letters checked and the rate they were checked at are written out, followed by up to 20 failed
+cases with the check each one failed. Exit status is 0 if every case passed, 1 if any failed and 2 on bad usage.
+
+Defining ENCRYPTOR_LIBFUZZER builds the same checks as a libFuzzer target instead, taking the keyNum, key phrase, row
+alignment, permutation and plaintext from the bytes of each input and aborting on the first failed check:
+
+	clang++ -std=c++17 -O1 -g -fsanitize=fuzzer,address -DENCRYPTOR_LIBFUZZER fuzz.cpp <class files>
+*/
+#include "AlphabetCipher.h"
+#include "CipherContext.h"
+#include "CipherEngine.h"
+#include "CipherPipeline.h"
+#include "OnlineDecryptor.h"
+#include "ReferenceCipher.h"
+#include "ThreadPool.h"
+#include<algorithm>
+#include<chrono>
+#include<cstdint>
+#include<cstdio>
+#include<cstdlib>
+#include<iostream>
+#include<mutex>
+#include<random>
+#include<sstream>
+#include<string>
+#include<string_view>
+#include<vector>
+
+const int KEY_NUMS[] = { 1, 3, 5, 7, 9, 11, 15, 17, 19, 21, 23, 25 };	//every keyNum the affine cipher accepts
+const size_t KEY_NUM_COUNT = sizeof(KEY_NUMS) / sizeof(KEY_NUMS[0]);	//number of keyNums
+const size_t SHORT_PHRASE_LENGTH = 16;	//longest of the short key phrases most cases use
+const size_t ALIGNMENTS[] = { 2, 3, 7, 16, 64, 100, 4096 };	//row alignments the widened round trips are drawn from
+const size_t MAX_SPLITS = 4;	//most points the rows are split at, as ParallelCipher splits them between workers
+const size_t MAX_PIPELINE_COLUMNS = 9;	//most columns of the columnar transposition of a pipeline
+const size_t MAX_PIPELINE_ROUNDS = 3;	//most rounds of a pipeline
+const size_t MAX_REPORTED = 20;	//most failed cases written out
+const size_t CASE_GRAIN = 16;	//fewest cases handed to a worker at once
+
+//one message and key to check
+struct FuzzCase
+{
+	std::string plaintext;	//lower case message
+	CipherKey key;	//key of the message
+	size_t alignment = 0;	//alignment of the widened round trip, 0 to skip it
+	CipherKey alignedKey;	//the key with a permutation of the rows left by the widened width
+	std::vector<size_t> splits;	//rows of the reordered matrix the message is split at, in order
+	std::vector<size_t> pieces;	//sizes of the pieces the ciphertext is fed to the online decryptor in
+	std::vector<int> columns;	//order the columns of the pipeline's columnar transposition are read in
+	size_t rounds = 1;	//rounds of the pipeline
+};
+
+/*
+Purpose:		Makes a random permutation of the full rows of a matrix.
+Pre-condition:	Takes the message length, the row width, 0 for the least square, and the random generator.
+Post-condition:	Returns the permutation.
+*/
+static std::vector<int> makePermutation(size_t length, size_t rowWidth, std::mt19937& random)
+{
+	std::vector<int> permutation(Transposition::calcOccupiedRows(length, rowWidth) - 1);
+	for (size_t i = 0; i < permutation.size(); i++)
+	{
+		permutation[i] = (int)i;
+	}
+	std::shuffle(permutation.begin(), permutation.end(), random);
+
+	return permutation;
+}
+
+/*
+Purpose:		Fills in the parts of a case drawn from the random generator once the message and key phrase are known.
+Pre-condition:	Takes the case, with its plaintext, keyNum and key phrase set, the alignment, 0 for none, and the random
+				generator.
+Post-condition:	The permutations, split rows and online pieces of the case are set.
+*/
+static void completeCase(FuzzCase& fuzzCase, size_t alignment, std::mt19937& random)
+{
+	size_t length = fuzzCase.plaintext.length();
+	fuzzCase.key.permutation = makePermutation(length, 0, random);
+
+	fuzzCase.alignment = alignment;
+	fuzzCase.alignedKey = fuzzCase.key;
+	if (alignment > 0)
+	{
+		fuzzCase.alignedKey.permutation = makePermutation(length, Transposition::calcRowWidth(length, alignment), random);
+	}
+
+	size_t rows = fuzzCase.key.permutation.size() + 1;
+	for (size_t i = random() % (MAX_SPLITS + 1); i > 0; i--)
+	{
+		fuzzCase.splits.push_back(random() % (rows + 1));
+	}
+	std::sort(fuzzCase.splits.begin(), fuzzCase.splits.end());
+
+	for (size_t fed = 0; fed < length;)
+	{
+		//most pieces are a few letters, the others anything up to the whole message
+		size_t longest = (random() % 2 == 0) ? 8 : length;
+		size_t piece = 1 + random() % longest;
+		piece = (piece < length - fed) ? piece : length - fed;
+		fuzzCase.pieces.push_back(piece);
+		fed += piece;
+	}
+
+	fuzzCase.columns.resize(1 + random() % MAX_PIPELINE_COLUMNS);
+	for (size_t i = 0; i < fuzzCase.columns.size(); i++)
+	{
+		fuzzCase.columns[i] = (int)i;
+	}
+	std::shuffle(fuzzCase.columns.begin(), fuzzCase.columns.end(), random);
+	fuzzCase.rounds = 1 + random() % MAX_PIPELINE_ROUNDS;
+}
+
+/*
+Purpose:		Reads a reordered matrix of the reference column by column the way ReferenceCipher::encrypt does.
+Pre-condition:	Takes the matrix and the message length.
+Post-condition:	Returns the transposed text.
+*/
+static std::string readColumns(const std::vector<std::vector<char>>& matrix, size_t length)
+{
+	std::string text(length, ' ');
+
+	for (size_t c = 0, a = 0; c < matrix[0].size(); c++)
+	{
+		for (size_t r = 0; r < matrix.size() && a < length && matrix[r][c] != '\0'; r++, a++)
+		{
+			text[a] = matrix[r][c];
+		}
+	}
+
+	return text;
+}
+
+/*
+Purpose:		Reads a matrix of the reference row by row the way ReferenceCipher::decrypt does.
+Pre-condition:	Takes the matrix.
+Post-condition:	Returns the text of the rows one after another.
+*/
+static std::string readRows(const std::vector<std::vector<char>>& matrix)
+{
+	std::string text;
+
+	for (const std::vector<char>& row : matrix)
+	{
+		for (char letter : row)
+		{
+			if (letter != '\0')
+			{
+				text += letter;
+			}
+		}
+	}
+
+	return text;
+}
+
+/*
+Purpose:		Checks AlphabetCipher over an alphabet other than the lower case letters, with the message and key phrase
+				of a case spread over its symbols.
+Pre-condition:	Takes the case.
+Post-condition:	Returns true if the cipher matches the substitution worked out one symbol at a time followed by the
+				transposition, and decrypts back to the message.
+*/
+template<typename Alphabet>
+static bool checkAlphabet(const FuzzCase& fuzzCase)
+{
+	typedef AlphabetCipher<Alphabet> Cipher;
+	const std::string& letters = fuzzCase.plaintext;
+	size_t length = letters.length();
+
+	//the first keyNum from the case's one up that has an inverse mod the size of the alphabet
+	CipherKey key = fuzzCase.key;
+	while (!Cipher::isValidKeyNum(key.keyNum))
+	{
+		key.keyNum = key.keyNum % (Cipher::SIZE - 1) + 1;
+	}
+
+	for (size_t i = 0; i < key.keyPhrase.length(); i++)
+	{
+		key.keyPhrase[i] = (char)(Cipher::FIRST + (key.keyPhrase[i] * 7 + i) % Cipher::SIZE);
+	}
+
+	std::string plaintext(length, ' ');
+	for (size_t i = 0; i < length; i++)
+	{
+		plaintext[i] = (char)(Cipher::FIRST + (letters[i] * 31 + i * 13) % Cipher::SIZE);
+	}
+
+	std::string substituted(length, ' ');
+	size_t period = key.keyPhrase.length();
+	for (size_t i = 0; i < length; i++)
+	{
+		int p = (unsigned char)plaintext[i] - Cipher::FIRST;
+		int b = (unsigned char)key.keyPhrase[i % period] - Cipher::FIRST;
+		substituted[i] = (char)(Cipher::FIRST + (key.keyNum * p + b) % Cipher::SIZE);
+	}
+
+	std::string expected(length, ' ');
+	Transposition transposition(length, key.permutation);
+	transposition.transpose(substituted.data(), &expected[0]);
+
+	Cipher cipher(key);
+	std::string output(length, ' ');
+	if (cipher.encrypt(plaintext, &output[0]) != CipherStatus::OK || output != expected)
+	{
+		return false;
+	}
+
+	return cipher.decrypt(expected, &output[0]) == CipherStatus::OK && output == plaintext;
+}
+
+/*
+Purpose:		Checks every path of the cipher on one case against the reference and by round trips.
+Pre-condition:	Takes the case and a context to encrypt and decrypt in.
+Post-condition:	Returns the name of the first check that failed, or nullptr if every check passed.
+*/
+static const char* checkCase(const FuzzCase& fuzzCase, CipherContext& context)
+{
+	const std::string& plaintext = fuzzCase.plaintext;
+	const CipherKey& key = fuzzCase.key;
+	size_t length = plaintext.length();
+
+	KeySchedule schedule(key);
+	if (schedule.getStatus() != CipherStatus::OK || schedule.validateLength(length) != CipherStatus::OK)
+	{
+		return "schedule.validate";
+	}
+
+	const Substitution& substitution = schedule.getSubstitution();
+	Transposition transposition(length, key.permutation);
+	ReferenceCipher reference(key);
+
+	//step 1: the substitution in both directions
+	std::string substituted(length, ' ');
+	substitution.apply(plaintext.data(), 0, length, &substituted[0]);
+	reference.plaintext = plaintext;
+	reference.affine();
+	if (reference.ciphertext != substituted)
+	{
+		return "substitution.apply";
+	}
+
+	std::string inverted(length, ' ');
+	substitution.invert(substituted.data(), 0, length, &inverted[0]);
+	reference.invertAffine();
+	if (reference.plaintext != inverted || inverted != plaintext)
+	{
+		return "substitution.invert";
+	}
+
+	//step 2: the transposition in both directions
+	std::string transposed(length, ' ');
+	transposition.transpose(substituted.data(), &transposed[0]);
+	reference.ciphertext = substituted;
+	reference.fillMatrix();
+	reference.reOrderMatrix();
+	if (readColumns(reference.cipherMatrix, length) != transposed)
+	{
+		return "transposition.transpose";
+	}
+	reference.cipherMatrix.clear();
+	reference.transposeMatrix.clear();
+
+	std::string untransposed(length, ' ');
+	transposition.untranspose(transposed.data(), &untransposed[0]);
+	if (untransposed != substituted)
+	{
+		return "transposition.untranspose";
+	}
+
+	//like the original, the reference loses a message with a single row when rebuilding its matrix
+	if (transposition.getOccupiedRows() > 1)
+	{
+		reference.ciphertext = transposed;
+		reference.reconstructMatrix();
+		if (readRows(reference.transposeMatrix) != substituted)
+		{
+			return "transposition.reconstructMatrix";
+		}
+		reference.cipherMatrix.clear();
+		reference.transposeMatrix.clear();
+	}
+
+	//step 3: whole messages through every path
+	std::string expected = reference.encrypt(plaintext);
+	std::string output(length, ' ');
+	std::string_view view;
+
+	if (CipherEngine::encrypt(plaintext, key, &output[0]) != CipherStatus::OK || output != expected)
+	{
+		return "engine.encrypt";
+	}
+
+	if (CipherEngine::encrypt(plaintext, schedule, &output[0]) != CipherStatus::OK || output != expected)
+	{
+		return "schedule.encrypt";
+	}
+
+	size_t square = transposition.getMatrixSize();
+	if (CipherEngine::encrypt(plaintext, schedule, &output[0], square) != CipherStatus::OK || output != expected)
+	{
+		return "schedule.encryptSquareWidth";
+	}
+
+	if (context.encrypt(plaintext, schedule, view) != CipherStatus::OK || view != expected)
+	{
+		return "context.encrypt";
+	}
+
+	//the split points may repeat or fall on either end, leaving pieces of no rows
+	output.assign(length, ' ');
+	for (size_t s = 0, first = 0; s <= fuzzCase.splits.size(); s++)
+	{
+		size_t end = (s < fuzzCase.splits.size()) ? fuzzCase.splits[s] : transposition.getOccupiedRows();
+		CipherEngine::encryptRows(plaintext.data(), 0, substitution, transposition, first, end, &output[0]);
+		first = end;
+	}
+	if (output != expected)
+	{
+		return "rows.encrypt";
+	}
+
+	if (CipherEngine::decrypt(expected, key, &output[0]) != CipherStatus::OK || output != plaintext)
+	{
+		return "engine.decrypt";
+	}
+
+	if (CipherEngine::decrypt(expected, schedule, &output[0]) != CipherStatus::OK || output != plaintext)
+	{
+		return "schedule.decrypt";
+	}
+
+	if (context.decrypt(expected, schedule, view) != CipherStatus::OK || view != plaintext)
+	{
+		return "context.decrypt";
+	}
+
+	output.assign(length, ' ');
+	for (size_t s = 0, first = 0; s <= fuzzCase.splits.size(); s++)
+	{
+		size_t end = (s < fuzzCase.splits.size()) ? fuzzCase.splits[s] : transposition.getOccupiedRows();
+		CipherEngine::decryptRows(expected.data(), 0, substitution, transposition, first, end, &output[0]);
+		first = end;
+	}
+	if (output != plaintext)
+	{
+		return "rows.decrypt";
+	}
+
+	if (transposition.getOccupiedRows() > 1 && reference.decrypt(expected) != plaintext)
+	{
+		return "reference.decrypt";
+	}
+
+	OnlineDecryptor online(schedule);
+	std::string streamed;
+	if (online.begin(length) != CipherStatus::OK)
+	{
+		return "online.begin";
+	}
+	for (size_t p = 0, fed = 0; p < fuzzCase.pieces.size(); fed += fuzzCase.pieces[p], p++)
+	{
+		if (online.feed(std::string_view(expected).substr(fed, fuzzCase.pieces[p]), view) != CipherStatus::OK)
+		{
+			return "online.feed";
+		}
+		streamed += view;
+	}
+	if (streamed != plaintext || !online.isComplete())
+	{
+		return "online.decrypt";
+	}
+
+	//step 4: a widened row, which only round trips since the reference knows nothing but the square
+	if (fuzzCase.alignment > 0)
+	{
+		size_t width = Transposition::calcRowWidth(length, fuzzCase.alignment);
+		KeySchedule aligned(fuzzCase.alignedKey);
+		std::string ciphertext(length, ' ');
+
+		if (CipherEngine::encrypt(plaintext, aligned, &ciphertext[0], width) != CipherStatus::OK)
+		{
+			return "aligned.encrypt";
+		}
+
+		if (CipherEngine::decrypt(ciphertext, aligned, &output[0], width) != CipherStatus::OK || output != plaintext)
+		{
+			return "aligned.decrypt";
+		}
+	}
+
+	//step 5: the key as pipeline stages, which one round folds into the cipher of the engine
+	CipherPipeline pipeline;
+	pipeline.addSubstitution(key.keyNum, "a");
+	pipeline.addSubstitution(1, key.keyPhrase);
+	pipeline.addRows(key.permutation);
+
+	if (pipeline.compile(length) != CipherStatus::OK || pipeline.encrypt(plaintext, &output[0]) != CipherStatus::OK ||
+		output != expected)
+	{
+		return "pipeline.encrypt";
+	}
+
+	if (pipeline.decrypt(expected, &output[0]) != CipherStatus::OK || output != plaintext)
+	{
+		return "pipeline.decrypt";
+	}
+
+	//more stages and rounds move the letters through a table of positions instead
+	std::string reversed(key.keyPhrase.rbegin(), key.keyPhrase.rend());
+	pipeline.addColumns(fuzzCase.columns);
+	pipeline.addSubstitution(key.keyNum, reversed);
+	pipeline.setRounds(fuzzCase.rounds);
+
+	std::string staged(length, ' ');
+	if (pipeline.compile(length) != CipherStatus::OK || pipeline.encrypt(plaintext, &output[0]) != CipherStatus::OK ||
+		pipeline.encryptByStage(plaintext, &staged[0]) != CipherStatus::OK || output != staged)
+	{
+		return "pipeline.encryptRounds";
+	}
+
+	if (pipeline.decrypt(staged, &output[0]) != CipherStatus::OK || output != plaintext ||
+		pipeline.decryptByStage(staged, &output[0]) != CipherStatus::OK || output != plaintext)
+	{
+		return "pipeline.decryptRounds";
+	}
+
+	//step 6: the same cipher over other alphabets, which the lower case letters must agree with the reference on
+	AlphabetCipher<LowerCaseAlphabet> letterCipher(key);
+	if (letterCipher.encrypt(plaintext, &output[0]) != CipherStatus::OK || output != expected)
+	{
+		return "alphabet.letters";
+	}
+
+	if (!checkAlphabet<PrintableAlphabet>(fuzzCase))
+	{
+		return "alphabet.printable";
+	}
+
+	if (!checkAlphabet<ByteAlphabet>(fuzzCase))
+	{
+		return "alphabet.bytes";
+	}
+
+	return nullptr;
+}
+
+#ifdef ENCRYPTOR_LIBFUZZER
+/*
+Purpose:		Checks the case made from one input of libFuzzer. The first byte picks the keyNum, the second gives the
+				key phrase length less one, the third the row alignment, 0 for none, and the next two seed the
+				permutations. The key phrase is taken from the bytes after them and the plaintext from the rest, each
+				byte made a letter.
+Pre-condition:	Takes the bytes and their number.
+Post-condition:	Returns 0. Aborts if a check fails.
+*/
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	const size_t HEADER_SIZE = 5;
+	if (size <= HEADER_SIZE + 1)
+	{
+		return 0;
+	}
+
+	FuzzCase fuzzCase;
+	size_t phraseLength = (size_t)data[1] + 1;
+	phraseLength = (phraseLength < size - HEADER_SIZE) ? phraseLength : size - HEADER_SIZE - 1;
+
+	fuzzCase.key.keyNum = KEY_NUMS[data[0] % KEY_NUM_COUNT];
+	for (size_t i = HEADER_SIZE; i < size; i++)
+	{
+		std::string& text = (i < HEADER_SIZE + phraseLength) ? fuzzCase.key.keyPhrase : fuzzCase.plaintext;
+		text += (char)('a' + data[i] % 26);
+	}
+
+	std::mt19937 random((unsigned)data[3] | ((unsigned)data[4] << 8));
+	completeCase(fuzzCase, data[2], random);
+
+	CipherContext context;
+	const char* failed = checkCase(fuzzCase, context);
+	if (failed != nullptr)
+	{
+		std::fprintf(stderr, "Failed %s on %zu letters, keyNum %d, key phrase of %zu letters\n", failed,
+			fuzzCase.plaintext.length(), fuzzCase.key.keyNum, fuzzCase.key.keyPhrase.length());
+		std::abort();
+	}
+
+	return 0;
+}
+#else
+//a case that failed a check
+struct FuzzFailure
+{
+	unsigned kind = 0;	//0 for a random case, 1 for a case of the exhaustive lengths
+	uint64_t number = 0;	//number of the case, or its length for the exhaustive lengths
+	size_t length = 0;	//letters in the message
+	int keyNum = 0;	//keyNum of the key
+	size_t phraseLength = 0;	//letters in the key phrase
+	const char* check = nullptr;	//name of the check that failed
+};
+
+/*
+Purpose:		Makes a random string of lower case letters.
+Pre-condition:	Takes the length and the random generator.
+Post-condition:	Returns the letters.
+*/
+static std::string makeLetters(size_t length, std::mt19937& random)
+{
+	std::string letters(length, 'a');
+	for (char& letter : letters)
+	{
+		letter = (char)('a' + random() % 26);
+	}
+
+	return letters;
+}
+
+/*
+Purpose:		Makes the case of a number, the same on every run and every thread.
+Pre-condition:	Takes the seed, the kind of case, the number of the case, the longest random message, and the case to fill.
+				A case of the exhaustive lengths takes its length as its number.
+Post-condition:	The case is filled.
+*/
+static void makeCase(unsigned seed, unsigned kind, uint64_t number, size_t maxLength, FuzzCase& fuzzCase)
+{
+	std::seed_seq sequence = { seed, kind, (unsigned)number, (unsigned)(number >> 32) };
+	std::mt19937 random(sequence);
+
+	size_t length = (size_t)number;
+	if (kind == 0)
+	{
+		//lengths around k * k and k * (k - 1) leave the bottom row full, empty or one letter long
+		size_t choice = random() % 10;
+		size_t side = 1 + random() % (size_t)Transposition::calcMatrixSize(maxLength);
+		size_t around = (choice < 2) ? side * side : side * (side - 1);
+		around += random() % 3;
+		around -= (around > 1) ? 1 : 0;
+
+		length = (choice < 4) ? around : (choice < 5) ? 1 + random() % 16 : 1 + random() % maxLength;
+		length = (length > 0) ? length : 1;
+		length = (length <= maxLength) ? length : maxLength;
+	}
+
+	//most key phrases are short, some cross the length the key stream is expanded to and some outrun the message
+	size_t choice = random() % 20;
+	size_t phraseLength = 1 + random() % SHORT_PHRASE_LENGTH;
+	if (choice >= 17)
+	{
+		phraseLength = 1 + random() % (length + SHORT_PHRASE_LENGTH);
+	}
+	else if (choice >= 10)
+	{
+		phraseLength = Substitution::MAX_EXPANDED_PHRASE - SHORT_PHRASE_LENGTH + random() % (2 * SHORT_PHRASE_LENGTH);
+	}
+
+	fuzzCase.plaintext = makeLetters(length, random);
+	fuzzCase.key.keyNum = KEY_NUMS[random() % KEY_NUM_COUNT];
+	fuzzCase.key.keyPhrase = makeLetters(phraseLength, random);
+
+	size_t alignment = (random() % 4 == 0) ? ALIGNMENTS[random() % (sizeof(ALIGNMENTS) / sizeof(ALIGNMENTS[0]))] : 0;
+	completeCase(fuzzCase, alignment, random);
+}
+
+//everything given on the command line
+struct Options
+{
+	unsigned seed = 1;	//seed every case is made from
+	size_t cases = 100000;	//random cases to check
+	uint64_t first = 0;	//number of the first random case
+	size_t maxLength = 10000;	//longest random message
+	size_t exhaustive = 0;	//every length up to this one is checked too
+	size_t threads = 0;	//worker threads, 0 for one per hardware thread
+};
+
+/*
+Purpose:		Reads the command line into the options.
+Pre-condition:	Takes the arguments of main and the options to fill.
+Post-condition:	Returns true if the command line is usable. False otherwise, after printing why.
+*/
+static bool parseArguments(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+
+		if (flag != "--seed" && flag != "--cases" && flag != "--first" && flag != "--max-length" && flag != "--exhaustive"
+			&& flag != "--threads")
+		{
+			std::cerr << "Error: unknown option " << flag << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Error: " << flag << " needs a value\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+		std::istringstream number(value);
+		uint64_t parsed = 0;
+
+		if (!(number >> parsed) || !number.eof() || value[0] == '-')
+		{
+			std::cerr << "Error: " << flag << " must be a whole number\n";
+			return false;
+		}
+
+		if (flag == "--seed")
+		{
+			options.seed = (unsigned)parsed;
+		}
+		else if (flag == "--cases")
+		{
+			options.cases = (size_t)parsed;
+		}
+		else if (flag == "--first")
+		{
+			options.first = parsed;
+		}
+		else if (flag == "--max-length")
+		{
+			options.maxLength = (size_t)parsed;
+		}
+		else if (flag == "--exhaustive")
+		{
+			options.exhaustive = (size_t)parsed;
+		}
+		else
+		{
+			options.threads = (size_t)parsed;
+		}
+	}
+
+	if (options.maxLength == 0)
+	{
+		std::cerr << "Error: --max-length must be at least 1\n";
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseArguments(argc, argv, options))
+	{
+		std::cerr << "Usage: fuzz [--seed number] [--cases count] [--first number] [--max-length letters] [--exhaustive letters]\n";
+		std::cerr << "            [--threads count]\n";
+		return 2;
+	}
+
+	auto started = std::chrono::steady_clock::now();
+	ThreadPool pool(options.threads);
+	std::vector<FuzzFailure> failures;
+	std::mutex failureLock;
+	size_t failureCount = 0;
+	size_t letters = 0;
+
+	//the exhaustive lengths come first, then the random cases, each made and checked by whichever worker takes it
+	size_t total = options.exhaustive + options.cases;
+	pool.parallelFor(total, CASE_GRAIN, [&](size_t begin, size_t end)
+	{
+		CipherContext context;
+		FuzzCase fuzzCase;
+		size_t checked = 0;
+
+		for (size_t i = begin; i < end; i++)
+		{
+			bool exhaustive = (i < options.exhaustive);
+			FuzzFailure failure;
+			failure.kind = exhaustive ? 1 : 0;
+			failure.number = exhaustive ? i + 1 : options.first + (i - options.exhaustive);
+
+			fuzzCase = FuzzCase();
+			makeCase(options.seed, failure.kind, failure.number, options.maxLength, fuzzCase);
+			failure.check = checkCase(fuzzCase, context);
+			checked += fuzzCase.plaintext.length();
+
+			if (failure.check != nullptr)
+			{
+				failure.length = fuzzCase.plaintext.length();
+				failure.keyNum = fuzzCase.key.keyNum;
+				failure.phraseLength = fuzzCase.key.keyPhrase.length();
+
+				std::lock_guard<std::mutex> guard(failureLock);
+				failureCount++;
+				failures.push_back(failure);
+			}
+		}
+
+		std::lock_guard<std::mutex> guard(failureLock);
+		letters += checked;
+	});
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	std::cout << "Checked " << total << " cases of " << letters << " letters in " << seconds << " s on ";
+	std::cout << pool.getThreadCount() << " threads (" << ((seconds > 0) ? total / seconds : 0) << " cases/s)\n";
+
+	//the workers finish in any order, so the failures are written in the order of the cases
+	std::sort(failures.begin(), failures.end(), [](const FuzzFailure& a, const FuzzFailure& b)
+	{
+		return (a.kind != b.kind) ? a.kind > b.kind : a.number < b.number;
+	});
+
+	for (size_t f = 0; f < failures.size() && f < MAX_REPORTED; f++)
+	{
+		const FuzzFailure& failure = failures[f];
+		std::cout << (failure.kind == 1 ? "Length " : "Case ") << failure.number << " failed " << failure.check << " (";
+		std::cout << failure.length << " letters, keyNum " << failure.keyNum << ", key phrase of " << failure.phraseLength;
+		std::cout << " letters)\n";
+	}
+
+	if (failureCount > 0)
+	{
+		std::cout << failureCount << " cases failed\n";
+		return 1;
+	}
+
+	std::cout << "Every case passed\n";
+	return 0;
+}
+#endif
@@ -0,0 +1,556 @@
+/*
+Author:			My Tran
+Filename:		loadgen.cpp
+Description:	This file is a command line tool that measures a service started by server.cpp. It opens several
+connections, keeps a number of requests in flight on each one, and once every request is answered writes the throughput
+and the latency of the requests at the 50th and 99th percentiles, the figures used to size a deployment of the service.
+Latency runs from when a request is queued to be sent to when its reply has been read. Like the service it only runs on
+Linux.
+
+Usage:	loadgen (-s socketPath | -p port) [-u keyId] [-d] [-n requests] [-l length] [-c connections] [-w window]
+		[-j threads]
+
+	-s, --socket		path of the Unix domain socket of the service
+	-p, --port			TCP port of the service on the loopback address
+	-u, --key-id		number of the key every request names (1 unless given)
+	-d, --decrypt		send decrypt requests instead of encrypt requests
+	-n, --requests		number of requests sent in all (100000 unless given)
+	-l, --length		letters in each request (64 unless given)
+	-c, --connections	number of connections opened (4 unless given)
+	-w, --window		requests in flight on each connection at once (16 unless given)
+	-j, --threads		number of threads the connections are shared between (1 unless given)
+
+The text of the requests is random letters. Exit status is 0 if every request was answered with OK, 1 if the service
+could not be reached or any request failed and 2 on bad usage.
+*/
+#include "CipherEngine.h"
+#include "CipherServer.h"
+#include<algorithm>
+#include<cerrno>
+#include<chrono>
+#include<cstring>
+#include<deque>
+#include<iostream>
+#include<random>
+#include<sstream>
+#include<string>
+#include<thread>
+#include<vector>
+#include<fcntl.h>
+#include<netinet/in.h>
+#include<netinet/tcp.h>
+#include<poll.h>
+#include<sys/socket.h>
+#include<sys/un.h>
+#include<unistd.h>
+
+const int EXIT_SERVICE_ERROR = 1;	//exit status when the service could not be reached or a request failed
+const int EXIT_USAGE_ERROR = 2;	//exit status when the command line is wrong
+const size_t MESSAGE_COUNT = 64;	//different texts the requests take turns sending
+const size_t READ_SIZE = 1 << 16;	//bytes read from a socket at once
+const unsigned int TEXT_SEED = 1;	//seed of the random texts, so every run sends the same ones
+
+typedef std::chrono::steady_clock Clock;
+
+//everything given on the command line
+struct Options
+{
+	std::string socketPath;	//Unix domain socket of the service, empty for TCP
+	size_t port = 0;	//TCP port of the service, 0 for a Unix domain socket
+	size_t keyId = 1;	//key every request names
+	ServiceOperation operation = ServiceOperation::ENCRYPT;	//what every request asks for
+	size_t requests = 100000;	//requests sent in all
+	size_t length = 64;	//letters in each request
+	size_t connections = 4;	//connections opened
+	size_t window = 16;	//requests in flight on each connection
+	size_t threads = 1;	//threads the connections are shared between
+};
+
+//a connection and the requests on it
+struct Client
+{
+	int socket = -1;	//socket connected to the service
+	size_t remaining = 0;	//requests not sent yet
+	uint32_t nextTag = 0;	//tag of the next request
+	uint32_t expectedTag = 0;	//tag the next reply should carry
+	std::deque<Clock::time_point> sentTimes;	//when each request in flight was queued, oldest first
+	std::string input;	//bytes received that do not make a whole reply yet
+	std::string output;	//requests waiting to be written
+	bool done = false;	//true once every request is answered or the connection failed
+};
+
+//what one thread measured
+struct Measurement
+{
+	std::vector<double> latencies;	//microseconds each answered request took
+	size_t errors = 0;	//requests that failed or were never answered
+};
+
+/*
+Purpose:		Prints how to use the tool.
+Pre-condition:	Takes the stream to print to.
+Post-condition:	Usage is printed.
+*/
+static void printUsage(std::ostream& output)
+{
+	output << "Usage: loadgen (-s socketPath | -p port) [-u keyId] [-d] [-n requests] [-l length] [-c connections]\n";
+	output << "               [-w window] [-j threads]\n";
+}
+
+/*
+Purpose:		Reads a positive whole number given as the value of a flag.
+Pre-condition:	Takes the flag, its value and where to store the number.
+Post-condition:	Returns true if the value is a positive integer. False otherwise, after printing why.
+*/
+static bool parseCount(const std::string& flag, const std::string& value, size_t& count)
+{
+	std::istringstream number(value);
+	if (!(number >> count) || !number.eof() || count == 0 || value[0] == '-')
+	{
+		std::cerr << "Error: " << flag << " must be a positive integer\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Reads the command line into the options.
+Pre-condition:	Takes the arguments of main and the options to fill.
+Post-condition:	Returns true if the command line is usable. False otherwise, after printing why.
+*/
+static bool parseArguments(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+
+		if (flag == "-d" || flag == "--decrypt")
+		{
+			options.operation = ServiceOperation::DECRYPT;
+			continue;
+		}
+
+		//every other flag takes a value
+		const char* const valueFlags[] = { "-s", "--socket", "-p", "--port", "-u", "--key-id", "-n", "--requests", "-l",
+			"--length", "-c", "--connections", "-w", "--window", "-j", "--threads" };
+		bool known = false;
+		for (const char* valueFlag : valueFlags)
+		{
+			known = known || (flag == valueFlag);
+		}
+
+		if (!known)
+		{
+			std::cerr << "Error: unknown option " << flag << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Error: " << flag << " needs a value\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+		bool parsed = true;
+
+		if (flag == "-s" || flag == "--socket")
+		{
+			options.socketPath = value;
+		}
+		else if (flag == "-p" || flag == "--port")
+		{
+			parsed = parseCount(flag, value, options.port);
+			if (parsed && options.port > 65535)
+			{
+				std::cerr << "Error: " << flag << " must be at most 65535\n";
+				parsed = false;
+			}
+		}
+		else if (flag == "-u" || flag == "--key-id")
+		{
+			parsed = parseCount(flag, value, options.keyId);
+			if (parsed && options.keyId > UINT32_MAX)
+			{
+				std::cerr << "Error: " << flag << " must be at most " << UINT32_MAX << "\n";
+				parsed = false;
+			}
+		}
+		else if (flag == "-n" || flag == "--requests")
+		{
+			parsed = parseCount(flag, value, options.requests);
+		}
+		else if (flag == "-l" || flag == "--length")
+		{
+			parsed = parseCount(flag, value, options.length);
+			if (parsed && options.length > CipherServer::MAX_TEXT_LENGTH)
+			{
+				std::cerr << "Error: " << flag << " must be at most " << CipherServer::MAX_TEXT_LENGTH << "\n";
+				parsed = false;
+			}
+		}
+		else if (flag == "-c" || flag == "--connections")
+		{
+			parsed = parseCount(flag, value, options.connections);
+		}
+		else if (flag == "-w" || flag == "--window")
+		{
+			parsed = parseCount(flag, value, options.window);
+		}
+		else
+		{
+			parsed = parseCount(flag, value, options.threads);
+		}
+
+		if (!parsed)
+		{
+			return false;
+		}
+	}
+
+	if (options.socketPath.empty() == (options.port == 0))
+	{
+		std::cerr << "Error: exactly one of -s and -p must be given\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Connects to the service.
+Pre-condition:	Takes the options.
+Post-condition:	Returns a nonblocking socket connected to the service, or -1 after printing why not.
+*/
+static int connectService(const Options& options)
+{
+	int client = -1;
+	int connected = -1;
+
+	if (options.socketPath.empty())
+	{
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons((uint16_t)options.port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		client = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		connected = (client >= 0) ? connect(client, (const sockaddr*)&address, sizeof(address)) : -1;
+
+		int noDelay = 1;
+		setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+	}
+	else
+	{
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		options.socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+		client = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		connected = (client >= 0) ? connect(client, (const sockaddr*)&address, sizeof(address)) : -1;
+	}
+
+	//the connection is made blocking so a refused one is reported here, and only then made nonblocking for poll
+	if (connected < 0 || fcntl(client, F_SETFL, O_NONBLOCK) < 0)
+	{
+		std::cerr << "Error: could not connect: " << std::strerror(errno) << "\n";
+		if (client >= 0)
+		{
+			close(client);
+		}
+		return -1;
+	}
+
+	return client;
+}
+
+/*
+Purpose:		Reads every reply waiting on a connection and times it.
+Pre-condition:	Takes the connection, the options and the measurement to add to.
+Post-condition:	Returns false if the connection failed, after counting its requests in flight as errors.
+*/
+static bool readReplies(Client& client, const Options& options, Measurement& measurement)
+{
+	char buffer[READ_SIZE];
+
+	while (true)
+	{
+		ssize_t got = recv(client.socket, buffer, sizeof(buffer), 0);
+
+		if (got > 0)
+		{
+			client.input.append(buffer, (size_t)got);
+			if ((size_t)got < sizeof(buffer))
+			{
+				break;
+			}
+		}
+		else if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		else if (got == 0 || errno != EINTR)
+		{
+			measurement.errors += client.sentTimes.size() + client.remaining;
+			return false;
+		}
+	}
+
+	Clock::time_point now = Clock::now();
+	size_t used = 0;
+	ServiceReply reply;
+
+	for (size_t taken; (taken = CipherServer::parseReply(client.input.data() + used, client.input.length() - used, reply)) > 0;)
+	{
+		used += taken;
+
+		if (client.sentTimes.empty())
+		{
+			measurement.errors++;
+			continue;
+		}
+
+		measurement.latencies.push_back(std::chrono::duration<double, std::micro>(now - client.sentTimes.front()).count());
+		client.sentTimes.pop_front();
+
+		//replies come back in the order the requests were sent
+		if (reply.status != CipherStatus::OK || reply.tag != client.expectedTag || reply.text.length() != options.length)
+		{
+			measurement.errors++;
+		}
+
+		client.expectedTag++;
+	}
+
+	client.input.erase(0, used);
+
+	return true;
+}
+
+/*
+Purpose:		Writes as much of the waiting requests as the socket takes.
+Pre-condition:	Takes the connection and the measurement to add to.
+Post-condition:	Returns false if the connection failed, after counting its requests in flight as errors.
+*/
+static bool writeRequests(Client& client, Measurement& measurement)
+{
+	size_t sent = 0;
+
+	while (sent < client.output.length())
+	{
+		ssize_t wrote = send(client.socket, client.output.data() + sent, client.output.length() - sent, MSG_NOSIGNAL);
+
+		if (wrote > 0)
+		{
+			sent += (size_t)wrote;
+		}
+		else if (wrote < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		else if (wrote == 0 || errno != EINTR)
+		{
+			measurement.errors += client.sentTimes.size() + client.remaining;
+			return false;
+		}
+	}
+
+	client.output.erase(0, sent);
+
+	return true;
+}
+
+/*
+Purpose:		Sends the requests of some connections and reads their replies until every one is answered.
+Pre-condition:	Takes the connections, the options, the texts to send and the measurement to fill.
+Post-condition:	Every connection is done, and its socket closed.
+*/
+static void runClients(std::vector<Client*> clients, const Options& options, const std::vector<std::string>& texts,
+	Measurement& measurement)
+{
+	std::vector<pollfd> polls(clients.size());
+
+	while (true)
+	{
+		size_t active = 0;
+
+		for (size_t i = 0; i < clients.size(); i++)
+		{
+			Client& client = *clients[i];
+
+			//the window is topped up before waiting, so the requests of one connection go out together
+			Clock::time_point now = Clock::now();
+			while (!client.done && client.remaining > 0 && client.sentTimes.size() < options.window)
+			{
+				const std::string& text = texts[client.nextTag % texts.size()];
+				CipherServer::appendRequest(client.output, options.operation, (uint32_t)options.keyId, client.nextTag, text);
+				client.sentTimes.push_back(now);
+				client.nextTag++;
+				client.remaining--;
+			}
+
+			if (!client.done && client.remaining == 0 && client.sentTimes.empty())
+			{
+				client.done = true;
+				close(client.socket);
+			}
+
+			polls[i].fd = client.done ? -1 : client.socket;
+			polls[i].events = (short)(POLLIN | (client.output.empty() ? 0 : POLLOUT));
+			polls[i].revents = 0;
+			active += client.done ? 0 : 1;
+		}
+
+		if (active == 0)
+		{
+			return;
+		}
+
+		if (poll(polls.data(), polls.size(), -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			std::cerr << "Error: could not wait on the connections: " << std::strerror(errno) << "\n";
+			for (Client* client : clients)
+			{
+				if (!client->done)
+				{
+					measurement.errors += client->sentTimes.size() + client->remaining;
+					client->done = true;
+					close(client->socket);
+				}
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < clients.size(); i++)
+		{
+			Client& client = *clients[i];
+			bool open = true;
+
+			if (polls[i].fd < 0)
+			{
+				continue;
+			}
+
+			if ((polls[i].revents & POLLOUT) != 0)
+			{
+				open = writeRequests(client, measurement);
+			}
+
+			if (open && (polls[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+			{
+				open = readReplies(client, options, measurement);
+			}
+
+			if (!open)
+			{
+				client.done = true;
+				close(client.socket);
+			}
+		}
+	}
+}
+
+/*
+Purpose:		Gives the value a share of the sorted values are at or below.
+Pre-condition:	Takes the sorted values, which may not be empty, and the percentile.
+Post-condition:	Returns the value at the percentile.
+*/
+static double findPercentile(const std::vector<double>& sorted, double percentile)
+{
+	size_t rank = (size_t)(percentile / 100 * sorted.size());
+	return sorted[(rank < sorted.size()) ? rank : sorted.size() - 1];
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseArguments(argc, argv, options))
+	{
+		printUsage(std::cerr);
+		return EXIT_USAGE_ERROR;
+	}
+
+	//random letters are valid text for either operation
+	std::mt19937 random(TEXT_SEED);
+	std::uniform_int_distribution<int> letter('a', 'z');
+	std::vector<std::string> texts(MESSAGE_COUNT);
+	for (std::string& text : texts)
+	{
+		text.resize(options.length);
+		for (char& character : text)
+		{
+			character = (char)letter(random);
+		}
+	}
+
+	std::vector<Client> clients(options.connections);
+	for (size_t i = 0; i < clients.size(); i++)
+	{
+		clients[i].socket = connectService(options);
+		if (clients[i].socket < 0)
+		{
+			for (size_t j = 0; j < i; j++)
+			{
+				close(clients[j].socket);
+			}
+			return EXIT_SERVICE_ERROR;
+		}
+
+		//the requests are shared as evenly as they divide
+		clients[i].remaining = (options.requests * (i + 1)) / clients.size() - (options.requests * i) / clients.size();
+	}
+
+	size_t threads = (options.threads < clients.size()) ? options.threads : clients.size();
+	std::vector<Measurement> measurements(threads);
+	std::vector<std::thread> workers;
+
+	Clock::time_point start = Clock::now();
+
+	for (size_t t = 0; t < threads; t++)
+	{
+		std::vector<Client*> share;
+		for (size_t i = t; i < clients.size(); i += threads)
+		{
+			share.push_back(&clients[i]);
+		}
+
+		workers.emplace_back(runClients, share, std::cref(options), std::cref(texts), std::ref(measurements[t]));
+	}
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::vector<double> latencies;
+	size_t errors = 0;
+	for (Measurement& measurement : measurements)
+	{
+		latencies.insert(latencies.end(), measurement.latencies.begin(), measurement.latencies.end());
+		errors += measurement.errors;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	std::cout << "requests " << options.requests << " answered " << latencies.size() << " errors " << errors;
+	std::cout << " seconds " << seconds << "\n";
+	std::cout << "throughput " << latencies.size() / seconds << " requests/s ";
+	std::cout << latencies.size() * options.length / seconds / 1e6 << " MB/s\n";
+
+	if (!latencies.empty())
+	{
+		std::cout << "latency p50 " << findPercentile(latencies, 50) << " us p99 " << findPercentile(latencies, 99);
+		std::cout << " us max " << latencies.back() << " us\n";
+	}
+
+	return (errors == 0) ? 0 : EXIT_SERVICE_ERROR;
+}
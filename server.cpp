@@ -0,0 +1,229 @@
+/*
+Author:			My Tran
+Filename:		server.cpp
+Description:	This file is a command line tool that runs the cipher as a long lived local service using the CipherServer
+class, answering encrypt and decrypt requests for keys of a key store file until it is interrupted. The protocol is
+described in CipherServer.h, and loadgen.cpp builds a client that measures the service.
+
+Usage:	server -t keyStore (-s socketPath | -p port) [-j threads] [-c capacity]
+
+	-t, --key-store		key store file of the keys requests may name, as read by KeyStore
+	-s, --socket		path of the Unix domain socket to listen on
+	-p, --port			TCP port of the loopback address to listen on
+	-j, --threads		number of worker threads, one per hardware thread unless given
+	-c, --cache			most key schedules kept ready (256 unless given)
+
+The service stops on SIGINT or SIGTERM and writes the number of requests answered and batches run to standard error.
+Exit status is 0 once stopped, 1 if the service could not listen or wait on its sockets and 2 on bad usage or a key
+store that could not be loaded.
+*/
+#include "CipherEngine.h"
+#include "CipherServer.h"
+#include "KeyStore.h"
+#include<cerrno>
+#include<csignal>
+#include<cstring>
+#include<iostream>
+#include<sstream>
+#include<string>
+
+const int EXIT_SERVICE_ERROR = 1;	//exit status when the service could not listen or run
+const int EXIT_USAGE_ERROR = 2;	//exit status when the command line or key store is wrong
+
+//everything given on the command line
+struct Options
+{
+	std::string keyStorePath;	//key store file to load
+	std::string socketPath;	//Unix domain socket to listen on, empty for TCP
+	size_t port = 0;	//TCP port to listen on, 0 for a Unix domain socket
+	size_t threads = 0;	//worker threads, 0 for one per hardware thread
+	size_t capacity = KeyStore::DEFAULT_CACHE_CAPACITY;	//schedules kept in the cache
+};
+
+CipherServer* runningServer = nullptr;	//service the signal handler stops
+
+/*
+Purpose:		Stops the service when the process is interrupted.
+Pre-condition:	Takes the signal.
+Post-condition:	The service returns from run.
+*/
+static void handleSignal(int)
+{
+	if (runningServer != nullptr)
+	{
+		runningServer->stop();
+	}
+}
+
+/*
+Purpose:		Prints how to use the tool.
+Pre-condition:	Takes the stream to print to.
+Post-condition:	Usage is printed.
+*/
+static void printUsage(std::ostream& output)
+{
+	output << "Usage: server -t keyStore (-s socketPath | -p port) [-j threads] [-c capacity]\n";
+}
+
+/*
+Purpose:		Reads a positive whole number given as the value of a flag.
+Pre-condition:	Takes the flag, its value and where to store the number.
+Post-condition:	Returns true if the value is a positive integer. False otherwise, after printing why.
+*/
+static bool parseCount(const std::string& flag, const std::string& value, size_t& count)
+{
+	std::istringstream number(value);
+	if (!(number >> count) || !number.eof() || count == 0 || value[0] == '-')
+	{
+		std::cerr << "Error: " << flag << " must be a positive integer\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*
+Purpose:		Reads the command line into the options.
+Pre-condition:	Takes the arguments of main and the options to fill.
+Post-condition:	Returns true if the command line is usable. False otherwise, after printing why.
+*/
+static bool parseArguments(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+
+		//every flag takes a value
+		const char* const valueFlags[] = { "-t", "--key-store", "-s", "--socket", "-p", "--port", "-j", "--threads", "-c",
+			"--cache" };
+		bool known = false;
+		for (const char* valueFlag : valueFlags)
+		{
+			known = known || (flag == valueFlag);
+		}
+
+		if (!known)
+		{
+			std::cerr << "Error: unknown option " << flag << "\n";
+			return false;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Error: " << flag << " needs a value\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+		bool parsed = true;
+
+		if (flag == "-t" || flag == "--key-store")
+		{
+			options.keyStorePath = value;
+		}
+		else if (flag == "-s" || flag == "--socket")
+		{
+			options.socketPath = value;
+		}
+		else if (flag == "-p" || flag == "--port")
+		{
+			parsed = parseCount(flag, value, options.port);
+			if (parsed && options.port > 65535)
+			{
+				std::cerr << "Error: " << flag << " must be at most 65535\n";
+				parsed = false;
+			}
+		}
+		else if (flag == "-j" || flag == "--threads")
+		{
+			parsed = parseCount(flag, value, options.threads);
+		}
+		else
+		{
+			parsed = parseCount(flag, value, options.capacity);
+		}
+
+		if (!parsed)
+		{
+			return false;
+		}
+	}
+
+	if (options.keyStorePath.empty())
+	{
+		std::cerr << "Error: a key store must be given with -t\n";
+		return false;
+	}
+
+	if (options.socketPath.empty() == (options.port == 0))
+	{
+		std::cerr << "Error: exactly one of -s and -p must be given\n";
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseArguments(argc, argv, options))
+	{
+		printUsage(std::cerr);
+		return EXIT_USAGE_ERROR;
+	}
+
+	KeyStore keys(options.capacity);
+	CipherStatus status = keys.load(options.keyStorePath);
+	if (status != CipherStatus::OK)
+	{
+		std::cerr << "Error: " << options.keyStorePath;
+		if (keys.getErrorLine() > 0)
+		{
+			std::cerr << " line " << keys.getErrorLine();
+		}
+		std::cerr << ": " << CipherEngine::describeStatus(status) << "\n";
+		return EXIT_USAGE_ERROR;
+	}
+
+	CipherServer server(keys, options.threads);
+	bool listening = options.socketPath.empty() ? server.listenTcp((uint16_t)options.port) : server.listenLocal(options.socketPath);
+
+	if (!listening)
+	{
+		std::cerr << "Error: could not listen: " << std::strerror(errno) << "\n";
+		return EXIT_SERVICE_ERROR;
+	}
+
+	runningServer = &server;
+	std::signal(SIGINT, handleSignal);
+	std::signal(SIGTERM, handleSignal);
+
+	std::cerr << "Serving " << keys.getKeyCount() << " keys on ";
+	if (options.socketPath.empty())
+	{
+		std::cerr << "127.0.0.1:" << options.port << "\n";
+	}
+	else
+	{
+		std::cerr << options.socketPath << "\n";
+	}
+
+	bool stopped = server.run();
+	int error = errno;
+	runningServer = nullptr;
+
+	size_t requests = server.getRequestCount();
+	size_t batches = server.getBatchCount();
+	std::cerr << "Answered " << requests << " requests in " << batches << " batches";
+	std::cerr << " (" << ((batches > 0) ? (double)requests / batches : 0) << " requests per batch)\n";
+
+	if (!stopped)
+	{
+		std::cerr << "Error: could not wait on the sockets: " << std::strerror(error) << "\n";
+		return EXIT_SERVICE_ERROR;
+	}
+
+	return 0;
+}
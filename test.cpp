@@ -1,15 +1,15 @@
-/*
-Author:			My Tran
-Filename:		test.cpp
-Description:	This file is a testing program for the Encryptor class' functionality
-*/
-#include "Encryptor.h"
-
-int main()
-{
-	Encryptor firstMessage = Encryptor();
-	
-	firstMessage.start();
-
-	return 0;
+/*
+Author:			My Tran
+Filename:		test.cpp
+Description:	This file is a testing program for the Encryptor class' functionality
+*/
+#include "Encryptor.h"
+
+int main()
+{
+	Encryptor firstMessage = Encryptor();
+	
+	firstMessage.start();
+
+	return 0;
 }
\ No newline at end of file